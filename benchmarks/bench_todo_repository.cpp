@@ -0,0 +1,769 @@
+#include <benchmark/benchmark.h>
+#include "todolist/todo_repository.h"
+#include "todolist/database.h"
+#include "todolist/connection_pool.h"
+#include "todolist/async_writer.h"
+#include "todolist/todo_snapshot.h"
+#include "todolist/snapshot_file.h"
+#include "todolist/exporter.h"
+#include "todolist/buffered_writer.h"
+#include "todolist/formatter.h"
+#include "todolist/json_escape.h"
+#include "todolist/json_formatter.h"
+#include "todolist/timestamp_formatter.h"
+#include "todolist/importer.h"
+#include "todolist/substring_matcher.h"
+#include <sqlite3.h>
+#include <algorithm>
+#include <ctime>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <filesystem>
+#include <fstream>
+
+using namespace todolist;
+
+namespace {
+
+constexpr int kSeedRows = 10000;
+
+/**
+ * @brief Open an in-memory database seeded with kSeedRows todo items
+ */
+std::unique_ptr<Database> makeSeededDatabase() {
+    auto db = std::make_unique<Database>(":memory:");
+    TodoRepository repo(*db);
+    db->execute("BEGIN");
+    for (int i = 0; i < kSeedRows; ++i) {
+        repo.create(TodoItem("Task " + std::to_string(i), "Description " + std::to_string(i)));
+    }
+    db->execute("COMMIT");
+    return db;
+}
+
+} // anonymous namespace
+
+// Baseline: compile and finalize the statement on every lookup (pre-cache behavior)
+static void BM_FindById_Uncached(benchmark::State& state) {
+    auto db = makeSeededDatabase();
+    const char* sql = "SELECT id, title, description, completed, created_at FROM todos WHERE id = ?";
+    int id = 1;
+
+    for (auto _ : state) {
+        sqlite3_stmt* stmt = nullptr;
+        sqlite3_prepare_v2(db->getHandle(), sql, -1, &stmt, nullptr);
+        sqlite3_bind_int(stmt, 1, id);
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            std::string title = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+            benchmark::DoNotOptimize(title);
+        }
+        sqlite3_finalize(stmt);
+        id = id % kSeedRows + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FindById_Uncached);
+
+static void BM_FindById_Cached(benchmark::State& state) {
+    auto db = makeSeededDatabase();
+    TodoRepository repo(*db);
+    int id = 1;
+
+    for (auto _ : state) {
+        auto item = repo.findById(id);
+        benchmark::DoNotOptimize(item);
+        id = id % kSeedRows + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FindById_Cached);
+
+// Hot working set of 100 ids served from the item cache
+static void BM_FindById_LruCache(benchmark::State& state) {
+    auto db = makeSeededDatabase();
+    TodoRepository repo(*db, 256);
+    int id = 1;
+
+    for (auto _ : state) {
+        auto item = repo.findById(id);
+        benchmark::DoNotOptimize(item);
+        id = id % 100 + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["hit_rate"] = static_cast<double>(repo.cacheStats().hits) /
+        static_cast<double>(repo.cacheStats().hits + repo.cacheStats().misses);
+}
+BENCHMARK(BM_FindById_LruCache);
+
+// Baseline: compile and finalize the insert on every call (pre-cache behavior)
+static void BM_Create_Uncached(benchmark::State& state) {
+    Database db(":memory:");
+    const char* sql = "INSERT INTO todos (title, description, completed, created_at) VALUES (?, ?, ?, ?)";
+    TodoItem item("Benchmark task", "Benchmark description");
+
+    for (auto _ : state) {
+        sqlite3_stmt* stmt = nullptr;
+        sqlite3_prepare_v2(db.getHandle(), sql, -1, &stmt, nullptr);
+        sqlite3_bind_text(stmt, 1, item.getTitle().c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, item.getDescription().c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(stmt, 3, 0);
+        sqlite3_bind_int64(stmt, 4, static_cast<sqlite3_int64>(item.getCreatedAtUnix()));
+        sqlite3_step(stmt);
+        sqlite3_finalize(stmt);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Create_Uncached);
+
+static void BM_Create_Cached(benchmark::State& state) {
+    Database db(":memory:");
+    TodoRepository repo(db);
+    TodoItem item("Benchmark task", "Benchmark description");
+
+    for (auto _ : state) {
+        auto created = repo.create(item);
+        benchmark::DoNotOptimize(created);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Create_Cached);
+
+static void BM_CreateBatch(benchmark::State& state) {
+    Database db(":memory:");
+    TodoRepository repo(db);
+    std::vector<TodoItem> items(static_cast<size_t>(state.range(0)),
+                                TodoItem("Benchmark task", "Benchmark description"));
+
+    for (auto _ : state) {
+        auto ids = repo.createBatch(items);
+        benchmark::DoNotOptimize(ids);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CreateBatch)->Arg(1000);
+
+namespace {
+
+constexpr int kSearchRows = 100000;
+
+/**
+ * @brief Open an in-memory database where one row in a thousand matches "rocer"
+ */
+std::unique_ptr<Database> makeSearchDatabase() {
+    auto db = std::make_unique<Database>(":memory:");
+    TodoRepository repo(*db);
+    std::vector<TodoItem> items;
+    items.reserve(kSearchRows);
+    for (int i = 0; i < kSearchRows; ++i) {
+        items.emplace_back(i % 1000 == 0 ? "Buy groceries " + std::to_string(i)
+                                         : "Task number " + std::to_string(i), "");
+    }
+    repo.createBatch(items);
+    return db;
+}
+
+} // anonymous namespace
+
+// Baseline: LIKE '%q%' over the whole table
+static void BM_SubstringSearch_Scan(benchmark::State& state) {
+    auto db = makeSearchDatabase();
+    const char* sql = "SELECT id, title FROM todos WHERE title LIKE '%rocer%' ORDER BY created_at DESC, id DESC";
+
+    for (auto _ : state) {
+        Statement stmt = db->prepare(sql);
+        int rows = 0;
+        while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+            ++rows;
+        }
+        benchmark::DoNotOptimize(rows);
+    }
+}
+BENCHMARK(BM_SubstringSearch_Scan);
+
+static void BM_SubstringSearch_Trigram(benchmark::State& state) {
+    auto db = makeSearchDatabase();
+    TodoRepository repo(*db);
+
+    for (auto _ : state) {
+        auto items = repo.findByTitle("rocer");
+        benchmark::DoNotOptimize(items);
+    }
+}
+BENCHMARK(BM_SubstringSearch_Trigram);
+
+// findByTitle with a query too short for the trigram index takes the
+// LIKE scan path
+static void BM_SubstringSearch_FindByTitleLike(benchmark::State& state) {
+    auto db = makeSearchDatabase();
+    TodoRepository repo(*db);
+
+    for (auto _ : state) {
+        auto items = repo.findByTitle("oc");
+        benchmark::DoNotOptimize(items);
+    }
+}
+BENCHMARK(BM_SubstringSearch_FindByTitleLike);
+
+// Vectorized scan of an in-memory title arena (snapshot loaded once);
+// level 0 = scalar, 1 = SSE2, 2 = AVX2
+static void BM_SubstringSearch_Simd(benchmark::State& state) {
+    auto db = makeSearchDatabase();
+    TodoSnapshot snapshot(*db);
+    SimdLevel level = static_cast<SimdLevel>(state.range(0));
+    if (SubstringMatcher("", level).level() != level) {
+        state.SkipWithError("instruction set not supported by this CPU");
+        return;
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(snapshot.filterByTitle("oc", TodoFilter::ALL, level));
+    }
+    state.SetItemsProcessed(state.iterations() * kSearchRows);
+}
+BENCHMARK(BM_SubstringSearch_Simd)->ArgName("level")->Arg(0)->Arg(1)->Arg(2);
+
+// Baseline: one aggregate pass over the table
+static void BM_Stats_Aggregate(benchmark::State& state) {
+    auto db = makeSearchDatabase();
+    const char* sql = "SELECT COUNT(*), SUM(completed = 1) FROM todos";
+
+    for (auto _ : state) {
+        Statement stmt = db->prepare(sql);
+        sqlite3_step(stmt.get());
+        benchmark::DoNotOptimize(sqlite3_column_int(stmt.get(), 0));
+    }
+}
+BENCHMARK(BM_Stats_Aggregate);
+
+static void BM_Stats_Summary(benchmark::State& state) {
+    auto db = makeSearchDatabase();
+    TodoRepository repo(*db);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(repo.stats());
+    }
+}
+BENCHMARK(BM_Stats_Summary);
+
+// Baseline: load every item as a TodoItem, then count pending ones
+static void BM_CountPending_FindAll(benchmark::State& state) {
+    auto db = makeSearchDatabase();
+    TodoRepository repo(*db);
+    std::vector<TodoItem> items = repo.findAll();
+
+    for (auto _ : state) {
+        size_t pending = 0;
+        for (const auto& item : items) {
+            pending += !item.isCompleted();
+        }
+        benchmark::DoNotOptimize(pending);
+    }
+    state.SetItemsProcessed(state.iterations() * kSearchRows);
+}
+BENCHMARK(BM_CountPending_FindAll);
+
+static void BM_CountPending_Snapshot(benchmark::State& state) {
+    auto db = makeSearchDatabase();
+    TodoSnapshot snapshot(*db);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(snapshot.count(TodoFilter::PENDING));
+    }
+    state.SetItemsProcessed(state.iterations() * kSearchRows);
+}
+BENCHMARK(BM_CountPending_Snapshot);
+
+static void BM_Load_FindAll(benchmark::State& state) {
+    auto db = makeSearchDatabase();
+    TodoRepository repo(*db);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(repo.findAll());
+    }
+    state.SetItemsProcessed(state.iterations() * kSearchRows);
+}
+BENCHMARK(BM_Load_FindAll)->Unit(benchmark::kMillisecond);
+
+static void BM_Load_Snapshot(benchmark::State& state) {
+    auto db = makeSearchDatabase();
+
+    for (auto _ : state) {
+        TodoSnapshot snapshot(*db);
+        benchmark::DoNotOptimize(snapshot.size());
+    }
+    state.SetItemsProcessed(state.iterations() * kSearchRows);
+}
+BENCHMARK(BM_Load_Snapshot)->Unit(benchmark::kMillisecond);
+
+// Stream every row through a visitor: owned copies versus row views
+static void BM_Stream_ForEach(benchmark::State& state) {
+    auto db = makeSearchDatabase();
+    TodoRepository repo(*db);
+
+    for (auto _ : state) {
+        size_t bytes = 0;
+        repo.forEach(TodoFilter::ALL, [&bytes](const TodoItem& item) {
+            bytes += item.getTitle().size() + item.getDescription().size();
+        });
+        benchmark::DoNotOptimize(bytes);
+    }
+    state.SetItemsProcessed(state.iterations() * kSearchRows);
+}
+BENCHMARK(BM_Stream_ForEach)->Unit(benchmark::kMillisecond);
+
+static void BM_Stream_ForEachView(benchmark::State& state) {
+    auto db = makeSearchDatabase();
+    TodoRepository repo(*db);
+
+    for (auto _ : state) {
+        size_t bytes = 0;
+        repo.forEachView(TodoFilter::ALL, [&bytes](const TodoItemView& item) {
+            bytes += item.getTitle().size() + item.getDescription().size();
+        });
+        benchmark::DoNotOptimize(bytes);
+    }
+    state.SetItemsProcessed(state.iterations() * kSearchRows);
+}
+BENCHMARK(BM_Stream_ForEachView)->Unit(benchmark::kMillisecond);
+
+// Map and validate the snapshot file, then walk every row
+static void BM_Stream_SnapshotFile(benchmark::State& state) {
+    auto db = makeSearchDatabase();
+    std::string path = (std::filesystem::temp_directory_path() / "todolist_bench.snapshot").string();
+    SnapshotFile::write(path, *db, DatabaseStamp());
+
+    for (auto _ : state) {
+        auto snapshot = SnapshotFile::open(path);
+        size_t bytes = 0;
+        for (size_t i = 0; i < snapshot->size(); ++i) {
+            TodoItemView item = snapshot->view(i);
+            bytes += item.getTitle().size() + item.getDescription().size();
+        }
+        benchmark::DoNotOptimize(bytes);
+    }
+    state.SetItemsProcessed(state.iterations() * kSearchRows);
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_Stream_SnapshotFile)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Stream buffer that discards its input, for measuring output paths
+ */
+class NullBuffer : public std::streambuf {
+protected:
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+    int overflow(int c) override { return c; }
+};
+
+// Serialize every row; arg 0 is JSON Lines, 1 is CSV
+static void BM_Export(benchmark::State& state) {
+    auto db = makeSearchDatabase();
+    Exporter exporter(*db, state.range(0) == 0 ? ExportFormat::JSONL : ExportFormat::CSV);
+    NullBuffer buffer;
+    std::ostream out(&buffer);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(exporter.exportTo(out));
+    }
+    state.SetItemsProcessed(state.iterations() * kSearchRows);
+}
+BENCHMARK(BM_Export)->ArgName("format")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+// Format every row as one string, then write it
+static void BM_Format_String(benchmark::State& state) {
+    auto db = makeSearchDatabase();
+    auto items = TodoRepository(*db).findAll();
+    Formatter formatter(true);
+    NullBuffer buffer;
+    std::ostream out(&buffer);
+
+    for (auto _ : state) {
+        out << formatter.formatTodoList(items);
+    }
+    state.SetItemsProcessed(state.iterations() * kSearchRows);
+}
+BENCHMARK(BM_Format_String)->Unit(benchmark::kMillisecond);
+
+// Format every row into a bounded buffer flushed in chunks
+static void BM_Format_Writer(benchmark::State& state) {
+    auto db = makeSearchDatabase();
+    auto items = TodoRepository(*db).findAll();
+    Formatter formatter(true);
+    NullBuffer buffer;
+    std::ostream out(&buffer);
+
+    for (auto _ : state) {
+        BufferedWriter writer(out, 32 * 1024);
+        formatter.appendTodoList(writer, items);
+        writer.flush();
+    }
+    state.SetItemsProcessed(state.iterations() * kSearchRows);
+}
+BENCHMARK(BM_Format_Writer)->Unit(benchmark::kMillisecond);
+
+// Format every row as one JSON document, as list --output=json does
+static void BM_Format_Json(benchmark::State& state) {
+    auto db = makeSearchDatabase();
+    auto items = TodoRepository(*db).findAll();
+    JsonFormatter formatter;
+    NullBuffer buffer;
+    std::ostream out(&buffer);
+
+    for (auto _ : state) {
+        BufferedWriter writer(out, 32 * 1024);
+        formatter.beginList(writer, items.size(), 0, "");
+        formatter.appendListItems(writer, items);
+        formatter.endList(writer, "");
+        writer.flush();
+    }
+    state.SetItemsProcessed(state.iterations() * kSearchRows);
+}
+BENCHMARK(BM_Format_Json)->Unit(benchmark::kMillisecond);
+
+// Escape a 4 KiB description with one quote at the end;
+// level 0 = scalar, 1 = SSE2, 2 = AVX2
+static void BM_JsonEscape(benchmark::State& state) {
+    SimdLevel level = static_cast<SimdLevel>(state.range(0));
+    if (SubstringMatcher("", level).level() != level) {
+        state.SkipWithError("instruction set not supported by this CPU");
+        return;
+    }
+    std::string text(4095, 'x');
+    text += '"';
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(findJsonEscape(text.data(), text.size(), level));
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+}
+BENCHMARK(BM_JsonEscape)->ArgName("level")->Arg(0)->Arg(1)->Arg(2);
+
+namespace {
+
+/**
+ * @brief Creation times of a list sorted newest first, a few minutes apart
+ */
+std::vector<std::time_t> makeListTimes() {
+    std::vector<std::time_t> times(kSearchRows);
+    for (int i = 0; i < kSearchRows; ++i) {
+        times[i] = 1700000000 - static_cast<std::time_t>(i) * 317;
+    }
+    return times;
+}
+
+} // anonymous namespace
+
+// Render timestamps the way TodoItem did before TimestampFormatter
+static void BM_Timestamp_Strftime(benchmark::State& state) {
+    auto times = makeListTimes();
+    char buffer[64];
+
+    for (auto _ : state) {
+        for (std::time_t t : times) {
+            std::tm tm_time;
+            #ifdef _WIN32
+                localtime_s(&tm_time, &t);
+            #else
+                localtime_r(&t, &tm_time);
+            #endif
+            benchmark::DoNotOptimize(std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &tm_time));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * kSearchRows);
+}
+BENCHMARK(BM_Timestamp_Strftime)->Unit(benchmark::kMillisecond);
+
+static void BM_Timestamp_Batch(benchmark::State& state) {
+    auto times = makeListTimes();
+    std::vector<TimestampFormatter::Text> out(times.size());
+
+    for (auto _ : state) {
+        TimestampFormatter formatter;
+        formatter.formatBatch(times.data(), times.size(), out.data());
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kSearchRows);
+}
+BENCHMARK(BM_Timestamp_Batch)->Unit(benchmark::kMillisecond);
+
+// Load an exported file into an empty database; arg 0 is JSON Lines, 1 is CSV
+static void BM_Import(benchmark::State& state) {
+    ExportFormat format = state.range(0) == 0 ? ExportFormat::JSONL : ExportFormat::CSV;
+    std::string path = (std::filesystem::temp_directory_path() / "todolist_bench_import").string();
+    {
+        auto source = makeSearchDatabase();
+        std::ofstream out(path, std::ios::binary);
+        Exporter(*source, format).exportTo(out);
+    }
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto db = std::make_unique<Database>(":memory:");
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(Importer(*db, format).importFile(path));
+
+        state.PauseTiming();
+        db.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * kSearchRows);
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_Import)->ArgName("format")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+// Baseline: the same rows through createBatch, with the indexes and triggers in place
+static void BM_Import_CreateBatch(benchmark::State& state) {
+    std::vector<TodoItem> items;
+    {
+        auto source = makeSearchDatabase();
+        items = TodoRepository(*source).findAll();
+    }
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto db = std::make_unique<Database>(":memory:");
+        auto repo = std::make_unique<TodoRepository>(*db);
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(repo->createBatch(items));
+
+        state.PauseTiming();
+        repo.reset();
+        db.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * kSearchRows);
+}
+BENCHMARK(BM_Import_CreateBatch)->Unit(benchmark::kMillisecond);
+
+// In-memory filter and sort over all rows, newest first
+static void BM_FilterSort_FindAll(benchmark::State& state) {
+    auto db = makeSearchDatabase();
+    TodoRepository repo(*db);
+    std::vector<TodoItem> items = repo.findAll();
+
+    for (auto _ : state) {
+        std::vector<const TodoItem*> matches;
+        for (const auto& item : items) {
+            if (!item.isCompleted() && item.getCreatedAtUnix() >= 0) {
+                matches.push_back(&item);
+            }
+        }
+        std::sort(matches.begin(), matches.end(), [](const TodoItem* a, const TodoItem* b) {
+            if (a->getCreatedAt() != b->getCreatedAt()) {
+                return a->getCreatedAt() > b->getCreatedAt();
+            }
+            return a->getId() > b->getId();
+        });
+        benchmark::DoNotOptimize(matches.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kSearchRows);
+}
+BENCHMARK(BM_FilterSort_FindAll)->Unit(benchmark::kMillisecond);
+
+static void BM_FilterSort_Snapshot(benchmark::State& state) {
+    auto db = makeSearchDatabase();
+    TodoSnapshot snapshot(*db);
+
+    for (auto _ : state) {
+        TodoSnapshot::Rows rows = snapshot.filterCreatedBetween(0, std::numeric_limits<std::time_t>::max(),
+                                                                TodoFilter::PENDING);
+        snapshot.sortNewestFirst(rows);
+        benchmark::DoNotOptimize(rows.data());
+    }
+    state.SetItemsProcessed(state.iterations() * kSearchRows);
+}
+BENCHMARK(BM_FilterSort_Snapshot)->Unit(benchmark::kMillisecond);
+
+namespace {
+
+/**
+ * @brief Connection profiles compared by the file-backed benchmarks
+ *
+ * 0: SQLite defaults (rollback journal, synchronous=FULL, no mmap)
+ * 1: DatabaseOptions defaults (WAL, synchronous=NORMAL, mmap)
+ */
+DatabaseOptions profileOptions(int64_t profile) {
+    DatabaseOptions options;
+    if (profile == 0) {
+        options.journal_mode = "DELETE";
+        options.synchronous = "FULL";
+        options.mmap_size = 0;
+        options.cache_size = -2000;
+        options.temp_store = "DEFAULT";
+    }
+    return options;
+}
+
+std::string benchmarkDatabasePath() {
+    return (std::filesystem::temp_directory_path() / "todolist_bench_profile.db").string();
+}
+
+void removeDatabaseFiles(const std::string& path) {
+    for (const char* suffix : {"", "-wal", "-shm", "-journal"}) {
+        std::filesystem::remove(path + suffix);
+    }
+}
+
+} // anonymous namespace
+
+// One committed insert per iteration on a file-backed database
+static void BM_Create_Profile(benchmark::State& state) {
+    std::string path = benchmarkDatabasePath();
+    removeDatabaseFiles(path);
+    {
+        Database db(path, profileOptions(state.range(0)));
+        TodoRepository repo(db);
+        TodoItem item("Benchmark task", "Benchmark description");
+
+        for (auto _ : state) {
+            auto created = repo.create(item);
+            benchmark::DoNotOptimize(created);
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+    removeDatabaseFiles(path);
+}
+BENCHMARK(BM_Create_Profile)->ArgName("profile")->Arg(0)->Arg(1)->UseRealTime();
+
+static void BM_FindById_Profile(benchmark::State& state) {
+    std::string path = benchmarkDatabasePath();
+    removeDatabaseFiles(path);
+    {
+        Database db(path, profileOptions(state.range(0)));
+        TodoRepository repo(db);
+        std::vector<TodoItem> items(kSeedRows, TodoItem("Benchmark task", "Benchmark description"));
+        repo.createBatch(items);
+        int id = 1;
+
+        for (auto _ : state) {
+            auto item = repo.findById(id);
+            benchmark::DoNotOptimize(item);
+            id = id % kSeedRows + 1;
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+    removeDatabaseFiles(path);
+}
+BENCHMARK(BM_FindById_Profile)->ArgName("profile")->Arg(0)->Arg(1);
+
+namespace {
+
+constexpr int kPoolRows = 1000;
+constexpr size_t kPoolReaders = 16;
+
+std::unique_ptr<ConnectionPool> g_pool;
+
+void setUpPool(const benchmark::State&) {
+    std::string path = benchmarkDatabasePath();
+    removeDatabaseFiles(path);
+    g_pool = std::make_unique<ConnectionPool>(path, kPoolReaders);
+    auto writer = g_pool->acquireWriter();
+    std::vector<TodoItem> items(kPoolRows, TodoItem("Benchmark task", "Benchmark description"));
+    writer.repository().createBatch(items);
+}
+
+void tearDownPool(const benchmark::State&) {
+    g_pool.reset();
+    removeDatabaseFiles(benchmarkDatabasePath());
+}
+
+} // anonymous namespace
+
+// Each benchmark thread holds its own reader lease for the whole run
+static void BM_Pool_FindById(benchmark::State& state) {
+    auto reader = g_pool->acquireReader();
+    int id = 1 + state.thread_index();
+
+    for (auto _ : state) {
+        auto item = reader.repository().findById(id);
+        benchmark::DoNotOptimize(item);
+        id = id % kPoolRows + 1;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Pool_FindById)->Setup(setUpPool)->Teardown(tearDownPool)
+    ->ThreadRange(1, 16)->UseRealTime();
+
+static void BM_Pool_FindAll(benchmark::State& state) {
+    auto reader = g_pool->acquireReader();
+
+    for (auto _ : state) {
+        auto items = reader.repository().findAll();
+        benchmark::DoNotOptimize(items);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Pool_FindAll)->Setup(setUpPool)->Teardown(tearDownPool)
+    ->ThreadRange(1, 16)->UseRealTime();
+
+// Creates submitted through the group-commit writer, waiting for every
+// acknowledgement; compare with BM_Create_Profile/profile:1
+static void BM_Create_AsyncWriter(benchmark::State& state) {
+    std::string path = benchmarkDatabasePath();
+    removeDatabaseFiles(path);
+    {
+        Database db(path);
+        AsyncWriter writer(db);
+        TodoItem item("Benchmark task", "Benchmark description");
+        std::vector<std::future<TodoItem>> pending;
+        pending.reserve(static_cast<size_t>(state.range(0)));
+
+        for (auto _ : state) {
+            for (int64_t i = 0; i < state.range(0); ++i) {
+                pending.push_back(writer.create(item));
+            }
+            for (auto& created : pending) {
+                benchmark::DoNotOptimize(created.get());
+            }
+            pending.clear();
+        }
+        state.SetItemsProcessed(state.iterations() * state.range(0));
+        state.counters["batches"] = static_cast<double>(writer.committedBatches());
+    }
+    removeDatabaseFiles(path);
+}
+BENCHMARK(BM_Create_AsyncWriter)->Arg(1000)->UseRealTime();
+
+// Individual create() calls grouped by a Transaction, 100 per commit;
+// compare with BM_Create_Profile/profile:1
+static void BM_Create_Transaction(benchmark::State& state) {
+    std::string path = benchmarkDatabasePath();
+    removeDatabaseFiles(path);
+    {
+        Database db(path);
+        TodoRepository repo(db);
+        TodoItem item("Benchmark task", "Benchmark description");
+
+        for (auto _ : state) {
+            Transaction transaction(db, TransactionMode::IMMEDIATE);
+            for (int i = 0; i < 100; ++i) {
+                benchmark::DoNotOptimize(repo.create(item));
+            }
+            transaction.commit();
+        }
+        state.SetItemsProcessed(state.iterations() * 100);
+    }
+    removeDatabaseFiles(path);
+}
+BENCHMARK(BM_Create_Transaction)->UseRealTime();
+
+// Opening a database whose schema is current: connection setup plus one
+// user_version read
+static void BM_Open_CurrentSchema(benchmark::State& state) {
+    std::string path = benchmarkDatabasePath();
+    removeDatabaseFiles(path);
+    {
+        Database db(path);
+    }
+
+    for (auto _ : state) {
+        Database db(path);
+        benchmark::DoNotOptimize(db.isOpen());
+    }
+    removeDatabaseFiles(path);
+}
+BENCHMARK(BM_Open_CurrentSchema);
@@ -0,0 +1,166 @@
+/**
+ * @file async_writer.h
+ * @brief Asynchronous write front-end with group commit
+ *
+ * Lets many threads submit creates, updates and deletes without waiting
+ * for a commit each; a single writer thread applies them in batched
+ * transactions and resolves each caller's future once its batch is
+ * committed.
+ */
+
+#ifndef TODOLIST_ASYNC_WRITER_H
+#define TODOLIST_ASYNC_WRITER_H
+
+#include "todolist/database.h"
+#include "todolist/mpsc_queue.h"
+#include "todolist/todo_item.h"
+#include "todolist/todo_repository.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace todolist {
+
+/**
+ * @brief Batching limits for AsyncWriter
+ */
+struct AsyncWriterOptions {
+    size_t max_batch_size = 1000;                        ///< Most writes committed in one transaction
+    std::chrono::microseconds max_delay{2000};           ///< Longest a write waits for others to join its batch
+};
+
+/**
+ * @brief Group-commit writer running on its own thread
+ *
+ * Writes are pushed onto a lock-free MPSC queue and return immediately
+ * with a std::future. The writer thread takes the first queued write,
+ * keeps collecting until max_batch_size writes are gathered or
+ * max_delay has passed, and applies them all in one IMMEDIATE
+ * transaction.
+ *
+ * A future is fulfilled only after the transaction holding its write has
+ * committed, so an acknowledged write is exactly as durable as a
+ * synchronous TodoRepository call under the connection's synchronous
+ * setting. If a single write fails (e.g. a constraint violation) only its
+ * future receives the exception. If the transaction itself fails, every
+ * future in the batch receives it and none of the batch is kept.
+ *
+ * The Database belongs to the writer thread for the lifetime of the
+ * AsyncWriter and must not be used elsewhere meanwhile. The destructor
+ * commits everything already queued before returning.
+ *
+ * Example usage:
+ * @code
+ *   AsyncWriter writer(database);
+ *   std::future<TodoItem> created = writer.create(TodoItem("Buy milk", ""));
+ *   int id = created.get().getId();  // waits for the batch to commit
+ * @endcode
+ */
+class AsyncWriter {
+public:
+    /**
+     * @brief Start the writer thread
+     * @param database Connection used exclusively by the writer thread
+     * @param options Batching limits
+     */
+    explicit AsyncWriter(Database& database, const AsyncWriterOptions& options = AsyncWriterOptions());
+
+    /**
+     * @brief Commit all queued writes and stop the writer thread
+     */
+    ~AsyncWriter();
+
+    AsyncWriter(const AsyncWriter&) = delete;
+    AsyncWriter& operator=(const AsyncWriter&) = delete;
+
+    /**
+     * @brief Queue the creation of a todo item
+     * @param item Item to create (its id is ignored)
+     * @return Future for the created item with its database-assigned id
+     */
+    std::future<TodoItem> create(TodoItem item);
+
+    /**
+     * @brief Queue an update of a todo item
+     * @param item Item to update (must have a valid id)
+     * @return Future that is true if the item existed and was updated
+     */
+    std::future<bool> update(TodoItem item);
+
+    /**
+     * @brief Queue the deletion of a todo item
+     * @param id Id of the item to delete
+     * @return Future that is true if the item existed and was deleted
+     */
+    std::future<bool> remove(int id);
+
+    /**
+     * @brief Get the number of transactions committed so far
+     * @return Committed batch count
+     */
+    std::uint64_t committedBatches() const { return committed_batches_.load(); }
+
+private:
+    /**
+     * @brief One queued write and the promise reporting its outcome
+     */
+    struct WriteRequest {
+        enum class Kind { CREATE, UPDATE, REMOVE };
+
+        Kind kind;
+        TodoItem item;
+        int id = 0;
+        std::promise<TodoItem> created;  ///< Fulfilled for CREATE
+        std::promise<bool> changed;      ///< Fulfilled for UPDATE and REMOVE
+
+        // Outcome staged until the batch commits
+        TodoItem created_item;
+        bool changed_result = false;
+        std::exception_ptr error;
+    };
+
+    /**
+     * @brief Queue a request and wake the writer thread if it is asleep
+     * @param request Request to queue
+     */
+    void enqueue(WriteRequest request);
+
+    /**
+     * @brief Body of the writer thread
+     */
+    void run();
+
+    /**
+     * @brief Sleep until a request is queued, the writer is stopping, or the deadline passes
+     * @param deadline Time to give up waiting, or nullptr to wait indefinitely
+     */
+    void waitForRequests(const std::chrono::steady_clock::time_point* deadline);
+
+    /**
+     * @brief Apply a batch in one transaction and resolve its futures
+     * @param batch Requests to apply
+     */
+    void commitBatch(std::vector<WriteRequest>& batch);
+
+    Database& database_;
+    TodoRepository repository_;
+    AsyncWriterOptions options_;
+
+    MpscQueue<WriteRequest> queue_;
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    std::atomic<bool> sleeping_{false};
+    std::atomic<bool> stopping_{false};
+    std::atomic<std::uint64_t> committed_batches_{0};
+
+    std::thread thread_;  ///< Started last, after every member it uses
+};
+
+} // namespace todolist
+
+#endif // TODOLIST_ASYNC_WRITER_H
@@ -0,0 +1,107 @@
+/**
+ * @file buffered_writer.h
+ * @brief Large-buffer writer for bulk output
+ *
+ * Collects small appends in one fixed buffer and hands them to an output
+ * stream in large chunks, so bulk output costs one stream call per chunk
+ * rather than one per field.
+ */
+
+#ifndef TODOLIST_BUFFERED_WRITER_H
+#define TODOLIST_BUFFERED_WRITER_H
+
+#include <cstddef>
+#include <iosfwd>
+#include <memory_resource>
+#include <string_view>
+
+namespace todolist {
+
+/**
+ * @brief Append-only output buffer flushed to a stream in large chunks
+ *
+ * Has the same append()/push_back() members as std::string, so code that
+ * formats into either can be written once as a template.
+ *
+ * Example usage:
+ * @code
+ *   BufferedWriter writer(std::cout);
+ *   writer.append("id=");
+ *   writer.appendInteger(42);
+ *   writer.push_back('\n');
+ *   writer.flush();
+ * @endcode
+ */
+class BufferedWriter {
+public:
+    /// Default buffer size: large enough that writes are I/O-bound
+    static constexpr size_t kDefaultCapacity = 1 << 20;
+
+    /**
+     * @brief Constructor
+     * @param out Stream receiving the output
+     * @param capacity Buffer size in bytes
+     * @param resource Allocator for the buffer, e.g. a command arena
+     */
+    explicit BufferedWriter(std::ostream& out, size_t capacity = kDefaultCapacity,
+                            std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /**
+     * @brief Destructor; flushes what is left, ignoring errors
+     *
+     * Call flush() first to find out whether the output was written.
+     */
+    ~BufferedWriter();
+
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+    /**
+     * @brief Append bytes
+     * @param data Bytes to append
+     * @param size Number of bytes
+     *
+     * Blocks larger than the buffer are written straight to the stream.
+     */
+    void append(const char* data, size_t size);
+
+    /**
+     * @brief Append text
+     * @param text Text to append
+     */
+    void append(std::string_view text) { append(text.data(), text.size()); }
+
+    /**
+     * @brief Append one byte
+     * @param c Byte to append
+     */
+    void push_back(char c) {
+        if (used_ == capacity_) {
+            flush();
+        }
+        buffer_[used_++] = c;
+    }
+
+    /**
+     * @brief Append an integer in decimal
+     * @param value Value to append
+     */
+    void appendInteger(long long value);
+
+    /**
+     * @brief Write the buffered bytes to the stream
+     * @throws TodoListException if the stream reports an error
+     */
+    void flush();
+
+private:
+    std::ostream& out_;
+    std::pmr::memory_resource* resource_;
+    size_t capacity_;
+    char* buffer_;
+    size_t used_;
+};
+
+} // namespace todolist
+
+#endif // TODOLIST_BUFFERED_WRITER_H
@@ -9,14 +9,23 @@
 #ifndef TODOLIST_CLI_HANDLER_H
 #define TODOLIST_CLI_HANDLER_H
 
+#include "todolist/buffered_writer.h"
 #include "todolist/command_parser.h"
 #include "todolist/todo_repository.h"
 #include "todolist/formatter.h"
+#include <ctime>
+#include <functional>
+#include <iosfwd>
+#include <map>
 #include <memory>
+#include <memory_resource>
+#include <optional>
 #include <string>
 
 namespace todolist {
 
+class SnapshotFile;
+
 /**
  * @brief Handler for CLI commands
  *
@@ -29,9 +38,11 @@ public:
      * @brief Constructor
      * @param repository The todo repository for data access
      * @param formatter The formatter for output (optional)
+     * @param resource Memory for per-command scratch buffers (e.g. a CommandArena)
      */
     explicit CliHandler(TodoRepository& repository,
-                       std::unique_ptr<Formatter> formatter = nullptr);
+                       std::unique_ptr<Formatter> formatter = nullptr,
+                       std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
     /**
      * @brief Execute a parsed command
@@ -47,33 +58,122 @@ public:
      */
     std::string handleAdd(const std::vector<std::string>& args);
 
+    /**
+     * @brief Handle the add command in batch mode (add --stdin)
+     * @param input Stream with one todo per line: "title" or "title<TAB>description"
+     * @return Summary message
+     *
+     * All items are created in a single transaction; blank lines are skipped.
+     */
+    std::string handleAddBatch(std::istream& input);
+
     /**
      * @brief Handle the list command
      * @param args Command arguments (optional filter)
+     * @param options Command options (--limit <n>, --after <cursor>)
      * @return Formatted list of todos
      */
-    std::string handleList(const std::vector<std::string>& args);
+    std::string handleList(const std::vector<std::string>& args,
+                           const std::map<std::string, std::string>& options = {});
+
+    /**
+     * @brief Handle the list command, writing rows as they are read
+     * @param args Command arguments (optional filter)
+     * @param options Command options (--limit <n>, --after <cursor>)
+     * @param out Stream receiving the formatted list
+     *
+     * Without paging options, memory use is independent of the number of
+     * rows listed.
+     */
+    void streamList(const std::vector<std::string>& args,
+                    const std::map<std::string, std::string>& options, std::ostream& out);
+
+    /**
+     * @brief Handle list --snapshot from a snapshot file, without the database
+     * @param snapshot Current snapshot of the database (see SnapshotFile::openCurrent)
+     * @param args Command arguments (optional filter)
+     * @param options Command options
+     * @param formatter Formatter for the output
+     * @param out Stream receiving the formatted list
+     * @return false, with nothing written, if the command needs the database
+     *         (paging options or an invalid filter)
+     *
+     * Static so that main() can serve the command before opening SQLite.
+     * The output is the same as streamList() for the snapshot's contents.
+     */
+    static bool streamSnapshotList(const SnapshotFile& snapshot, const std::vector<std::string>& args,
+                                   const std::map<std::string, std::string>& options,
+                                   const Formatter& formatter, std::ostream& out);
 
     /**
      * @brief Handle the complete command
-     * @param args Command arguments (todo ID)
-     * @return Success message
+     * @param args Command arguments (one or more IDs or ID ranges such as 5-900)
+     * @return Success message, or one summary line per batch for bulk requests
      */
     std::string handleComplete(const std::vector<std::string>& args);
 
     /**
      * @brief Handle the delete command
-     * @param args Command arguments (todo ID)
-     * @return Success message
+     * @param args Command arguments (one or more IDs or ID ranges such as 5-900)
+     * @param options Command options (--completed, --older-than <duration>)
+     * @return Success message, or one summary line per batch for bulk requests
      */
-    std::string handleDelete(const std::vector<std::string>& args);
+    std::string handleDelete(const std::vector<std::string>& args,
+                             const std::map<std::string, std::string>& options = {});
 
     /**
      * @brief Handle the search command
      * @param args Command arguments (search query)
+     * @param options Command options (--limit <n>, --after <cursor>)
      * @return Formatted search results
      */
-    std::string handleSearch(const std::vector<std::string>& args);
+    std::string handleSearch(const std::vector<std::string>& args,
+                             const std::map<std::string, std::string>& options = {});
+
+    /**
+     * @brief Handle the search command, writing rows as they are read
+     * @param args Command arguments (search query)
+     * @param options Command options (--engine=<name>, --limit <n>, --after <cursor>)
+     * @param out Stream receiving the formatted results
+     */
+    void streamSearch(const std::vector<std::string>& args,
+                      const std::map<std::string, std::string>& options, std::ostream& out);
+
+    /**
+     * @brief Finish the output of streamList(), streamSearch() or streamSnapshotList()
+     * @param formatter Formatter the list was written with
+     * @param out Stream the list was written to
+     *
+     * Text output gets a trailing newline; structured output already ends
+     * with one.
+     */
+    static void endStreamedOutput(const Formatter& formatter, std::ostream& out);
+
+    /**
+     * @brief Handle the export command
+     * @param options Command options (--format=jsonl|csv, --parallel <n>)
+     * @param out Stream receiving the exported rows
+     * @throws ValidationException if an option is invalid
+     */
+    void streamExport(const std::map<std::string, std::string>& options, std::ostream& out);
+
+    /**
+     * @brief Handle the import command
+     * @param args Command arguments (input file)
+     * @param options Command options (--format=jsonl|csv, or --abort to end
+     *        an interrupted import instead)
+     * @return Success message with the number of items imported
+     * @throws ValidationException if the file is missing or malformed, or
+     *         --abort is given with no import in progress
+     */
+    std::string handleImport(const std::vector<std::string>& args,
+                             const std::map<std::string, std::string>& options = {});
+
+    /**
+     * @brief Handle the stats command
+     * @return Formatted total, pending and completed counts
+     */
+    std::string handleStats();
 
     /**
      * @brief Handle the help command
@@ -97,6 +197,7 @@ public:
 private:
     TodoRepository& repository_;
     std::unique_ptr<Formatter> formatter_;
+    std::pmr::memory_resource* resource_;
 
     /**
      * @brief Parse an ID argument
@@ -106,6 +207,71 @@ private:
      */
     int parseId(const std::string& idStr) const;
 
+    /**
+     * @brief Parse ID and ID range arguments (e.g. "1", "5-900")
+     * @param args The ID arguments
+     * @return Sorted, merged list of ranges
+     * @throws ValidationException if an ID or range is invalid
+     */
+    std::vector<IdRange> parseIdRanges(const std::vector<std::string>& args) const;
+
+    /**
+     * @brief Read the --limit option, defaulting when only --after is given
+     * @param options Command options
+     * @return Page size, or empty if the output should not be paginated
+     * @throws ValidationException if the limit is not a positive number
+     */
+    std::optional<int> parsePageSize(const std::map<std::string, std::string>& options) const;
+
+    /**
+     * @brief Search titles in memory with the vectorized matcher (--engine=simd)
+     * @param query Text to find in titles
+     * @param out Stream receiving the formatted results
+     */
+    void streamSimdSearch(const std::string& query, std::ostream& out);
+
+    /**
+     * @brief Create the writer streamed output is formatted into
+     * @param out Stream the writer flushes to
+     * @return Writer whose buffer is allocated from resource_
+     */
+    BufferedWriter makeWriter(std::ostream& out) const;
+
+    /**
+     * @brief Append one page of items followed by the next-page hint
+     * @param page The page to write
+     * @param query Search query the items matched, or empty for a plain list
+     * @param out Writer receiving the formatted page
+     */
+    void writePage(const TodoPage& page, const std::string& query, BufferedWriter& out) const;
+
+    /**
+     * @brief Parse a duration such as "30d", "12h" or "90m"
+     * @param durationStr The duration string (units: s, m, h, d, w)
+     * @return Duration in seconds
+     * @throws ValidationException if the duration is invalid
+     */
+    std::time_t parseDuration(const std::string& durationStr) const;
+
+    /**
+     * @brief Apply a set-based operation to ID ranges in bounded batches
+     * @param ranges The ID ranges to process
+     * @param operation Operation applied to each batch, returning rows changed
+     * @param verb Past-tense description used in the summary lines
+     * @return One summary line per batch followed by a total
+     * @throws NotFoundException if none of the IDs exist
+     */
+    std::string applyToRanges(const std::vector<IdRange>& ranges,
+                              const std::function<int(const IdRange&)>& operation,
+                              const std::string& verb);
+
+    /**
+     * @brief Delete all items matching --completed / --older-than in batches
+     * @param options Command options
+     * @return One summary line per batch followed by a total
+     */
+    std::string handleDeleteMatching(const std::map<std::string, std::string>& options);
+
     /**
      * @brief Validate that arguments list is not empty
      * @param args The arguments to validate
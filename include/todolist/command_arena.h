@@ -0,0 +1,60 @@
+/**
+ * @file command_arena.h
+ * @brief Per-command memory arena
+ *
+ * A monotonic allocator that lives for one CLI command. Parsing scratch
+ * space and output buffers are carved out of a fixed inline block, so a
+ * typical command makes almost no calls to the global heap.
+ */
+
+#ifndef TODOLIST_COMMAND_ARENA_H
+#define TODOLIST_COMMAND_ARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace todolist {
+
+/**
+ * @brief Bump allocator for the lifetime of one command
+ *
+ * Wraps a std::pmr::monotonic_buffer_resource over an inline buffer.
+ * Allocations only move a pointer forward and deallocation is a no-op;
+ * everything is released at once when the arena is destroyed. If the
+ * inline buffer runs out, further blocks come from the global heap.
+ *
+ * The arena is large, so give it automatic storage in main() rather than
+ * on a deep call stack, and do not share it between threads.
+ *
+ * Example usage:
+ * @code
+ *   CommandArena arena;
+ *   ParsedCommand cmd = CommandParser().parse(argc, argv, arena.resource());
+ *   CliHandler handler(repository, std::move(formatter), arena.resource());
+ * @endcode
+ */
+class CommandArena {
+public:
+    /// Size of the inline block served before falling back to the heap
+    static constexpr std::size_t kInlineBytes = 64 * 1024;
+
+    CommandArena()
+        : resource_(buffer_, sizeof(buffer_), std::pmr::new_delete_resource()) {}
+
+    CommandArena(const CommandArena&) = delete;
+    CommandArena& operator=(const CommandArena&) = delete;
+
+    /**
+     * @brief Get the allocator to pass to parser, handler and buffers
+     * @return The arena's memory resource (valid for the arena's lifetime)
+     */
+    std::pmr::memory_resource* resource() { return &resource_; }
+
+private:
+    alignas(std::max_align_t) std::byte buffer_[kInlineBytes];
+    std::pmr::monotonic_buffer_resource resource_;
+};
+
+} // namespace todolist
+
+#endif // TODOLIST_COMMAND_ARENA_H
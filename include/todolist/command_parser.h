@@ -10,9 +10,11 @@
 #define TODOLIST_COMMAND_PARSER_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <optional>
 #include <map>
+#include <memory_resource>
 
 namespace todolist {
 
@@ -25,6 +27,9 @@ enum class Command {
     COMPLETE,   ///< Mark a todo as completed
     DELETE,     ///< Delete a todo item
     SEARCH,     ///< Search for todo items
+    STATS,      ///< Display item statistics
+    EXPORT,     ///< Export all items as JSON Lines or CSV
+    IMPORT,     ///< Import items from a JSON Lines or CSV file
     HELP,       ///< Display help information
     VERSION,    ///< Display version information
     UNKNOWN     ///< Unknown or invalid command
@@ -79,9 +84,14 @@ public:
      * @brief Parse command-line arguments
      * @param argc Argument count
      * @param argv Argument values
+     * @param resource Memory for temporary parsing state (e.g. a CommandArena)
      * @return Parsed command structure
+     *
+     * The arguments are read in place; only the parsed command itself
+     * allocates.
      */
-    ParsedCommand parse(int argc, char* argv[]) const;
+    ParsedCommand parse(int argc, char* argv[],
+                        std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
 
     /**
      * @brief Parse command-line arguments from a vector
@@ -118,19 +128,34 @@ public:
     static std::string getUsage();
 
 private:
+    /**
+     * @brief Parse a sequence of argument tokens
+     * @param args First token (the command)
+     * @param count Number of tokens
+     * @return Parsed command structure
+     */
+    ParsedCommand parseTokens(const std::string_view* args, size_t count) const;
+
     /**
      * @brief Check if a string is a flag (starts with -)
      * @param str The string to check
      * @return true if it's a flag
      */
-    static bool isFlag(const std::string& str);
+    static bool isFlag(std::string_view str);
+
+    /**
+     * @brief Check if a flag never takes a value (such as --snapshot)
+     * @param name The flag name without dashes
+     * @return true if the next argument is never consumed as its value
+     */
+    static bool isSwitch(std::string_view name);
 
     /**
      * @brief Parse a flag string (remove leading dashes)
      * @param flag The flag string
      * @return The flag name without dashes
      */
-    static std::string parseFlag(const std::string& flag);
+    static std::string_view parseFlag(std::string_view flag);
 };
 
 } // namespace todolist
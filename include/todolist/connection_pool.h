@@ -0,0 +1,145 @@
+/**
+ * @file connection_pool.h
+ * @brief Pool of database connections for concurrent readers
+ *
+ * Provides one writer connection and a fixed number of read-only
+ * connections to the same database file, each with its own repository,
+ * so that reads can run on several threads at once.
+ */
+
+#ifndef TODOLIST_CONNECTION_POOL_H
+#define TODOLIST_CONNECTION_POOL_H
+
+#include "todolist/database.h"
+#include "todolist/todo_repository.h"
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace todolist {
+
+/**
+ * @brief Fixed-size pool of one writer and N reader connections
+ *
+ * The database is put in WAL mode so that readers never block the writer
+ * or each other. Every connection is opened with SQLITE_OPEN_NOMUTEX and
+ * is handed to one thread at a time through a Lease, so no locking
+ * happens inside SQLite. Acquiring blocks until a connection of the
+ * requested kind is free.
+ *
+ * Example usage:
+ * @code
+ *   ConnectionPool pool("todos.db", 4);
+ *   // On any thread:
+ *   auto reader = pool.acquireReader();
+ *   auto item = reader.repository().findById(42);
+ * @endcode
+ */
+class ConnectionPool {
+public:
+    class Lease;
+
+    /**
+     * @brief Open the writer and reader connections
+     * @param db_path Path to the database file (in-memory databases cannot be shared)
+     * @param read_connections Number of read-only connections (at least 1)
+     * @param options Connection settings; journal_mode is forced to WAL
+     * @throws ValidationException if the path or connection count is invalid
+     * @throws DatabaseException if a connection cannot be opened
+     */
+    ConnectionPool(const std::string& db_path, size_t read_connections,
+                   const DatabaseOptions& options = DatabaseOptions());
+
+    ~ConnectionPool();
+
+    // Leases point into the pool, so it cannot be copied or moved
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+    /**
+     * @brief Borrow a read-only connection, waiting until one is free
+     * @return Lease on the connection; return it by destroying the lease
+     */
+    Lease acquireReader();
+
+    /**
+     * @brief Borrow the writer connection, waiting until it is free
+     * @return Lease on the connection; return it by destroying the lease
+     */
+    Lease acquireWriter();
+
+    /**
+     * @brief Get the number of read-only connections
+     * @return Reader count
+     */
+    size_t readerCount() const { return readers_.size(); }
+
+private:
+    /**
+     * @brief A pooled connection and the repository bound to it
+     */
+    struct Connection {
+        std::unique_ptr<Database> database;
+        std::unique_ptr<TodoRepository> repository;
+        bool in_use = false;
+    };
+
+    /**
+     * @brief Mark a connection free and wake waiting threads
+     * @param connection Connection returned by a lease
+     */
+    void release(Connection* connection);
+
+    std::mutex mutex_;
+    std::condition_variable available_;
+    std::unique_ptr<Connection> writer_;
+    std::vector<std::unique_ptr<Connection>> readers_;
+};
+
+/**
+ * @brief Exclusive use of one pooled connection
+ *
+ * Move-only. The connection returns to the pool when the lease is
+ * destroyed.
+ */
+class ConnectionPool::Lease {
+public:
+    ~Lease();
+
+    Lease(Lease&& other) noexcept;
+    Lease& operator=(Lease&& other) noexcept;
+
+    Lease(const Lease&) = delete;
+    Lease& operator=(const Lease&) = delete;
+
+    /**
+     * @brief Get the leased connection
+     * @return Database connection
+     */
+    Database& database() const { return *connection_->database; }
+
+    /**
+     * @brief Get the repository bound to the leased connection
+     * @return Todo repository
+     */
+    TodoRepository& repository() const { return *connection_->repository; }
+
+private:
+    friend class ConnectionPool;
+
+    Lease(ConnectionPool* pool, Connection* connection);
+
+    /**
+     * @brief Return the connection to the pool, if still held
+     */
+    void release();
+
+    ConnectionPool* pool_;
+    Connection* connection_;
+};
+
+} // namespace todolist
+
+#endif // TODOLIST_CONNECTION_POOL_H
@@ -10,8 +10,11 @@
 #define TODOLIST_DATABASE_H
 
 #include <string>
+#include <string_view>
 #include <memory>
+#include <map>
 #include <stdexcept>
+#include <cstdint>
 
 // Forward declaration to avoid exposing SQLite3 in the header
 struct sqlite3;
@@ -28,21 +31,117 @@ public:
         : std::runtime_error(message) {}
 };
 
+/**
+ * @brief Scoped handle to a prepared statement from the statement cache
+ *
+ * Obtained through Database::prepare(). When the handle goes out of scope
+ * the statement is reset and its bindings are cleared so that the next
+ * caller receives it in a clean state. Statements that could not be taken
+ * from the cache (because the cached copy is still in use) are finalized
+ * instead.
+ */
+class Statement {
+public:
+    /**
+     * @brief Constructor
+     * @param stmt The prepared statement
+     * @param in_use Cache slot flag to clear on release, or nullptr if the
+     *               statement is not cached and must be finalized
+     */
+    Statement(sqlite3_stmt* stmt, bool* in_use);
+
+    /**
+     * @brief Destructor - resets or finalizes the statement
+     */
+    ~Statement();
+
+    // Disable copy (a statement has a single owner at a time)
+    Statement(const Statement&) = delete;
+    Statement& operator=(const Statement&) = delete;
+
+    // Enable move
+    Statement(Statement&& other) noexcept;
+    Statement& operator=(Statement&& other) noexcept;
+
+    /**
+     * @brief Get the raw SQLite3 statement handle
+     * @return sqlite3_stmt pointer (owned by this handle or the cache)
+     */
+    sqlite3_stmt* get() const { return stmt_; }
+
+private:
+    /**
+     * @brief Return the statement to the cache or finalize it
+     */
+    void release();
+
+    sqlite3_stmt* stmt_;
+    bool* in_use_;
+};
+
+/**
+ * @brief Connection settings applied when a Database is opened
+ *
+ * The defaults suit a database file shared by several processes: WAL
+ * lets readers and a writer work concurrently, synchronous=NORMAL is
+ * durable against application crashes in WAL mode while avoiding an
+ * fsync per commit, and the busy timeout makes a blocked writer wait
+ * instead of failing with SQLITE_BUSY.
+ *
+ * String settings are matched case-insensitively against the values
+ * SQLite accepts for the corresponding PRAGMA.
+ */
+struct DatabaseOptions {
+    std::string journal_mode = "WAL";          ///< DELETE, TRUNCATE, PERSIST, MEMORY, WAL or OFF
+    std::string synchronous = "NORMAL";        ///< OFF, NORMAL, FULL or EXTRA
+    std::int64_t mmap_size = 268435456;        ///< Bytes of the file to memory-map (0 disables)
+    int cache_size = -16384;                   ///< Page cache size: pages if positive, KiB if negative
+    std::string temp_store = "MEMORY";         ///< DEFAULT, FILE or MEMORY
+    int busy_timeout = 5000;                   ///< Milliseconds to wait for a lock before failing
+    int page_size = 4096;                      ///< Page size in bytes; only applies to new databases
+    bool read_only = false;                    ///< Open without write access (the schema must already exist)
+
+    /**
+     * @brief Build options from the defaults overridden by environment variables
+     * @return The resulting options
+     * @throws ValidationException if a variable holds an invalid value
+     *
+     * Each setting is read from TODOLIST_<NAME> with the name upper-cased,
+     * e.g. TODOLIST_JOURNAL_MODE or TODOLIST_BUSY_TIMEOUT.
+     */
+    static DatabaseOptions fromEnvironment();
+
+    /**
+     * @brief Set one option by name
+     * @param name Option name, with words separated by '_' or '-' (e.g. "busy-timeout")
+     * @param value New value
+     * @return true if name is a known option, false otherwise
+     * @throws ValidationException if the value is invalid for the option
+     */
+    bool set(const std::string& name, const std::string& value);
+};
+
 /**
  * @brief RAII wrapper for SQLite database connection
  *
  * This class manages the lifecycle of a SQLite database connection,
  * ensuring proper cleanup through RAII principles. It also handles
  * database initialization and schema migration.
+ *
+ * Connections are opened with SQLITE_OPEN_NOMUTEX: a Database may be
+ * moved between threads but must only be used by one thread at a time.
+ * Use ConnectionPool to read from several threads concurrently.
  */
 class Database {
 public:
     /**
      * @brief Open or create a database at the specified path
      * @param db_path Path to the database file
+     * @param options Connection settings
      * @throws DatabaseException if connection fails
+     * @throws ValidationException if an option holds an invalid value
      */
-    explicit Database(const std::string& db_path);
+    explicit Database(const std::string& db_path, const DatabaseOptions& options = DatabaseOptions());
 
     /**
      * @brief Destructor - closes the database connection
@@ -66,6 +165,18 @@ public:
      */
     sqlite3* getHandle() const { return db_; }
 
+    /**
+     * @brief Get the path of the database file
+     * @return Absolute path, or empty for in-memory and temporary databases
+     */
+    std::string getPath() const;
+
+    /**
+     * @brief Get the settings the connection was opened with
+     * @return Options, for opening further connections to the same file
+     */
+    const DatabaseOptions& getOptions() const { return options_; }
+
     /**
      * @brief Check if the database connection is open
      * @return true if connected, false otherwise
@@ -79,22 +190,205 @@ public:
      */
     void execute(const std::string& sql);
 
+    /**
+     * @brief Get a prepared statement for the given SQL
+     * @param sql SQL statement text
+     * @return Handle to a reset statement ready for binding
+     * @throws DatabaseException if the statement cannot be prepared
+     *
+     * Statements are compiled once per connection with
+     * SQLITE_PREPARE_PERSISTENT and cached by their SQL text. Subsequent
+     * calls with the same text reuse the compiled statement.
+     */
+    Statement prepare(std::string_view sql);
+
+    /**
+     * @brief Get the number of statements in the statement cache
+     * @return Number of cached statements
+     */
+    size_t cachedStatementCount() const { return statement_cache_.size(); }
+
+    /**
+     * @brief Finalize all cached statements that are not currently in use
+     */
+    void clearStatementCache();
+
     /**
      * @brief Get the last error message from SQLite
      * @return Error message string
      */
     std::string getLastError() const;
 
+    /**
+     * @brief Read the current value of a PRAGMA
+     * @param name PRAGMA name (e.g. "journal_mode")
+     * @return The value as text
+     * @throws DatabaseException if the PRAGMA cannot be read
+     */
+    std::string pragma(const std::string& name);
+
+    /**
+     * @brief Get the schema version recorded in PRAGMA user_version
+     * @return Version of the last completed migration (0 for a new database)
+     * @throws DatabaseException if the version cannot be read
+     */
+    int schemaVersion();
+
+    /**
+     * @brief Check whether a table exists in the main schema
+     * @param name Table name
+     * @return true if the table exists
+     */
+    bool tableExists(const char* name);
+
 private:
     /**
-     * @brief Initialize database schema if needed
+     * @brief Apply connection settings
+     * @param options Settings to apply
      *
-     * Creates the todos table if it doesn't exist and runs any
-     * necessary migrations.
+     * Runs before the schema is created so that page_size can take effect.
+     */
+    void configure(const DatabaseOptions& options);
+
+    /**
+     * @brief Bring the schema up to date
+     * @throws DatabaseException if the database was created by a newer build
+     *
+     * Returns after reading user_version when the schema is current;
+     * otherwise runs the pending migrations (see migrations.h).
      */
     void initializeSchema();
 
+    /**
+     * @brief Finalize every cached statement and close the connection
+     */
+    void close();
+
+    /**
+     * @brief A compiled statement owned by the statement cache
+     */
+    struct CachedStatement {
+        sqlite3_stmt* stmt;
+        bool in_use;
+    };
+
     sqlite3* db_;
+    DatabaseOptions options_;
+    std::map<std::string, CachedStatement, std::less<>> statement_cache_;
+};
+
+/**
+ * @brief How a transaction acquires its locks
+ */
+enum class TransactionMode {
+    DEFERRED,   ///< Take locks when first needed (BEGIN DEFERRED)
+    IMMEDIATE,  ///< Take the write lock up front (BEGIN IMMEDIATE)
+    EXCLUSIVE   ///< Take an exclusive lock up front (BEGIN EXCLUSIVE)
+};
+
+/**
+ * @brief Scoped database transaction
+ *
+ * Begins a transaction on construction. Call commit() once the work has
+ * succeeded; if the Transaction is destroyed first (for example because
+ * an exception is propagating) the transaction is rolled back.
+ *
+ * Transactions cannot be nested; use Savepoint for work that may run
+ * inside a caller's transaction.
+ *
+ * Example usage:
+ * @code
+ *   Transaction transaction(database, TransactionMode::IMMEDIATE);
+ *   repository.create(first);
+ *   repository.create(second);
+ *   transaction.commit();
+ * @endcode
+ */
+class Transaction {
+public:
+    /**
+     * @brief Begin a transaction
+     * @param database Connection to run the transaction on
+     * @param mode Locking mode
+     * @throws DatabaseException if the transaction cannot begin
+     */
+    explicit Transaction(Database& database, TransactionMode mode = TransactionMode::DEFERRED);
+
+    /**
+     * @brief Roll back unless committed
+     */
+    ~Transaction();
+
+    Transaction(const Transaction&) = delete;
+    Transaction& operator=(const Transaction&) = delete;
+
+    /**
+     * @brief Commit the transaction
+     * @throws DatabaseException if the commit fails (the transaction is
+     *         then rolled back by the destructor)
+     */
+    void commit();
+
+    /**
+     * @brief Roll back the transaction now
+     */
+    void rollback();
+
+    /**
+     * @brief Check whether the transaction is still open
+     * @return false after commit() or rollback(), or if SQLite rolled the
+     *         transaction back on its own after an error
+     */
+    bool isActive() const;
+
+private:
+    Database& database_;
+    bool finished_;
+};
+
+/**
+ * @brief Scoped savepoint
+ *
+ * Opens a savepoint on construction, which starts a deferred transaction
+ * if none is open or nests inside the current one. release() keeps the
+ * changes made since the savepoint (committing them if the savepoint
+ * started the transaction); destroying an unreleased Savepoint undoes
+ * them and leaves any outer transaction intact.
+ *
+ * Savepoints must be released or destroyed in the reverse order of their
+ * creation, which scoping guarantees.
+ */
+class Savepoint {
+public:
+    /**
+     * @brief Open a savepoint
+     * @param database Connection to open the savepoint on
+     * @throws DatabaseException if the savepoint cannot be opened
+     */
+    explicit Savepoint(Database& database);
+
+    /**
+     * @brief Roll back to and release the savepoint unless released
+     */
+    ~Savepoint();
+
+    Savepoint(const Savepoint&) = delete;
+    Savepoint& operator=(const Savepoint&) = delete;
+
+    /**
+     * @brief Keep the changes made since the savepoint was opened
+     * @throws DatabaseException if the release fails
+     */
+    void release();
+
+    /**
+     * @brief Undo the changes made since the savepoint was opened and close it
+     */
+    void rollback();
+
+private:
+    Database& database_;
+    bool finished_;
 };
 
 } // namespace todolist
@@ -10,11 +10,15 @@
 #define TODOLIST_FORMATTER_H
 
 #include "todolist/todo_item.h"
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace todolist {
 
+class BufferedWriter;
+
 /**
  * @brief ANSI color codes for terminal output
  */
@@ -46,6 +50,32 @@ namespace Color {
  *
  * Provides utilities for formatting todo items and messages
  * with ANSI colors for better readability.
+ *
+ * Every format*() method has an append*() counterpart that writes the
+ * same text into an output sink instead of returning a new string: a
+ * std::string, a std::pmr::string or a BufferedWriter. Appending into a
+ * BufferedWriter renders any number of items without building the whole
+ * output in memory. Color on or off is chosen once per call, and the
+ * formatting code is compiled separately for each case, so plain output
+ * does no per-fragment color checks.
+ *
+ * CliHandler builds each command's output through the virtual methods:
+ * the messages, statistics and item results, and the begin/item/end
+ * hooks of streamed lists. The base class renders them as text for a
+ * terminal; a subclass such as JsonFormatter overrides all of them to
+ * produce another format.
+ *
+ * Example usage:
+ * @code
+ *   BufferedWriter out(std::cout);
+ *   formatter.appendTodoListHeader(out, total, completed);
+ *   repository.forEachView(TodoFilter::ALL, [&](const TodoItemView& item) {
+ *       formatter.appendTodoItem(out, item, false);
+ *       out.append("\n\n");
+ *   });
+ *   formatter.appendTodoListFooter(out);
+ *   out.flush();
+ * @endcode
  */
 class Formatter {
 public:
@@ -55,6 +85,8 @@ public:
      */
     explicit Formatter(bool useColor = true);
 
+    virtual ~Formatter() = default;
+
     /**
      * @brief Format a single todo item for display
      * @param item The todo item to format
@@ -63,6 +95,19 @@ public:
      */
     std::string formatTodoItem(const TodoItem& item, bool showDescription = true) const;
 
+    /**
+     * @brief Append a single todo item to a sink
+     * @param out Sink to append to
+     * @param item The item to format; a TodoItem or a row view from the repository
+     * @param showDescription Whether to include the description
+     *
+     * Produces the same text as formatTodoItem() without streams or
+     * temporary strings, so formatting into a reused buffer does not
+     * allocate once the buffer is large enough.
+     */
+    template <typename Sink>
+    void appendTodoItem(Sink& out, const TodoItemView& item, bool showDescription = true) const;
+
     /**
      * @brief Format a list of todo items as a table
      * @param items The todo items to format
@@ -71,33 +116,125 @@ public:
      */
     std::string formatTodoList(const std::vector<TodoItem>& items, bool showDescription = false) const;
 
+    /**
+     * @brief Append a list of todo items as a table
+     * @param out Sink to append to
+     * @param items The todo items to format
+     * @param showDescription Whether to include descriptions
+     */
+    template <typename Sink>
+    void appendTodoList(Sink& out, const std::vector<TodoItem>& items, bool showDescription = false) const;
+
+    /**
+     * @brief Format the opening of a todo list (header and statistics)
+     * @param total Total number of items in the list
+     * @param completed Number of completed items in the list
+     * @return Formatted header, ending with a blank line
+     *
+     * Together with formatTodoItem() and formatTodoListFooter() this lets
+     * callers stream a list one item at a time; the concatenation matches
+     * formatTodoList().
+     */
+    std::string formatTodoListHeader(size_t total, size_t completed) const;
+
+    /**
+     * @brief Append the opening of a todo list (header and statistics)
+     * @param out Sink to append to
+     * @param total Total number of items in the list
+     * @param completed Number of completed items in the list
+     */
+    template <typename Sink>
+    void appendTodoListHeader(Sink& out, size_t total, size_t completed) const;
+
+    /**
+     * @brief Format the closing line of a todo list
+     * @return Formatted footer
+     */
+    std::string formatTodoListFooter() const;
+
+    /**
+     * @brief Append the closing line of a todo list
+     * @param out Sink to append to
+     */
+    template <typename Sink>
+    void appendTodoListFooter(Sink& out) const;
+
+    /**
+     * @brief Format item statistics as a summary block
+     * @param total Total number of items
+     * @param completed Number of completed items
+     * @return Formatted statistics
+     */
+    virtual std::string formatStats(size_t total, size_t completed) const;
+
+    /**
+     * @brief Append item statistics as a summary block
+     * @param out Sink to append to
+     * @param total Total number of items
+     * @param completed Number of completed items
+     */
+    template <typename Sink>
+    void appendStats(Sink& out, size_t total, size_t completed) const;
+
     /**
      * @brief Format a success message
      * @param message The success message
      * @return Formatted message with green color
      */
-    std::string formatSuccess(const std::string& message) const;
+    virtual std::string formatSuccess(const std::string& message) const;
+
+    /**
+     * @brief Append a success message
+     * @param out Sink to append to
+     * @param message The success message
+     */
+    template <typename Sink>
+    void appendSuccess(Sink& out, std::string_view message) const;
 
     /**
      * @brief Format an error message
      * @param message The error message
      * @return Formatted message with red color
      */
-    std::string formatError(const std::string& message) const;
+    virtual std::string formatError(const std::string& message) const;
+
+    /**
+     * @brief Append an error message
+     * @param out Sink to append to
+     * @param message The error message
+     */
+    template <typename Sink>
+    void appendError(Sink& out, std::string_view message) const;
 
     /**
      * @brief Format a warning message
      * @param message The warning message
      * @return Formatted message with yellow color
      */
-    std::string formatWarning(const std::string& message) const;
+    virtual std::string formatWarning(const std::string& message) const;
+
+    /**
+     * @brief Append a warning message
+     * @param out Sink to append to
+     * @param message The warning message
+     */
+    template <typename Sink>
+    void appendWarning(Sink& out, std::string_view message) const;
 
     /**
      * @brief Format an info message
      * @param message The info message
      * @return Formatted message with blue color
      */
-    std::string formatInfo(const std::string& message) const;
+    virtual std::string formatInfo(const std::string& message) const;
+
+    /**
+     * @brief Append an info message
+     * @param out Sink to append to
+     * @param message The info message
+     */
+    template <typename Sink>
+    void appendInfo(Sink& out, std::string_view message) const;
 
     /**
      * @brief Format a header/title
@@ -106,6 +243,14 @@ public:
      */
     std::string formatHeader(const std::string& title) const;
 
+    /**
+     * @brief Append a header/title
+     * @param out Sink to append to
+     * @param title The header text
+     */
+    template <typename Sink>
+    void appendHeader(Sink& out, std::string_view title) const;
+
     /**
      * @brief Colorize text with a specific color
      * @param text The text to colorize
@@ -114,6 +259,15 @@ public:
      */
     std::string colorize(const std::string& text, const char* color) const;
 
+    /**
+     * @brief Append text in a specific color
+     * @param out Sink to append to
+     * @param text The text to colorize
+     * @param color The ANSI color code
+     */
+    template <typename Sink>
+    void appendColorized(Sink& out, std::string_view text, const char* color) const;
+
     /**
      * @brief Create a separator line
      * @param length Length of the separator (default: 80)
@@ -122,6 +276,97 @@ public:
      */
     std::string separator(size_t length = 80, char character = '-') const;
 
+    /**
+     * @brief Append a separator line
+     * @param out Sink to append to
+     * @param length Length of the separator (default: 80)
+     * @param character Character to use (default: '-')
+     */
+    template <typename Sink>
+    void appendSeparator(Sink& out, size_t length = 80, char character = '-') const;
+
+    /**
+     * @brief Format the result of a command that changed one item
+     * @param message What was done
+     * @param item The item, as it is after the change
+     * @return Success message followed by the item
+     */
+    virtual std::string formatItemResult(const std::string& message, const TodoItem& item) const;
+
+    /**
+     * @brief Format the result of a command that worked in batches
+     * @param steps One message per batch
+     * @param summary Message for the whole command
+     * @param count Number of items changed
+     * @return One success line per batch, then the summary
+     */
+    virtual std::string formatBulkResult(const std::vector<std::string>& steps,
+                                         const std::string& summary, long long count) const;
+
+    /**
+     * @brief Format help text
+     * @param title Heading, or empty for none
+     * @param text The help text
+     * @return Heading and separator, then the text
+     */
+    virtual std::string formatHelp(const std::string& title, const std::string& text) const;
+
+    /**
+     * @brief Format version information
+     * @param version Version number (MAJOR.MINOR.PATCH)
+     * @param build Build identifier
+     * @return Program name, version and build
+     */
+    virtual std::string formatVersion(const std::string& version, const std::string& build) const;
+
+    /**
+     * @brief Whether output is data for programs rather than text for people
+     *
+     * Structured streamed lists end with their own newline, so the caller
+     * adds none.
+     */
+    virtual bool isStructured() const;
+
+    /**
+     * @brief Start a streamed list
+     * @param out Writer receiving the list
+     * @param total Number of items that will follow
+     * @param completed Number of those that are completed
+     * @param query Search query the items matched, or empty for a plain list
+     */
+    virtual void beginList(BufferedWriter& out, size_t total, size_t completed, std::string_view query) const;
+
+    /**
+     * @brief Append one item of a streamed list
+     * @param out Writer receiving the list
+     * @param item The item
+     */
+    virtual void appendListItem(BufferedWriter& out, const TodoItemView& item) const;
+
+    /**
+     * @brief Append several items of a streamed list
+     * @param out Writer receiving the list
+     * @param items The items
+     *
+     * Same output as appendListItem() for each item; the text formatter
+     * renders their timestamps in batches.
+     */
+    virtual void appendListItems(BufferedWriter& out, const std::vector<TodoItem>& items) const;
+
+    /**
+     * @brief Finish a streamed list
+     * @param out Writer receiving the list
+     * @param next_cursor Cursor of the next page, or empty if there is none
+     */
+    virtual void endList(BufferedWriter& out, std::string_view next_cursor) const;
+
+    /**
+     * @brief Append a list with no items, in place of beginList() and endList()
+     * @param out Writer receiving the list
+     * @param query Search query, or empty for a plain list
+     */
+    virtual void appendEmptyList(BufferedWriter& out, std::string_view query) const;
+
     /**
      * @brief Enable or disable color output
      * @param enabled Whether to enable colors
@@ -136,13 +381,6 @@ public:
 
 private:
     bool useColor_;
-
-    /**
-     * @brief Apply color if color output is enabled
-     * @param color The color code
-     * @return The color code if enabled, empty string otherwise
-     */
-    const char* applyColor(const char* color) const;
 };
 
 } // namespace todolist
@@ -0,0 +1,105 @@
+/**
+ * @file importer.h
+ * @brief Bulk import of todo items from JSON Lines or CSV files
+ *
+ * Parses a memory-mapped input file in place and loads it through a single
+ * prepared statement in large transactions, with the indexes on todos
+ * dropped until the load is done. Progress is checkpointed with
+ * every transaction, so an interrupted import resumes where it stopped.
+ */
+
+#ifndef TODOLIST_IMPORTER_H
+#define TODOLIST_IMPORTER_H
+
+#include "todolist/database.h"
+#include "todolist/exporter.h"
+#include <cstddef>
+#include <string>
+
+namespace todolist {
+
+/**
+ * @brief Outcome of Importer::importFile
+ */
+struct ImportResult {
+    size_t rows = 0;          ///< Rows inserted by this call
+    size_t total_rows = 0;    ///< Rows inserted from the file, including interrupted earlier runs
+    bool resumed = false;     ///< Whether an interrupted import of the file was continued
+};
+
+/**
+ * @brief Loads todo items from files in the formats Exporter writes
+ *
+ * JSON Lines input has one object per line with a "title" string and
+ * optional "description" (string or null), "completed" (true, false, 0 or
+ * 1) and "created_at" (Unix seconds) keys; other keys, such as "id", are
+ * skipped. CSV input starts with a header row naming its columns, in any
+ * order; title is required and description, completed and created_at are
+ * optional. Blank lines are skipped in both formats. Items get new ids, in
+ * file order, and a missing created_at means the time of the import.
+ *
+ * While an import runs, the indexes on todos are dropped and recreated
+ * once the whole file is loaded. Each transaction inserts its rows
+ * without firing the search and statistics insert triggers and then
+ * updates the full-text indexes and statistics for them in bulk, so
+ * searches and statistics stay right, including for changes other
+ * processes make meanwhile. Any other trigger on todos fires as usual.
+ *
+ * If the import stops (a crash, or an error such as a malformed line),
+ * the rows committed so far are kept and running it again on the same
+ * file continues after them. The part of the file already imported must
+ * not change, but a bad line after it may be fixed first. abort() ends a
+ * stopped import instead, keeping the rows committed so far.
+ *
+ * Example usage:
+ * @code
+ *   Importer importer(database, ExportFormat::CSV);
+ *   ImportResult result = importer.importFile("legacy.csv");
+ * @endcode
+ */
+class Importer {
+public:
+    /**
+     * @brief Default number of rows inserted per transaction
+     */
+    static constexpr size_t kDefaultRowsPerTransaction = 100000;
+
+    /**
+     * @brief Constructor
+     * @param database Writable connection
+     * @param format Input format
+     * @param rows_per_transaction Rows inserted between checkpoints
+     */
+    Importer(Database& database, ExportFormat format,
+             size_t rows_per_transaction = kDefaultRowsPerTransaction);
+
+    /**
+     * @brief Import a file, or continue an interrupted import of it
+     * @param path Path to the input file
+     * @return Rows inserted, and whether an interrupted import was resumed
+     * @throws ValidationException if the file cannot be read or is malformed,
+     *         or an import of another file has not finished
+     * @throws DatabaseException if a statement fails
+     */
+    ImportResult importFile(const std::string& path);
+
+    /**
+     * @brief Give up on an interrupted import, keeping the rows it committed
+     * @return Rows the interrupted import had inserted
+     * @throws ValidationException if no import is in progress
+     * @throws DatabaseException if a statement fails
+     *
+     * Recreates the indexes the import dropped, so another file can be
+     * imported.
+     */
+    size_t abort();
+
+private:
+    Database& database_;
+    ExportFormat format_;
+    size_t rows_per_transaction_;
+};
+
+} // namespace todolist
+
+#endif // TODOLIST_IMPORTER_H
@@ -0,0 +1,116 @@
+/**
+ * @file json_escape.h
+ * @brief Vectorized JSON string escaping
+ *
+ * Writes JSON string literals into any output sink, finding the bytes that
+ * need escaping or UTF-8 checking with SSE2 or AVX2 when the CPU supports
+ * them.
+ */
+
+#ifndef TODOLIST_JSON_ESCAPE_H
+#define TODOLIST_JSON_ESCAPE_H
+
+#include "todolist/substring_matcher.h"
+#include <charconv>
+#include <cstddef>
+#include <string_view>
+
+namespace todolist {
+
+/**
+ * @brief Find the first byte of a string that cannot be copied into JSON as is
+ * @param text Text to scan
+ * @param size Number of bytes in text
+ * @param level Instruction set to use (clamped to what the CPU supports)
+ * @return Index of the first quote, backslash, control character or
+ *         non-ASCII byte, or size if there is none
+ *
+ * Typical titles and descriptions have few or no such bytes, so most of
+ * the work is this scan; it checks 16 or 32 bytes per step.
+ */
+size_t findJsonEscape(const char* text, size_t size, SimdLevel level = detectSimdLevel());
+
+/**
+ * @brief Measure the UTF-8 sequence at the start of a string
+ * @param text Text starting with a non-ASCII byte
+ * @param size Number of bytes in text
+ * @return Length of the well-formed sequence there (2 to 4), or 0 if the
+ *         bytes are not well-formed UTF-8 (including overlong forms and
+ *         surrogates)
+ */
+size_t utf8SequenceLength(const char* text, size_t size);
+
+/**
+ * @brief Append a JSON string literal
+ * @param out Sink with push_back(char) and append(const char*, size_t)
+ * @param text Text to quote, UTF-8
+ *
+ * Runs of bytes that need no escaping are copied with one append each.
+ * Well-formed UTF-8 passes through unchanged; each byte that is not part
+ * of a well-formed sequence becomes \ufffd, so the output is always
+ * valid JSON text.
+ */
+template <typename Sink>
+void appendJsonString(Sink& out, std::string_view text) {
+    static const char kHex[] = "0123456789abcdef";
+
+    const char* data = text.data();
+    const size_t size = text.size();
+    out.push_back('"');
+    size_t run = 0;
+    size_t i;
+    while ((i = run + findJsonEscape(data + run, size - run)) < size) {
+        out.append(data + run, i - run);
+        unsigned char c = static_cast<unsigned char>(data[i]);
+        if (c >= 0x80) {
+            // Check the whole run of non-ASCII bytes before scanning again
+            run = i;
+            while (i < size && static_cast<unsigned char>(data[i]) >= 0x80) {
+                size_t length = utf8SequenceLength(data + i, size - i);
+                if (length == 0) {
+                    out.append(data + run, i - run);
+                    out.append("\\ufffd", 6);
+                    run = ++i;
+                } else {
+                    i += length;
+                }
+            }
+            out.append(data + run, i - run);
+            run = i;
+            continue;
+        }
+        run = i + 1;
+        switch (c) {
+            case '"':  out.append("\\\"", 2); break;
+            case '\\': out.append("\\\\", 2); break;
+            case '\n': out.append("\\n", 2); break;
+            case '\r': out.append("\\r", 2); break;
+            case '\t': out.append("\\t", 2); break;
+            case '\b': out.append("\\b", 2); break;
+            case '\f': out.append("\\f", 2); break;
+            default: {
+                char escape[6] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0xF]};
+                out.append(escape, sizeof(escape));
+                break;
+            }
+        }
+    }
+    out.append(data + run, size - run);
+    out.push_back('"');
+}
+
+/**
+ * @brief Append an integer as a JSON number
+ * @param out Sink with append(const char*, size_t)
+ * @param value Value to write
+ */
+template <typename Sink>
+void appendJsonInteger(Sink& out, long long value) {
+    char digits[24];
+    char* end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+    out.append(digits, static_cast<size_t>(end - digits));
+}
+
+} // namespace todolist
+
+#endif // TODOLIST_JSON_ESCAPE_H
@@ -0,0 +1,101 @@
+/**
+ * @file json_formatter.h
+ * @brief Machine-readable JSON and NDJSON command output
+ *
+ * Selected with --output=json or --output=ndjson, for scripts that wrap
+ * the CLI and would otherwise parse colored text.
+ */
+
+#ifndef TODOLIST_JSON_FORMATTER_H
+#define TODOLIST_JSON_FORMATTER_H
+
+#include "todolist/formatter.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace todolist {
+
+/**
+ * @brief Output formats selectable with --output
+ */
+enum class OutputMode {
+    TEXT,   ///< Text for a terminal (default)
+    JSON,   ///< One JSON document per command
+    NDJSON  ///< Lists as one JSON object per line; other results as JSON
+};
+
+/**
+ * @brief Parse an --output value
+ * @param name "text", "json" or "ndjson"
+ * @return The output mode
+ * @throws ValidationException if the name is unknown
+ */
+OutputMode parseOutputMode(const std::string& name);
+
+/**
+ * @brief Create the formatter for an output mode
+ * @param mode Output mode
+ * @param useColor Whether text output uses ANSI colors (ignored for JSON)
+ * @return Formatter or JsonFormatter
+ */
+std::unique_ptr<Formatter> makeFormatter(OutputMode mode, bool useColor);
+
+/**
+ * @brief Formatter that writes command results as JSON
+ *
+ * Items are objects with the keys Exporter writes: id, title, description,
+ * completed and created_at (Unix seconds). Messages are
+ * {"status":"ok","message":...}, and errors are
+ * {"status":"error","error":...}.
+ *
+ * Lists are streamed item by item into the output buffer. In JSON mode a
+ * list is one object:
+ * {"query":...,"total":N,"completed":N,"items":[...],"next_cursor":...},
+ * where query appears only for search and next_cursor only when there is
+ * another page. In NDJSON mode each item is written on its own line,
+ * followed by a {"next_cursor":...} line if there is another page.
+ *
+ * Strings are escaped with findJsonEscape(), which checks 16 or 32 bytes
+ * per step, so text without special characters is copied in one append.
+ * Bytes that are not well-formed UTF-8 are written as \ufffd, so scripts
+ * can always decode the output.
+ *
+ * A formatter writes one list at a time.
+ */
+class JsonFormatter : public Formatter {
+public:
+    /**
+     * @brief Constructor
+     * @param lines Whether lists are written as NDJSON
+     */
+    explicit JsonFormatter(bool lines = false);
+
+    std::string formatStats(size_t total, size_t completed) const override;
+    std::string formatSuccess(const std::string& message) const override;
+    std::string formatError(const std::string& message) const override;
+    std::string formatWarning(const std::string& message) const override;
+    std::string formatInfo(const std::string& message) const override;
+    std::string formatItemResult(const std::string& message, const TodoItem& item) const override;
+    std::string formatBulkResult(const std::vector<std::string>& steps,
+                                 const std::string& summary, long long count) const override;
+    std::string formatHelp(const std::string& title, const std::string& text) const override;
+    std::string formatVersion(const std::string& version, const std::string& build) const override;
+    bool isStructured() const override;
+
+    void beginList(BufferedWriter& out, size_t total, size_t completed, std::string_view query) const override;
+    void appendListItem(BufferedWriter& out, const TodoItemView& item) const override;
+    void appendListItems(BufferedWriter& out, const std::vector<TodoItem>& items) const override;
+    void endList(BufferedWriter& out, std::string_view next_cursor) const override;
+    void appendEmptyList(BufferedWriter& out, std::string_view query) const override;
+
+private:
+    bool lines_;
+    mutable size_t listed_ = 0;  ///< Items written since beginList()
+};
+
+} // namespace todolist
+
+#endif // TODOLIST_JSON_FORMATTER_H
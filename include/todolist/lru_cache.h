@@ -0,0 +1,166 @@
+/**
+ * @file lru_cache.h
+ * @brief Bounded least-recently-used cache
+ *
+ * A small map with a fixed capacity that evicts the entry used longest
+ * ago when full, and counts hits and misses so callers can size it.
+ */
+
+#ifndef TODOLIST_LRU_CACHE_H
+#define TODOLIST_LRU_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace todolist {
+
+/**
+ * @brief Hit/miss counters and occupancy of a cache
+ */
+struct CacheStats {
+    std::uint64_t hits = 0;    ///< Lookups answered from the cache
+    std::uint64_t misses = 0;  ///< Lookups that were not cached
+    std::size_t size = 0;      ///< Entries currently cached
+    std::size_t capacity = 0;  ///< Maximum number of entries (0 if disabled)
+};
+
+/**
+ * @brief Fixed-capacity cache with least-recently-used eviction
+ * @tparam Key Hashable key type
+ * @tparam Value Cached value type
+ *
+ * Entries live in a list ordered from most to least recently used, with
+ * a hash index into it, so lookups, insertions and evictions are O(1).
+ *
+ * Example usage:
+ * @code
+ *   LruCache<int, std::string> cache(2);
+ *   cache.put(1, "one");
+ *   if (const std::string* value = cache.get(1)) {
+ *       // use *value
+ *   }
+ * @endcode
+ */
+template <typename Key, typename Value>
+class LruCache {
+public:
+    /**
+     * @brief Constructor
+     * @param capacity Maximum number of entries (0 caches nothing)
+     */
+    explicit LruCache(std::size_t capacity) : capacity_(capacity) {
+        index_.reserve(capacity);
+    }
+
+    /**
+     * @brief Look up an entry and mark it most recently used
+     * @param key Key to look up
+     * @return Pointer to the cached value, or nullptr on a miss
+     *
+     * The pointer stays valid until the entry is erased or evicted.
+     */
+    const Value* get(const Key& key) {
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            ++misses_;
+            return nullptr;
+        }
+        ++hits_;
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return &it->second->second;
+    }
+
+    /**
+     * @brief Insert or replace an entry, evicting the oldest if full
+     * @param key Entry key
+     * @param value Value to cache
+     */
+    void put(const Key& key, Value value) {
+        if (capacity_ == 0) {
+            return;
+        }
+
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            it->second->second = std::move(value);
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return;
+        }
+
+        if (entries_.size() == capacity_) {
+            // Reuse the evicted node rather than freeing and allocating one
+            index_.erase(entries_.back().first);
+            entries_.splice(entries_.begin(), entries_, std::prev(entries_.end()));
+            entries_.front().first = key;
+            entries_.front().second = std::move(value);
+        } else {
+            entries_.emplace_front(key, std::move(value));
+        }
+        index_.emplace(key, entries_.begin());
+    }
+
+    /**
+     * @brief Remove an entry if present
+     * @param key Entry key
+     * @return true if an entry was removed
+     */
+    bool erase(const Key& key) {
+        auto it = index_.find(key);
+        if (it == index_.end()) {
+            return false;
+        }
+        entries_.erase(it->second);
+        index_.erase(it);
+        return true;
+    }
+
+    /**
+     * @brief Remove every entry (counters are kept)
+     */
+    void clear() {
+        entries_.clear();
+        index_.clear();
+    }
+
+    /**
+     * @brief Get the number of cached entries
+     * @return Entry count
+     */
+    std::size_t size() const { return entries_.size(); }
+
+    /**
+     * @brief Get the maximum number of entries
+     * @return Capacity
+     */
+    std::size_t capacity() const { return capacity_; }
+
+    /**
+     * @brief Get hit/miss counters and occupancy
+     * @return Cache statistics
+     */
+    CacheStats stats() const {
+        CacheStats stats;
+        stats.hits = hits_;
+        stats.misses = misses_;
+        stats.size = entries_.size();
+        stats.capacity = capacity_;
+        return stats;
+    }
+
+private:
+    using Entry = std::pair<Key, Value>;
+
+    std::size_t capacity_;
+    std::list<Entry> entries_;
+    std::unordered_map<Key, typename std::list<Entry>::iterator> index_;
+    std::uint64_t hits_ = 0;
+    std::uint64_t misses_ = 0;
+};
+
+} // namespace todolist
+
+#endif // TODOLIST_LRU_CACHE_H
@@ -0,0 +1,99 @@
+/**
+ * @file migrations.h
+ * @brief Versioned schema migrations
+ *
+ * The schema is described as an ordered list of migrations, each bringing
+ * the database from one PRAGMA user_version to the next. Opening a
+ * database that is already at the latest version costs a single read of
+ * user_version.
+ */
+
+#ifndef TODOLIST_MIGRATIONS_H
+#define TODOLIST_MIGRATIONS_H
+
+#include "todolist/database.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace todolist {
+
+/**
+ * @brief Default number of rows copied per backfill transaction
+ */
+constexpr size_t kBackfillChunkRows = 5000;
+
+/**
+ * @brief One step of the schema history
+ *
+ * apply() runs inside an IMMEDIATE transaction. A migration that has to
+ * populate a structure from existing rows (such as a full-text index)
+ * can do so online: apply() only creates the structure and records what
+ * is left to copy, then backfill() is called repeatedly, each call in its
+ * own short transaction, until it reports completion. finish() then runs
+ * in the transaction that records the new version. Between chunks other
+ * connections can read and write as usual.
+ *
+ * user_version is only bumped once a migration has fully completed, so a
+ * process that stops midway resumes where it left off. apply() must
+ * therefore be safe to run again, and databases created before
+ * versioning (user_version 0 with some tables present) must be handled.
+ */
+struct Migration {
+    int version;                                   ///< user_version after this migration
+    const char* description;                       ///< Short human-readable summary
+    void (*apply)(Database& database);             ///< Schema changes
+    bool (*backfill)(Database& database, size_t chunk_rows) = nullptr;  ///< One chunk of data copying; true when done
+    void (*finish)(Database& database) = nullptr;  ///< Final changes after the backfill
+};
+
+/**
+ * @brief Get every migration, in ascending version order
+ * @return The schema history
+ */
+const std::vector<Migration>& schemaMigrations();
+
+/**
+ * @brief Get the schema version this build creates
+ * @return Version of the last migration
+ */
+int latestSchemaVersion();
+
+/**
+ * @brief Bring a database up to the latest schema version
+ * @param database Writable connection
+ * @param chunk_rows Rows copied per backfill transaction
+ * @throws DatabaseException if a migration fails (completed migrations are kept)
+ *
+ * Safe to run from several processes at once: each migration re-checks
+ * the version inside its transaction.
+ */
+void runMigrations(Database& database, size_t chunk_rows = kBackfillChunkRows);
+
+/**
+ * @brief Bring trigger-maintained structures up to date for rows that were
+ * inserted into todos while its triggers were dropped
+ * @param database Writable connection, inside a transaction
+ * @param after_id The inserted rows are those with a larger id
+ * @throws DatabaseException if a statement fails
+ *
+ * Does in a few set-based statements what the insert triggers of the
+ * latest schema do row by row: adds the rows to the full-text and trigram
+ * indexes and to the statistics summary, and counts the insert as one
+ * change. Used by bulk imports.
+ */
+void indexInsertedTodos(Database& database, int64_t after_id);
+
+/**
+ * @brief Names of the insert triggers on todos that indexInsertedTodos() stands in for
+ * @return todos_fts_insert, todos_trigram_insert and todo_stats_insert
+ *
+ * Only these may be dropped around a bulk insert; other triggers on todos
+ * must keep firing.
+ */
+const std::vector<std::string>& bulkInsertTriggers();
+
+} // namespace todolist
+
+#endif // TODOLIST_MIGRATIONS_H
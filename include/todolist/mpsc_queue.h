@@ -0,0 +1,101 @@
+/**
+ * @file mpsc_queue.h
+ * @brief Lock-free multi-producer single-consumer queue
+ *
+ * Unbounded FIFO queue after Dmitry Vyukov's intrusive MPSC design:
+ * producers never block or spin on each other, and the single consumer
+ * never takes a lock.
+ */
+
+#ifndef TODOLIST_MPSC_QUEUE_H
+#define TODOLIST_MPSC_QUEUE_H
+
+#include <atomic>
+#include <optional>
+#include <utility>
+
+namespace todolist {
+
+/**
+ * @brief Unbounded lock-free queue for many producers and one consumer
+ * @tparam T Element type (must be move-constructible)
+ *
+ * push() may be called from any thread. pop() and empty() must only be
+ * called from the one consumer thread.
+ *
+ * The queue is a singly linked list that starts with a stub node.
+ * Producers atomically swap themselves in as the newest node and then
+ * link the previous newest node to it. Between those two steps the
+ * consumer cannot see the new node yet, so pop() may briefly report an
+ * empty queue while a push is in flight; the element becomes visible as
+ * soon as that push returns.
+ */
+template <typename T>
+class MpscQueue {
+public:
+    MpscQueue() : head_(new Node), tail_(head_.load()) {}
+
+    ~MpscQueue() {
+        while (pop()) {
+        }
+        delete tail_;
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    /**
+     * @brief Append an element (any thread)
+     * @param value Element to append
+     *
+     * Sequentially consistent, so that a producer that pushes and then
+     * checks whether the consumer is asleep cannot miss a consumer that
+     * marked itself asleep and then found the queue empty.
+     */
+    void push(T value) {
+        Node* node = new Node;
+        node->value.emplace(std::move(value));
+        Node* previous = head_.exchange(node);
+        previous->next.store(node);
+    }
+
+    /**
+     * @brief Remove the oldest element (consumer thread only)
+     * @return The element, or std::nullopt if none is visible
+     */
+    std::optional<T> pop() {
+        Node* tail = tail_;
+        Node* next = tail->next.load();
+        if (next == nullptr) {
+            return std::nullopt;
+        }
+
+        // next becomes the new stub; its value moves out to the caller
+        std::optional<T> value(std::move(next->value));
+        next->value.reset();
+        tail_ = next;
+        delete tail;
+        return value;
+    }
+
+    /**
+     * @brief Check whether an element is visible (consumer thread only)
+     * @return true if pop() would return std::nullopt
+     */
+    bool empty() const {
+        return tail_->next.load() == nullptr;
+    }
+
+private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        std::optional<T> value;
+    };
+
+    std::atomic<Node*> head_;  ///< Newest node; swapped by producers
+    Node* tail_;               ///< Stub before the oldest element; owned by the consumer
+};
+
+} // namespace todolist
+
+#endif // TODOLIST_MPSC_QUEUE_H
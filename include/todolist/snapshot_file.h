@@ -0,0 +1,210 @@
+/**
+ * @file snapshot_file.h
+ * @brief Memory-mapped binary snapshot of the todo list
+ *
+ * A read-only copy of every todo item, stored next to the database in a
+ * compact file that `list --snapshot` maps into memory instead of opening
+ * SQLite.
+ */
+
+#ifndef TODOLIST_SNAPSHOT_FILE_H
+#define TODOLIST_SNAPSHOT_FILE_H
+
+#include "todolist/database.h"
+#include "todolist/todo_item.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace todolist {
+
+/**
+ * @brief Compute a CRC-32C (Castagnoli) checksum
+ * @param data Bytes to checksum
+ * @param size Number of bytes
+ * @param crc Checksum of the preceding bytes, to continue a running checksum
+ * @return Checksum of everything so far
+ *
+ * Uses the SSE4.2 crc32 instruction when the CPU has it.
+ */
+std::uint32_t crc32c(const void* data, size_t size, std::uint32_t crc = 0);
+
+/**
+ * @brief Identity of a database's current contents
+ *
+ * Combines stat() of the database and its WAL file and the change
+ * counters SQLite keeps in their headers, all read without SQLite, with
+ * the count of changes to todos kept in todo_stats. The file fields rule
+ * out most stale snapshots without opening the database, and checkpoints
+ * change them, which only makes a snapshot look stale, never fresh. They
+ * cannot rule out every commit, though: in WAL mode a commit can reuse
+ * WAL frames without changing the file size, within the resolution of
+ * the modification time, or append its frames just before a reader's
+ * transaction starts but become visible just after. The change count is
+ * read in the same transaction as the items, so it settles those cases.
+ */
+struct DatabaseStamp {
+    std::uint64_t device = 0;          ///< Device of the database file
+    std::uint64_t inode = 0;           ///< Inode of the database file
+    std::uint64_t size = 0;            ///< Database file size in bytes
+    std::uint64_t mtime_ns = 0;        ///< Database file modification time
+    std::uint64_t wal_size = 0;        ///< WAL file size in bytes (0 if absent)
+    std::uint64_t wal_mtime_ns = 0;    ///< WAL file modification time
+    std::uint64_t change_counter = 0;  ///< File change counter from the database header
+    std::uint64_t wal_salt = 0;        ///< Checkpoint sequence and salts from the WAL header
+    std::uint64_t changes = 0;         ///< Changes to todos counted in todo_stats
+
+    /**
+     * @brief Read the file fields of a database's stamp
+     * @param db_path Path to the database file
+     * @return The stamp (all zero if the file does not exist), with changes zero
+     */
+    static DatabaseStamp of(const std::string& db_path);
+
+    /**
+     * @brief Read the count of changes to todos
+     * @param database Open connection
+     * @return The value for the changes field
+     * @throws DatabaseException if the query fails
+     */
+    static std::uint64_t readChanges(Database& database);
+
+    bool operator==(const DatabaseStamp& other) const;
+    bool operator!=(const DatabaseStamp& other) const { return !(*this == other); }
+};
+
+/**
+ * @brief Read-only, memory-mapped snapshot file
+ *
+ * File layout (host byte order, version 2):
+ * - a fixed header: magic, version, record count, completed count, heap
+ *   size, the DatabaseStamp the snapshot was taken at and a CRC-32C of
+ *   the whole file;
+ * - a table of fixed-width records (id, creation time, completion flag,
+ *   and offset and length of the title and description in the heap),
+ *   already in list order, newest first;
+ * - a string heap holding the titles and descriptions.
+ *
+ * Files are written to a temporary name and renamed into place, so a
+ * reader sees either the old or the new file, never a partial one. The
+ * checksum catches files damaged by a crash before the data reached the
+ * disk, which is why writes are not fsynced.
+ *
+ * Example usage:
+ * @code
+ *   if (auto snapshot = SnapshotFile::openCurrent(db_path)) {
+ *       for (size_t i = 0; i < snapshot->size(); ++i) {
+ *           std::cout << snapshot->view(i).getTitle() << '\n';
+ *       }
+ *   }
+ * @endcode
+ */
+class SnapshotFile {
+public:
+    /// Format version written to and required in the header
+    static constexpr std::uint32_t kVersion = 2;
+
+    ~SnapshotFile();
+
+    SnapshotFile(const SnapshotFile&) = delete;
+    SnapshotFile& operator=(const SnapshotFile&) = delete;
+
+    /**
+     * @brief Get the snapshot file path used for a database
+     * @param db_path Path to the database file
+     * @return db_path with ".snapshot" appended
+     */
+    static std::string pathFor(const std::string& db_path) { return db_path + ".snapshot"; }
+
+    /**
+     * @brief Map and validate a snapshot file
+     * @param path Snapshot file path
+     * @return The snapshot, or nullptr if the file is missing, damaged or
+     *         written by another format version
+     */
+    static std::unique_ptr<SnapshotFile> open(const std::string& path);
+
+    /**
+     * @brief Map the snapshot of a database if it matches the database's current state
+     * @param db_path Path to the database file
+     * @return The snapshot, or nullptr if there is no valid snapshot or it is stale
+     *
+     * When the file fields match, a bare read-only SQLite handle reads
+     * the change count with one query; no connection settings are applied
+     * and the schema is not checked.
+     */
+    static std::unique_ptr<SnapshotFile> openCurrent(const std::string& db_path);
+
+    /**
+     * @brief Write a snapshot of a database atomically
+     * @param path Snapshot file path
+     * @param database Database to read
+     * @param stamp File fields of the stamp, taken before reading the
+     *        database; the change count is read with the items
+     * @throws DatabaseException if reading the database fails
+     * @throws TodoListException if the file cannot be written
+     */
+    static void write(const std::string& path, Database& database, DatabaseStamp stamp);
+
+    /**
+     * @brief Bring a database's snapshot file up to date
+     * @param db_path Path to the database file
+     * @param database Open connection to that file, outside any transaction
+     * @param create Write a snapshot even if none exists yet, and verify
+     *        the whole existing file rather than just its header
+     * @return true if a snapshot was written
+     *
+     * Without create, this is cheap when the snapshot is current: only the
+     * file headers and the change count are read. Failures are swallowed, since readers fall
+     * back to the database whenever the snapshot is missing or stale.
+     */
+    static bool refresh(const std::string& db_path, Database& database, bool create);
+
+    /**
+     * @brief Get the number of items
+     */
+    size_t size() const { return record_count_; }
+
+    /**
+     * @brief Get the number of completed items
+     */
+    size_t completedCount() const { return completed_count_; }
+
+    /**
+     * @brief Get the database stamp the snapshot was taken at
+     */
+    const DatabaseStamp& stamp() const { return stamp_; }
+
+    /**
+     * @brief View one item, in list order (newest first)
+     * @param index Position in the list, less than size()
+     * @return View into the mapped file (valid while the snapshot lives)
+     */
+    TodoItemView view(size_t index) const;
+
+private:
+    SnapshotFile() = default;
+
+    /**
+     * @brief Check the header, sizes and checksum of the mapped bytes
+     * @return true if the file is a valid snapshot
+     */
+    bool validate();
+
+    const unsigned char* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    std::vector<unsigned char> buffer_;
+#endif
+    size_t record_count_ = 0;
+    size_t completed_count_ = 0;
+    const unsigned char* records_ = nullptr;
+    const char* heap_ = nullptr;
+    DatabaseStamp stamp_;
+};
+
+} // namespace todolist
+
+#endif // TODOLIST_SNAPSHOT_FILE_H
@@ -0,0 +1,100 @@
+/**
+ * @file substring_matcher.h
+ * @brief Vectorized case-insensitive substring search
+ *
+ * Scans a packed string arena for a fixed needle using SSE2 or AVX2 when
+ * the CPU supports them, with a portable scalar fallback.
+ */
+
+#ifndef TODOLIST_SUBSTRING_MATCHER_H
+#define TODOLIST_SUBSTRING_MATCHER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace todolist {
+
+/**
+ * @brief Instruction sets a SubstringMatcher can use
+ */
+enum class SimdLevel {
+    SCALAR,  ///< Portable byte-at-a-time code
+    SSE2,    ///< 16 bytes per step (every x86-64 CPU)
+    AVX2     ///< 32 bytes per step
+};
+
+/**
+ * @brief Get the best instruction set supported by this build and CPU
+ * @return Detected level (checked once, then cached)
+ */
+SimdLevel detectSimdLevel();
+
+/**
+ * @brief Get the name of an instruction set level
+ * @param level Level to name
+ * @return "scalar", "sse2" or "avx2"
+ */
+const char* simdLevelName(SimdLevel level);
+
+/**
+ * @brief ASCII case-insensitive substring matcher
+ *
+ * Matches with the same rules as SQL LIKE '%needle%' in SQLite: ASCII
+ * letters compare case-insensitively and all other bytes exactly.
+ *
+ * findRows() scans a whole arena of strings stored back to back, rather
+ * than one string at a time. Each step loads a block of bytes at the
+ * candidate start and another at the candidate end, keeps the positions
+ * where both the first and the last needle byte match, and compares only
+ * those in full. Once a row matches, the scan jumps to the next row.
+ *
+ * Example usage:
+ * @code
+ *   SubstringMatcher matcher("milk");
+ *   std::vector<std::uint32_t> rows;
+ *   matcher.findRows(arena, offsets.data(), offsets.size() - 1, rows);
+ * @endcode
+ */
+class SubstringMatcher {
+public:
+    /**
+     * @brief Prepare a matcher
+     * @param needle Text to find
+     * @param level Instruction set to use (clamped to what the CPU supports)
+     */
+    explicit SubstringMatcher(std::string_view needle, SimdLevel level = detectSimdLevel());
+
+    /**
+     * @brief Get the instruction set in use
+     * @return Level chosen at construction
+     */
+    SimdLevel level() const { return level_; }
+
+    /**
+     * @brief Test a single string
+     * @param text Text to search
+     * @return true if text contains the needle
+     */
+    bool matches(std::string_view text) const;
+
+    /**
+     * @brief Find every row of an arena that contains the needle
+     * @param arena Bytes of all rows, back to back
+     * @param offsets rows + 1 ascending offsets into arena; row r is [offsets[r], offsets[r + 1])
+     * @param rows Number of rows
+     * @param out Receives the matching row numbers in ascending order (appended)
+     */
+    void findRows(const char* arena, const size_t* offsets, size_t rows,
+                  std::vector<std::uint32_t>& out) const;
+
+private:
+    std::string needle_;  ///< Needle with ASCII letters lowercased
+    SimdLevel level_;
+};
+
+} // namespace todolist
+
+#endif // TODOLIST_SUBSTRING_MATCHER_H
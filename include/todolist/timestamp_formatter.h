@@ -0,0 +1,112 @@
+/**
+ * @file timestamp_formatter.h
+ * @brief Fast local-time rendering of Unix timestamps
+ *
+ * Formats timestamps as "YYYY-MM-DD HH:MM:SS" in the local time zone
+ * without going through std::tm, strftime or streams for each value.
+ */
+
+#ifndef TODOLIST_TIMESTAMP_FORMATTER_H
+#define TODOLIST_TIMESTAMP_FORMATTER_H
+
+#include <array>
+#include <cstddef>
+#include <ctime>
+#include <string_view>
+
+namespace todolist {
+
+/**
+ * @brief Formats Unix timestamps in local time, caching day boundaries
+ *
+ * The first timestamp of a local day costs three localtime calls: one to
+ * find the UTC offset and two to check that the offset holds from the
+ * start to the end of that day. The day's bounds and date text are then
+ * cached, and any later timestamp in it is formatted with integer
+ * arithmetic. Days with an offset change (daylight saving transitions)
+ * are not cached; their timestamps fall back to one localtime call each.
+ *
+ * The output matches strftime("%Y-%m-%d %H:%M:%S") on localtime. Years are
+ * written without padding, as glibc does. The time zone is read when a day
+ * is first cached, so create a new formatter after changing TZ.
+ *
+ * An instance is not thread-safe; forThread() returns one per thread.
+ *
+ * Example usage:
+ * @code
+ *   TimestampFormatter timestamps;
+ *   char buffer[TimestampFormatter::kBufferSize];
+ *   std::string_view text(buffer, timestamps.format(1700000000, buffer));
+ * @endcode
+ */
+class TimestampFormatter {
+public:
+    /**
+     * @brief Buffer size that fits any format() result
+     */
+    static constexpr size_t kBufferSize = 32;
+
+    /**
+     * @brief One formatted timestamp, as produced by formatBatch()
+     */
+    struct Text {
+        char data[kBufferSize];  ///< Characters, not NUL-terminated
+        size_t size = 0;         ///< Number of characters used
+
+        /// @brief The formatted text
+        std::string_view view() const { return std::string_view(data, size); }
+    };
+
+    TimestampFormatter();
+
+    /**
+     * @brief Format one timestamp
+     * @param unix_time Unix timestamp in seconds
+     * @param buffer Destination of at least kBufferSize bytes
+     * @return Number of characters written (not NUL-terminated)
+     */
+    size_t format(std::time_t unix_time, char* buffer);
+
+    /**
+     * @brief Format an array of timestamps
+     * @param times Unix timestamps in seconds
+     * @param count Number of timestamps
+     * @param out Destination of count entries
+     *
+     * Runs of timestamps on the same day, such as a page of items sorted
+     * by creation time, hit the cache after the first one.
+     */
+    void formatBatch(const std::time_t* times, size_t count, Text* out);
+
+    /**
+     * @brief Get the formatter of the calling thread
+     * @return Formatter that lives as long as the thread
+     */
+    static TimestampFormatter& forThread();
+
+private:
+    /**
+     * @brief A local day with one UTC offset throughout
+     */
+    struct Day {
+        std::time_t begin = 0;  ///< First second of the day, in UTC
+        std::time_t end = 0;    ///< One past the last second of the day, in UTC
+        char date[24];          ///< "YYYY-MM-DD " text
+        size_t date_size = 0;
+    };
+
+    /// Number of days cached, indexed by UTC day number
+    static constexpr size_t kCachedDays = 8;
+
+    /**
+     * @brief Find or cache the local day containing a timestamp
+     * @return The day, or nullptr if it cannot be cached
+     */
+    const Day* findDay(std::time_t unix_time);
+
+    std::array<Day, kCachedDays> days_;
+};
+
+} // namespace todolist
+
+#endif // TODOLIST_TIMESTAMP_FORMATTER_H
@@ -9,7 +9,10 @@
 #ifndef TODOLIST_TODO_ITEM_H
 #define TODOLIST_TODO_ITEM_H
 
+#include "todolist/timestamp_formatter.h"
+#include <cstddef>
 #include <string>
+#include <string_view>
 #include <chrono>
 #include <ctime>
 
@@ -61,8 +64,8 @@ public:
 
     // Setters
     void setId(int id) { id_ = id; }
-    void setTitle(const std::string& title) { title_ = title; }
-    void setDescription(const std::string& description) { description_ = description; }
+    void setTitle(std::string_view title) { title_.assign(title.data(), title.size()); }
+    void setDescription(std::string_view description) { description_.assign(description.data(), description.size()); }
     void setCompleted(bool completed) { completed_ = completed; }
     void setCreatedAt(TimePoint created_at) { created_at_ = created_at; }
 
@@ -85,6 +88,31 @@ public:
      */
     std::string getFormattedCreatedAt() const;
 
+    /**
+     * @brief Buffer size that fits any formatCreatedAt() result
+     */
+    static constexpr size_t kFormattedTimeSize = TimestampFormatter::kBufferSize;
+
+    /**
+     * @brief Format the created_at timestamp into a caller-provided buffer
+     * @param buffer Destination of at least kFormattedTimeSize bytes
+     * @return Number of characters written (YYYY-MM-DD HH:MM:SS, not NUL-counted)
+     *
+     * Same text as getFormattedCreatedAt() without allocating.
+     */
+    size_t formatCreatedAt(char* buffer) const;
+
+    /**
+     * @brief Format a Unix time in local time into a caller-provided buffer
+     * @param unix_time Unix timestamp in seconds
+     * @param buffer Destination of at least kFormattedTimeSize bytes
+     * @return Number of characters written (YYYY-MM-DD HH:MM:SS)
+     *
+     * Uses the calling thread's TimestampFormatter, so consecutive times
+     * on the same day skip the time zone lookup.
+     */
+    static size_t formatUnixTime(std::time_t unix_time, char* buffer);
+
 private:
     int id_;
     std::string title_;
@@ -93,6 +121,74 @@ private:
     TimePoint created_at_;
 };
 
+/**
+ * @brief Non-owning, read-only view of a todo item
+ *
+ * Has the same getters as TodoItem, but title and description are
+ * std::string_views into storage owned by someone else. Views handed out
+ * by TodoRepository point into SQLite's column buffers and are only valid
+ * until the visitor returns; call toItem() to keep a row.
+ */
+class TodoItemView {
+public:
+    TodoItemView() = default;
+
+    /**
+     * @brief Constructor with all fields
+     * @param id Unique identifier
+     * @param title Title text (not copied)
+     * @param description Description text (not copied)
+     * @param completed Whether the item is completed
+     * @param created_at Creation time as Unix seconds
+     */
+    TodoItemView(int id, std::string_view title, std::string_view description,
+                 bool completed, std::time_t created_at)
+        : id_(id), title_(title), description_(description)
+        , completed_(completed), created_at_(created_at) {}
+
+    /**
+     * @brief View an owned item (valid while the item is unchanged)
+     * @param item The item to view
+     */
+    TodoItemView(const TodoItem& item)
+        : id_(item.getId()), title_(item.getTitle()), description_(item.getDescription())
+        , completed_(item.isCompleted()), created_at_(item.getCreatedAtUnix()) {}
+
+    // Getters
+    int getId() const { return id_; }
+    std::string_view getTitle() const { return title_; }
+    std::string_view getDescription() const { return description_; }
+    bool isCompleted() const { return completed_; }
+    std::time_t getCreatedAtUnix() const { return created_at_; }
+    TodoItem::TimePoint getCreatedAt() const { return TodoItem::fromUnixTime(created_at_); }
+
+    /**
+     * @brief Format the created_at timestamp into a caller-provided buffer
+     * @param buffer Destination of at least TodoItem::kFormattedTimeSize bytes
+     * @return Number of characters written
+     */
+    size_t formatCreatedAt(char* buffer) const { return TodoItem::formatUnixTime(created_at_, buffer); }
+
+    /**
+     * @brief Copy the viewed fields into an owned item
+     * @return The item
+     */
+    TodoItem toItem() const;
+
+    /**
+     * @brief Copy the viewed fields into an existing item
+     * @param item Item to overwrite (its string capacity is reused)
+     */
+    void copyTo(TodoItem& item) const;
+
+private:
+    int id_ = 0;
+    std::string_view title_;
+    std::string_view description_;
+    bool completed_ = false;
+    std::time_t created_at_ = 0;
+};
+
 } // namespace todolist
 
 #endif // TODOLIST_TODO_ITEM_H
@@ -11,25 +11,114 @@
 
 #include "todolist/todo_item.h"
 #include "todolist/database.h"
+#include "todolist/lru_cache.h"
 #include <vector>
 #include <optional>
 #include <memory>
+#include <functional>
+#include <ctime>
+#include <cstdint>
 
 namespace todolist {
 
+/**
+ * @brief Completion-status filter for listing queries
+ */
+enum class TodoFilter {
+    ALL,        ///< Every item
+    COMPLETED,  ///< Completed items only
+    PENDING     ///< Pending items only
+};
+
+/**
+ * @brief Item counts for a set of todo items
+ */
+struct TodoStats {
+    int total = 0;      ///< Number of items
+    int completed = 0;  ///< Number of completed items
+    int pending = 0;    ///< Number of pending items
+};
+
+/**
+ * @brief One page of a keyset-paginated query
+ */
+struct TodoPage {
+    std::vector<TodoItem> items;             ///< Items on this page, newest first
+    std::optional<std::string> next_cursor;  ///< Opaque token for the next page; empty on the last page
+};
+
+/**
+ * @brief Outcome of marking a single item completed
+ */
+enum class CompleteStatus {
+    COMPLETED,          ///< The item was pending and is now completed
+    ALREADY_COMPLETED,  ///< The item was already completed; nothing changed
+    NOT_FOUND           ///< No item has the given id
+};
+
+/**
+ * @brief Result of TodoRepository::markCompleted
+ */
+struct CompleteResult {
+    CompleteStatus status;         ///< What happened
+    std::optional<TodoItem> item;  ///< The updated item (set only when status is COMPLETED)
+};
+
+/**
+ * @brief Callback invoked for each row of a streaming query
+ *
+ * The item reference is only valid for the duration of the call; the
+ * repository reuses the same object for every row.
+ */
+using TodoVisitor = std::function<void(const TodoItem&)>;
+
+/**
+ * @brief Callback invoked with a non-owning view of each row
+ *
+ * The view's strings point into SQLite's column buffers and are only
+ * valid for the duration of the call; copy with TodoItemView::toItem()
+ * to keep a row.
+ */
+using TodoViewVisitor = std::function<void(const TodoItemView&)>;
+
+/**
+ * @brief Inclusive range of todo item ids
+ */
+struct IdRange {
+    int first;  ///< First id in the range
+    int last;   ///< Last id in the range (inclusive)
+};
+
+/**
+ * @brief Criteria for set-based bulk operations
+ *
+ * Unset fields match every item.
+ */
+struct BulkFilter {
+    std::optional<bool> completed;              ///< Match on completion status
+    std::optional<std::time_t> created_before;  ///< Match items created before this Unix time
+};
+
 /**
  * @brief Repository for CRUD operations on TodoItem objects
  *
  * This class implements the repository pattern, providing a clean
  * abstraction over the database layer for managing todo items.
+ *
+ * findById() can optionally be served from a bounded LRU cache of items.
+ * Writes made through the repository evict the affected entries. Any
+ * other change to the database, whether from another connection
+ * (detected with PRAGMA data_version) or from SQL run directly on this
+ * one, empties the cache before the next lookup.
  */
 class TodoRepository {
 public:
     /**
      * @brief Constructor
      * @param database Reference to the database connection
+     * @param cache_capacity Number of items findById() may cache (0 disables caching)
      */
-    explicit TodoRepository(Database& database);
+    explicit TodoRepository(Database& database, size_t cache_capacity = 0);
 
     /**
      * @brief Create a new todo item in the database
@@ -39,10 +128,25 @@ public:
      */
     TodoItem create(const TodoItem& item);
 
+    /**
+     * @brief Create many todo items in a single transaction
+     * @param items TodoItems to create (ids are ignored)
+     * @return The database-assigned ids, in the same order as items
+     * @throws DatabaseException if any insert fails (no items are created)
+     *
+     * All rows are inserted through one prepared statement inside a
+     * Savepoint: committed once if no transaction is open, otherwise
+     * nested in the caller's transaction (which a failure leaves intact).
+     */
+    std::vector<int> createBatch(const std::vector<TodoItem>& items);
+
     /**
      * @brief Find a todo item by its id
      * @param id The todo item id
      * @return Optional containing the item if found, empty otherwise
+     *
+     * Served from the item cache when one is configured. Items read
+     * inside an open transaction are not cached, since it may roll back.
      * @throws DatabaseException if query fails
      */
     std::optional<TodoItem> findById(int id);
@@ -73,9 +177,128 @@ public:
      * @param query Search query (case-insensitive, partial match)
      * @return Vector of matching items
      * @throws DatabaseException if query fails
+     *
+     * Queries of three or more characters are answered from the trigram
+     * index, so cost scales with the number of candidate rows rather than
+     * the table size.
      */
     std::vector<TodoItem> findByTitle(const std::string& query);
 
+    /**
+     * @brief Stream todo items matching a filter, newest first
+     * @param filter Completion-status filter
+     * @param visitor Callback invoked once per row as it is read
+     * @throws DatabaseException if query fails
+     *
+     * Rows are decoded one at a time from the live statement, so memory
+     * use does not depend on the number of rows.
+     */
+    void forEach(TodoFilter filter, const TodoVisitor& visitor);
+
+    /**
+     * @brief Stream todo items whose title contains the query, newest first
+     * @param query Search query (case-insensitive, partial match)
+     * @param visitor Callback invoked once per row as it is read
+     * @throws DatabaseException if query fails
+     */
+    void forEachByTitle(const std::string& query, const TodoVisitor& visitor);
+
+    /**
+     * @brief Stream views of todo items matching a filter, newest first
+     * @param filter Completion-status filter
+     * @param visitor Callback invoked once per row with a view of it
+     * @throws DatabaseException if query fails
+     *
+     * Same rows as forEach(), but text columns are not copied out of the
+     * statement. Use this for read-only paths such as printing.
+     */
+    void forEachView(TodoFilter filter, const TodoViewVisitor& visitor);
+
+    /**
+     * @brief Stream views of todo items whose title contains the query, newest first
+     * @param query Search query (case-insensitive, partial match)
+     * @param visitor Callback invoked once per row with a view of it
+     * @throws DatabaseException if query fails
+     */
+    void forEachViewByTitle(const std::string& query, const TodoViewVisitor& visitor);
+
+    /**
+     * @brief Fetch one page of todo items matching a filter, newest first
+     * @param filter Completion-status filter
+     * @param limit Maximum number of items on the page
+     * @param after Cursor returned with the previous page, or empty for the first page
+     * @return The page and the cursor for the next one
+     * @throws ValidationException if limit is not positive or the cursor is malformed
+     * @throws DatabaseException if query fails
+     *
+     * Uses keyset pagination on (created_at, id), so every page costs an
+     * index seek regardless of how deep it is.
+     */
+    TodoPage findPage(TodoFilter filter, int limit,
+                      const std::optional<std::string>& after = std::nullopt);
+
+    /**
+     * @brief Fetch one page of todo items whose title contains the query
+     * @param query Search query (case-insensitive, partial match)
+     * @param limit Maximum number of items on the page
+     * @param after Cursor returned with the previous page, or empty for the first page
+     * @return The page and the cursor for the next one
+     * @throws ValidationException if limit is not positive or the cursor is malformed
+     * @throws DatabaseException if query fails
+     */
+    TodoPage findPageByTitle(const std::string& query, int limit,
+                             const std::optional<std::string>& after = std::nullopt);
+
+    /**
+     * @brief Full-text search over titles and descriptions
+     * @param query Words to match; every word must match, each also as a prefix
+     * @return Matching items, most relevant (bm25) first
+     * @throws DatabaseException if query fails
+     *
+     * Uses the FTS5 index instead of scanning the table, so cost depends on
+     * the number of matches rather than the table size.
+     */
+    std::vector<TodoItem> search(const std::string& query);
+
+    /**
+     * @brief Stream full-text search results, most relevant first
+     * @param query Words to match; every word must match, each also as a prefix
+     * @param visitor Callback invoked once per row as it is read
+     * @throws DatabaseException if query fails
+     */
+    void forEachSearchResult(const std::string& query, const TodoVisitor& visitor);
+
+    /**
+     * @brief Stream views of full-text search results, most relevant first
+     * @param query Words to match; every word must match, each also as a prefix
+     * @param visitor Callback invoked once per row with a view of it
+     * @throws DatabaseException if query fails
+     */
+    void forEachSearchResultView(const std::string& query, const TodoViewVisitor& visitor);
+
+    /**
+     * @brief Count full-text search results
+     * @param query Words to match; every word must match, each also as a prefix
+     * @return Total, completed and pending counts of the matching items
+     * @throws DatabaseException if query fails
+     */
+    TodoStats searchStats(const std::string& query);
+
+    /**
+     * @brief Fetch one page of full-text search results, newest first
+     * @param query Words to match; every word must match, each also as a prefix
+     * @param limit Maximum number of items on the page
+     * @param after Cursor returned with the previous page, or empty for the first page
+     * @return The page and the cursor for the next one
+     * @throws ValidationException if limit is not positive or the cursor is malformed
+     * @throws DatabaseException if query fails
+     *
+     * Pages are ordered by (created_at, id) rather than relevance so that
+     * cursors stay stable.
+     */
+    TodoPage searchPage(const std::string& query, int limit,
+                        const std::optional<std::string>& after = std::nullopt);
+
     /**
      * @brief Update an existing todo item
      * @param item The item to update (must have valid id)
@@ -92,6 +315,78 @@ public:
      */
     bool remove(int id);
 
+    /**
+     * @brief Mark a pending todo item completed
+     * @param id The id of the item
+     * @return The outcome and, on success, the updated item
+     * @throws DatabaseException if the update fails
+     *
+     * The change is a single UPDATE ... RETURNING statement, so no other
+     * writer can slip in between the status check and the update. When
+     * nothing was updated, a follow-up lookup tells a missing item apart
+     * from one that was already completed.
+     */
+    CompleteResult markCompleted(int id);
+
+    /**
+     * @brief Delete a todo item by id and return what was deleted
+     * @param id The id of the item to delete
+     * @return The deleted item, or std::nullopt if no item has that id
+     * @throws DatabaseException if deletion fails
+     *
+     * A single DELETE ... RETURNING statement.
+     */
+    std::optional<TodoItem> removeReturning(int id);
+
+    /**
+     * @brief Find the next chunk of existing ids within a range
+     * @param range The id range to search
+     * @param max_rows Maximum number of existing rows covered by the chunk
+     * @return The lowest and highest id of the chunk, or empty if the range has no items
+     * @throws DatabaseException if query fails
+     *
+     * Used to split bulk operations into batches of bounded size so that
+     * the write lock is released between batches.
+     */
+    std::optional<IdRange> nextIdChunk(const IdRange& range, int max_rows);
+
+    /**
+     * @brief Mark all pending items in an id range as completed
+     * @param range The id range to update
+     * @return Number of items marked as completed
+     * @throws DatabaseException if update fails
+     */
+    int completeRange(const IdRange& range);
+
+    /**
+     * @brief Delete all items in an id range
+     * @param range The id range to delete
+     * @return Number of items deleted
+     * @throws DatabaseException if deletion fails
+     */
+    int removeRange(const IdRange& range);
+
+    /**
+     * @brief Delete up to limit items matching a filter
+     * @param filter Criteria the deleted items must match
+     * @param limit Maximum number of items to delete in this call
+     * @return Number of items deleted (0 once nothing matches)
+     * @throws DatabaseException if deletion fails
+     *
+     * Call repeatedly to delete large sets in bounded batches.
+     */
+    int removeMatching(const BulkFilter& filter, int limit);
+
+    /**
+     * @brief Get total, completed and pending counts of all todo items
+     * @return Item counts
+     * @throws DatabaseException if query fails
+     *
+     * Reads the trigger-maintained summary row, so the cost does not
+     * depend on the number of items.
+     */
+    TodoStats stats();
+
     /**
      * @brief Count total number of todo items
      * @return Number of items
@@ -113,7 +408,51 @@ public:
      */
     int countPending();
 
+    /**
+     * @brief Count todo items matching a filter
+     * @param filter Completion-status filter
+     * @return Number of matching items
+     * @throws DatabaseException if query fails
+     */
+    int count(TodoFilter filter);
+
+    /**
+     * @brief Count todo items whose title contains the query
+     * @param query Search query (case-insensitive, partial match)
+     * @return Total, completed and pending counts of the matching items
+     * @throws DatabaseException if query fails
+     */
+    TodoStats statsByTitle(const std::string& query);
+
+    /**
+     * @brief Get the database connection this repository works on
+     * @return Database connection
+     *
+     * Lets callers group several repository calls in a Transaction.
+     */
+    Database& getDatabase() const { return database_; }
+
+    /**
+     * @brief Get hit/miss counters of the findById() cache
+     * @return Cache statistics (all zero if caching is disabled)
+     */
+    CacheStats cacheStats() const;
+
 private:
+    /**
+     * @brief Empty the item cache if the database changed behind its back
+     *
+     * Compares PRAGMA data_version (commits by other connections) and the
+     * connection's total change count against the values last seen.
+     */
+    void validateCache();
+
+    /**
+     * @brief Account for a write made through this repository
+     * @param id Item that changed, or std::nullopt if many items may have
+     */
+    void noteWrite(std::optional<int> id);
+
     /**
      * @brief Helper to read a TodoItem from a prepared statement
      * @param stmt SQLite prepared statement
@@ -121,7 +460,44 @@ private:
      */
     TodoItem readTodoItem(sqlite3_stmt* stmt);
 
+    /**
+     * @brief Helper to view the current row without copying its text
+     * @param stmt SQLite prepared statement
+     * @return View valid until the statement is stepped, reset or finalized
+     */
+    TodoItemView readTodoItemView(sqlite3_stmt* stmt);
+
+    /**
+     * @brief Step a query to completion, passing each row to a visitor
+     * @param stmt Prepared and bound SQLite statement
+     * @param visitor Callback invoked once per row
+     * @param error_context Message prefix used if stepping fails
+     */
+    void visitRows(sqlite3_stmt* stmt, const TodoVisitor& visitor, const char* error_context);
+
+    /**
+     * @brief Step a query to completion, passing a view of each row to a visitor
+     * @param stmt Prepared and bound SQLite statement
+     * @param visitor Callback invoked once per row
+     * @param error_context Message prefix used if stepping fails
+     */
+    void visitRowViews(sqlite3_stmt* stmt, const TodoViewVisitor& visitor, const char* error_context);
+
+    /**
+     * @brief Run a keyset-paginated query
+     * @param sql SELECT with a WHERE clause; ?1 may be used for a search pattern
+     * @param pattern Value bound to ?1 (LIKE pattern or FTS query), or nullptr if unused
+     * @param limit Maximum number of items on the page
+     * @param after Cursor of the previous page, if any
+     * @return The page and the cursor for the next one
+     */
+    TodoPage fetchPage(std::string sql, const std::string* pattern, int limit,
+                       const std::optional<std::string>& after);
+
     Database& database_;
+    std::optional<LruCache<int, TodoItem>> cache_;
+    std::int64_t cache_data_version_ = -1;
+    std::int64_t cache_total_changes_ = -1;
 };
 
 } // namespace todolist
@@ -0,0 +1,207 @@
+/**
+ * @file todo_snapshot.h
+ * @brief Columnar in-memory copy of the todo table
+ *
+ * Loads every todo item in one scan into a structure-of-arrays layout so
+ * that filtering, counting and sorting touch only the columns they need.
+ */
+
+#ifndef TODOLIST_TODO_SNAPSHOT_H
+#define TODOLIST_TODO_SNAPSHOT_H
+
+#include "todolist/database.h"
+#include "todolist/substring_matcher.h"
+#include "todolist/todo_item.h"
+#include "todolist/todo_repository.h"
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace todolist {
+
+/**
+ * @brief Read-only column store of all todo items at one point in time
+ *
+ * Rows are numbered 0..size()-1 in id order. Each column is a contiguous
+ * array:
+ * - ids and creation times as integer arrays,
+ * - completion status as a bitset (one bit per row, 64 rows per word),
+ * - titles packed back to back in one string arena, and descriptions in
+ *   another, each located through an offsets array.
+ *
+ * Counting completed or pending items is a population count over the
+ * bitset, and status filters walk the set bits a word at a time. Title
+ * search runs a SubstringMatcher over the title arena in one pass. Other
+ * operations return or reorder lists of row numbers, which index every
+ * column.
+ *
+ * The snapshot does not follow later changes to the database; build a
+ * new one to see them.
+ *
+ * Example usage:
+ * @code
+ *   TodoSnapshot snapshot(database);
+ *   size_t pending = snapshot.count(TodoFilter::PENDING);
+ *   TodoSnapshot::Rows rows = snapshot.filterByTitle("milk", TodoFilter::PENDING);
+ *   snapshot.sortNewestFirst(rows);
+ *   for (TodoSnapshot::Row row : rows) {
+ *       std::cout << snapshot.title(row) << '\n';
+ *   }
+ * @endcode
+ */
+class TodoSnapshot {
+public:
+    using Row = std::uint32_t;       ///< Row number
+    using Rows = std::vector<Row>;   ///< Selection of rows
+
+    /**
+     * @brief Create an empty snapshot
+     */
+    TodoSnapshot() = default;
+
+    /**
+     * @brief Load every todo item with a single table scan
+     * @param database Database to read
+     * @throws DatabaseException if the query fails or the table has too many rows
+     */
+    explicit TodoSnapshot(Database& database);
+
+    /**
+     * @brief Get the number of rows
+     * @return Number of items in the snapshot
+     */
+    size_t size() const { return ids_.size(); }
+
+    /**
+     * @brief Check whether the snapshot holds no rows
+     * @return true if empty
+     */
+    bool empty() const { return ids_.empty(); }
+
+    // Column access
+    int id(Row row) const { return ids_[row]; }
+    std::int64_t createdAt(Row row) const { return created_at_[row]; }
+    bool isCompleted(Row row) const { return (completed_[row / 64] >> (row % 64)) & 1u; }
+    std::string_view title(Row row) const { return text(titles_, title_offsets_, row); }
+    std::string_view description(Row row) const { return text(descriptions_, description_offsets_, row); }
+
+    /**
+     * @brief Get the id column
+     * @return Ids of all rows, ascending
+     */
+    const std::vector<int>& ids() const { return ids_; }
+
+    /**
+     * @brief Get the creation time column
+     * @return Unix creation times of all rows
+     */
+    const std::vector<std::int64_t>& createdAts() const { return created_at_; }
+
+    /**
+     * @brief Materialize one row as a TodoItem
+     * @param row Row number
+     * @return The item
+     */
+    TodoItem item(Row row) const;
+
+    /**
+     * @brief View one row without copying its text
+     * @param row Row number
+     * @return View into the snapshot's arenas (valid while the snapshot lives)
+     */
+    TodoItemView view(Row row) const {
+        return TodoItemView(ids_[row], title(row), description(row), isCompleted(row),
+                            static_cast<std::time_t>(created_at_[row]));
+    }
+
+    /**
+     * @brief Find the row holding an id
+     * @param id Todo item id
+     * @param row Receives the row number if found
+     * @return true if the id is in the snapshot
+     */
+    bool findRow(int id, Row& row) const;
+
+    /**
+     * @brief Count items matching a completion-status filter
+     * @param filter Completion-status filter
+     * @return Number of matching items
+     */
+    size_t count(TodoFilter filter) const;
+
+    /**
+     * @brief Select rows matching a completion-status filter
+     * @param filter Completion-status filter
+     * @return Matching rows in id order
+     */
+    Rows filter(TodoFilter filter) const;
+
+    /**
+     * @brief Select rows whose title contains a query
+     * @param query Text to find (ASCII case-insensitive, like SQL LIKE)
+     * @param filter Completion-status filter applied as well
+     * @param level Instruction set for the title scan
+     * @return Matching rows in id order
+     */
+    Rows filterByTitle(std::string_view query, TodoFilter filter = TodoFilter::ALL,
+                       SimdLevel level = detectSimdLevel()) const;
+
+    /**
+     * @brief Select rows created within a time range
+     * @param from First Unix time included
+     * @param to Unix time at which the range ends (excluded)
+     * @param filter Completion-status filter applied as well
+     * @return Matching rows in id order
+     */
+    Rows filterCreatedBetween(std::time_t from, std::time_t to,
+                              TodoFilter filter = TodoFilter::ALL) const;
+
+    /**
+     * @brief Order rows newest first, like the list command
+     * @param rows Rows to reorder (by created_at, then id, descending)
+     */
+    void sortNewestFirst(Rows& rows) const;
+
+    /**
+     * @brief Order rows by title
+     * @param rows Rows to reorder (by title bytes, then id, ascending)
+     */
+    void sortByTitle(Rows& rows) const;
+
+private:
+    /**
+     * @brief Get one row's string from an arena
+     */
+    static std::string_view text(const std::string& arena, const std::vector<size_t>& offsets, Row row) {
+        return std::string_view(arena.data() + offsets[row], offsets[row + 1] - offsets[row]);
+    }
+
+    /**
+     * @brief Get the status bits of one 64-row word under a filter
+     * @param word Word index
+     * @param filter Completion-status filter
+     * @return Bits set for rows of this word that match
+     */
+    std::uint64_t statusWord(size_t word, TodoFilter filter) const;
+
+    /**
+     * @brief Collect rows that match a status filter and a column predicate
+     */
+    template <typename Predicate>
+    Rows select(TodoFilter filter, Predicate predicate) const;
+
+    std::vector<int> ids_;                 ///< id column, ascending
+    std::vector<std::int64_t> created_at_; ///< created_at column (Unix seconds)
+    std::vector<std::uint64_t> completed_; ///< completed column, one bit per row
+    std::string titles_;                   ///< All titles, back to back
+    std::vector<size_t> title_offsets_;    ///< Start of each title in titles_, plus the end
+    std::string descriptions_;             ///< All descriptions, back to back
+    std::vector<size_t> description_offsets_;  ///< Start of each description, plus the end
+};
+
+} // namespace todolist
+
+#endif // TODOLIST_TODO_SNAPSHOT_H
@@ -0,0 +1,173 @@
+#include "todolist/async_writer.h"
+
+namespace todolist {
+
+AsyncWriter::AsyncWriter(Database& database, const AsyncWriterOptions& options)
+    : database_(database)
+    , repository_(database)
+    , options_(options)
+{
+    if (options_.max_batch_size == 0) {
+        options_.max_batch_size = 1;
+    }
+    thread_ = std::thread(&AsyncWriter::run, this);
+}
+
+AsyncWriter::~AsyncWriter() {
+    stopping_.store(true);
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        wake_.notify_one();
+    }
+    thread_.join();
+}
+
+std::future<TodoItem> AsyncWriter::create(TodoItem item) {
+    WriteRequest request;
+    request.kind = WriteRequest::Kind::CREATE;
+    request.item = std::move(item);
+    std::future<TodoItem> result = request.created.get_future();
+    enqueue(std::move(request));
+    return result;
+}
+
+std::future<bool> AsyncWriter::update(TodoItem item) {
+    WriteRequest request;
+    request.kind = WriteRequest::Kind::UPDATE;
+    request.item = std::move(item);
+    std::future<bool> result = request.changed.get_future();
+    enqueue(std::move(request));
+    return result;
+}
+
+std::future<bool> AsyncWriter::remove(int id) {
+    WriteRequest request;
+    request.kind = WriteRequest::Kind::REMOVE;
+    request.id = id;
+    std::future<bool> result = request.changed.get_future();
+    enqueue(std::move(request));
+    return result;
+}
+
+void AsyncWriter::enqueue(WriteRequest request) {
+    queue_.push(std::move(request));
+
+    // Only pay for the mutex when the writer thread may be waiting. Both
+    // this load and the writer's store of sleeping_ are sequentially
+    // consistent with the queue operations, so at least one side sees
+    // the other.
+    if (sleeping_.load()) {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        wake_.notify_one();
+    }
+}
+
+void AsyncWriter::waitForRequests(const std::chrono::steady_clock::time_point* deadline) {
+    std::unique_lock<std::mutex> lock(wake_mutex_);
+    sleeping_.store(true);
+
+    auto ready = [this] { return !queue_.empty() || stopping_.load(); };
+    if (deadline) {
+        wake_.wait_until(lock, *deadline, ready);
+    } else {
+        wake_.wait(lock, ready);
+    }
+
+    sleeping_.store(false);
+}
+
+void AsyncWriter::run() {
+    std::vector<WriteRequest> batch;
+    batch.reserve(options_.max_batch_size);
+
+    while (true) {
+        std::optional<WriteRequest> request = queue_.pop();
+        if (!request) {
+            if (stopping_.load() && queue_.empty()) {
+                return;
+            }
+            waitForRequests(nullptr);
+            continue;
+        }
+
+        // The first write opens the batch; others may join until it is
+        // full or the oldest write has waited max_delay
+        auto deadline = std::chrono::steady_clock::now() + options_.max_delay;
+        batch.push_back(std::move(*request));
+
+        while (batch.size() < options_.max_batch_size) {
+            if ((request = queue_.pop())) {
+                batch.push_back(std::move(*request));
+                continue;
+            }
+            if (stopping_.load() || std::chrono::steady_clock::now() >= deadline) {
+                break;
+            }
+            waitForRequests(&deadline);
+        }
+
+        commitBatch(batch);
+        batch.clear();
+    }
+}
+
+void AsyncWriter::commitBatch(std::vector<WriteRequest>& batch) {
+    try {
+        Transaction transaction(database_, TransactionMode::IMMEDIATE);
+
+        for (auto& request : batch) {
+            try {
+                switch (request.kind) {
+                    case WriteRequest::Kind::CREATE:
+                        request.created_item = repository_.create(request.item);
+                        break;
+                    case WriteRequest::Kind::UPDATE:
+                        request.changed_result = repository_.update(request.item);
+                        break;
+                    case WriteRequest::Kind::REMOVE:
+                        request.changed_result = repository_.remove(request.id);
+                        break;
+                }
+            } catch (const DatabaseException&) {
+                // A failed statement is undone on its own and the
+                // transaction continues, unless SQLite had to roll the
+                // whole transaction back (e.g. out of disk space)
+                if (!transaction.isActive()) {
+                    throw;
+                }
+                request.error = std::current_exception();
+            }
+        }
+
+        transaction.commit();
+    } catch (...) {
+        // The transaction has already been rolled back by its destructor
+        std::exception_ptr error = std::current_exception();
+        for (auto& request : batch) {
+            if (request.kind == WriteRequest::Kind::CREATE) {
+                request.created.set_exception(error);
+            } else {
+                request.changed.set_exception(error);
+            }
+        }
+        return;
+    }
+
+    committed_batches_.fetch_add(1);
+
+    for (auto& request : batch) {
+        if (request.error) {
+            if (request.kind == WriteRequest::Kind::CREATE) {
+                request.created.set_exception(request.error);
+            } else {
+                request.changed.set_exception(request.error);
+            }
+        } else if (request.kind == WriteRequest::Kind::CREATE) {
+            request.created.set_value(std::move(request.created_item));
+        } else {
+            request.changed.set_value(request.changed_result);
+        }
+    }
+}
+
+} // namespace todolist
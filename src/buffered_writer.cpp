@@ -0,0 +1,54 @@
+#include "todolist/buffered_writer.h"
+#include "todolist/exceptions.h"
+#include <charconv>
+#include <cstring>
+#include <ostream>
+
+namespace todolist {
+
+BufferedWriter::BufferedWriter(std::ostream& out, size_t capacity, std::pmr::memory_resource* resource)
+    : out_(out)
+    , resource_(resource)
+    , capacity_(capacity > 0 ? capacity : 1)
+    , buffer_(static_cast<char*>(resource_->allocate(capacity_, 1)))
+    , used_(0) {
+}
+
+BufferedWriter::~BufferedWriter() {
+    try {
+        flush();
+    } catch (...) {
+        // Destructors must not throw; callers that care call flush() first
+    }
+    resource_->deallocate(buffer_, capacity_, 1);
+}
+
+void BufferedWriter::append(const char* data, size_t size) {
+    if (size > capacity_ - used_) {
+        flush();
+        if (size >= capacity_) {
+            out_.write(data, static_cast<std::streamsize>(size));
+            return;
+        }
+    }
+    std::memcpy(buffer_ + used_, data, size);
+    used_ += size;
+}
+
+void BufferedWriter::appendInteger(long long value) {
+    char digits[24];
+    char* end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+    append(digits, static_cast<size_t>(end - digits));
+}
+
+void BufferedWriter::flush() {
+    if (used_ > 0) {
+        out_.write(buffer_, static_cast<std::streamsize>(used_));
+        used_ = 0;
+    }
+    if (!out_) {
+        throw TodoListException("Failed to write output");
+    }
+}
+
+} // namespace todolist
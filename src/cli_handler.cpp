@@ -1,15 +1,109 @@
 #include "todolist/cli_handler.h"
+#include "todolist/buffered_writer.h"
 #include "todolist/exceptions.h"
+#include "todolist/exporter.h"
+#include "todolist/importer.h"
+#include "todolist/snapshot_file.h"
+#include "todolist/todo_snapshot.h"
 #include "todolist/version.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
 #include <iostream>
+#include <limits>
 #include <sstream>
 
 namespace todolist {
 
+namespace {
+
+/// Maximum number of rows touched by one bulk statement, so the write lock
+/// is released regularly during large operations
+constexpr int kBulkBatchSize = 5000;
+
+/// Page size used when --after is given without --limit
+constexpr int kDefaultPageSize = 50;
+
+/// Size of the buffer streamed output is collected in before each write
+/// to the stream: a few hundred rows, small enough for the command arena
+constexpr size_t kOutputBufferSize = 32 * 1024;
+
+/// Upper bound for export --parallel
+constexpr int kMaxExportThreads = 64;
+
+/**
+ * @brief Check whether an ID argument is a range such as "5-900"
+ */
+bool isIdRange(const std::string& arg) {
+    return arg.find('-', 1) != std::string::npos;
+}
+
+/**
+ * @brief Look up an option value
+ */
+std::optional<std::string> findOption(const std::map<std::string, std::string>& options, const char* name) {
+    auto it = options.find(name);
+    if (it != options.end()) {
+        return it->second;
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Search strategies selectable with --engine
+ */
+enum class SearchEngine {
+    FTS,        ///< Ranked full-text word and prefix matching (default)
+    SUBSTRING,  ///< Case-insensitive substring match on titles, in SQL
+    SIMD        ///< Case-insensitive substring match on titles, scanned in memory
+};
+
+/**
+ * @brief Read the --engine option
+ * @throws ValidationException if the engine is unknown
+ */
+SearchEngine parseSearchEngine(const std::map<std::string, std::string>& options) {
+    auto engine = options.find("engine");
+    if (engine == options.end() || engine->second == "fts") {
+        return SearchEngine::FTS;
+    }
+    if (engine->second == "substring") {
+        return SearchEngine::SUBSTRING;
+    }
+    if (engine->second == "simd") {
+        return SearchEngine::SIMD;
+    }
+    throw ValidationException("Invalid search engine: " + engine->second + " (use fts, substring or simd)");
+}
+
+/**
+ * @brief Read the list filter argument (all, completed or pending)
+ * @throws ValidationException if the filter is unknown
+ */
+TodoFilter parseListFilter(const std::vector<std::string>& args) {
+    std::string filterStr = "all";
+    if (!args.empty()) {
+        filterStr = args[0];
+    }
+
+    if (filterStr == "all") {
+        return TodoFilter::ALL;
+    } else if (filterStr == "completed") {
+        return TodoFilter::COMPLETED;
+    } else if (filterStr == "pending") {
+        return TodoFilter::PENDING;
+    }
+    throw ValidationException("Invalid filter. Use: all, completed, or pending");
+}
+
+} // anonymous namespace
+
 CliHandler::CliHandler(TodoRepository& repository,
-                       std::unique_ptr<Formatter> formatter)
+                       std::unique_ptr<Formatter> formatter,
+                       std::pmr::memory_resource* resource)
     : repository_(repository)
-    , formatter_(formatter ? std::move(formatter) : std::make_unique<Formatter>()) {
+    , formatter_(formatter ? std::move(formatter) : std::make_unique<Formatter>())
+    , resource_(resource) {
 }
 
 int CliHandler::execute(const ParsedCommand& cmd) {
@@ -20,34 +114,47 @@ int CliHandler::execute(const ParsedCommand& cmd) {
         if (cmd.hasFlag("help") || cmd.hasFlag("h")) {
             if (cmd.command != Command::HELP && cmd.command != Command::UNKNOWN) {
                 std::string cmdStr = CommandParser::commandToString(cmd.command);
-                std::ostringstream oss;
-                oss << formatter_->formatHeader("Help for: " + cmdStr) << "\n";
-                oss << formatter_->separator() << "\n\n";
-                oss << CommandParser::getCommandHelp(cmd.command);
-                std::cout << oss.str() << std::endl;
+                std::cout << formatter_->formatHelp("Help for: " + cmdStr,
+                                                    CommandParser::getCommandHelp(cmd.command)) << std::endl;
                 return 0;
             }
         }
 
         switch (cmd.command) {
             case Command::ADD:
-                output = handleAdd(cmd.args);
+                output = cmd.hasFlag("stdin") ? handleAddBatch(std::cin) : handleAdd(cmd.args);
                 break;
 
             case Command::LIST:
-                output = handleList(cmd.args);
-                break;
+                streamList(cmd.args, cmd.options, std::cout);
+                endStreamedOutput(*formatter_, std::cout);
+                return 0;
 
             case Command::COMPLETE:
                 output = handleComplete(cmd.args);
                 break;
 
             case Command::DELETE:
-                output = handleDelete(cmd.args);
+                output = handleDelete(cmd.args, cmd.options);
                 break;
 
             case Command::SEARCH:
-                output = handleSearch(cmd.args);
+                streamSearch(cmd.args, cmd.options, std::cout);
+                endStreamedOutput(*formatter_, std::cout);
+                return 0;
+
+            case Command::STATS:
+                output = handleStats();
+                break;
+
+            case Command::EXPORT:
+                // Data only: no trailing blank line
+                streamExport(cmd.options, std::cout);
+                std::cout.flush();
+                return 0;
+
+            case Command::IMPORT:
+                output = handleImport(cmd.args, cmd.options);
                 break;
 
             case Command::HELP:
@@ -98,89 +205,206 @@ std::string CliHandler::handleAdd(const std::vector<std::string>& args) {
     }
 
     // Create the todo item
-    TodoItem item(title, description);
-    repository_.create(item);
+    TodoItem item = repository_.create(TodoItem(title, description));
+
+    return formatter_->formatItemResult("Todo item created successfully", item);
+}
+
+std::string CliHandler::handleAddBatch(std::istream& input) {
+    std::vector<TodoItem> items;
+    std::string line;
+    size_t lineNumber = 0;
+
+    while (std::getline(input, line)) {
+        ++lineNumber;
+
+        // Tolerate CRLF input
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+
+        if (line.empty()) {
+            continue;
+        }
+
+        std::string title = line;
+        std::string description;
+        size_t tab = line.find('\t');
+        if (tab != std::string::npos) {
+            title = line.substr(0, tab);
+            description = line.substr(tab + 1);
+        }
+
+        if (title.empty()) {
+            throw ValidationException("Title cannot be empty (line " + std::to_string(lineNumber) + ")");
+        }
+
+        items.emplace_back(std::move(title), std::move(description));
+    }
+
+    if (items.empty()) {
+        return formatter_->formatInfo("No todo items read from input.");
+    }
+
+    std::vector<int> ids = repository_.createBatch(items);
 
     std::ostringstream oss;
-    oss << formatter_->formatSuccess("Todo item created successfully");
-    oss << "\n\n";
-    oss << formatter_->formatTodoItem(item, true);
+    oss << ids.size() << " todo item" << (ids.size() == 1 ? "" : "s") << " created successfully";
+
+    // Ids are contiguous unless another writer interleaved
+    if (ids.back() - ids.front() + 1 == static_cast<int>(ids.size())) {
+        oss << " (IDs " << ids.front() << "-" << ids.back() << ")";
+    }
+
+    return formatter_->formatSuccess(oss.str());
+}
 
+std::string CliHandler::handleList(const std::vector<std::string>& args,
+                                   const std::map<std::string, std::string>& options) {
+    std::ostringstream oss;
+    streamList(args, options, oss);
     return oss.str();
 }
 
-std::string CliHandler::handleList(const std::vector<std::string>& args) {
-    std::string filter = "all";
-    if (!args.empty()) {
-        filter = args[0];
+void CliHandler::streamList(const std::vector<std::string>& args,
+                            const std::map<std::string, std::string>& options, std::ostream& out) {
+    TodoFilter filter = parseListFilter(args);
+    BufferedWriter writer = makeWriter(out);
+
+    if (auto pageSize = parsePageSize(options)) {
+        writePage(repository_.findPage(filter, *pageSize, findOption(options, "after")), "", writer);
+        writer.flush();
+        return;
     }
 
-    std::vector<TodoItem> items;
+    // Read the header counts and the rows from one snapshot
+    Transaction snapshot(repository_.getDatabase());
+
+    TodoStats stats = repository_.stats();
+    size_t total = static_cast<size_t>(stats.total);
+    size_t completed = static_cast<size_t>(stats.completed);
+    if (filter == TodoFilter::COMPLETED) {
+        total = completed;
+    } else if (filter == TodoFilter::PENDING) {
+        total = static_cast<size_t>(stats.pending);
+        completed = 0;
+    }
 
-    if (filter == "all") {
-        items = repository_.findAll();
-    } else if (filter == "completed") {
-        items = repository_.findCompleted();
-    } else if (filter == "pending") {
-        items = repository_.findPending();
+    if (total == 0) {
+        formatter_->appendEmptyList(writer, "");
     } else {
-        throw ValidationException("Invalid filter. Use: all, completed, or pending");
+        formatter_->beginList(writer, total, completed, "");
+        repository_.forEachView(filter, [this, &writer](const TodoItemView& item) {
+            formatter_->appendListItem(writer, item);
+        });
+        formatter_->endList(writer, "");
+    }
+    writer.flush();
+
+    snapshot.commit();
+}
+
+bool CliHandler::streamSnapshotList(const SnapshotFile& snapshot, const std::vector<std::string>& args,
+                                    const std::map<std::string, std::string>& options,
+                                    const Formatter& formatter, std::ostream& out) {
+    // Paging and invalid filters go through the database path, which
+    // handles and reports them
+    if (options.count("limit") || options.count("after")) {
+        return false;
+    }
+    TodoFilter filter;
+    try {
+        filter = parseListFilter(args);
+    } catch (const ValidationException&) {
+        return false;
+    }
+
+    size_t total = snapshot.size();
+    size_t completed = snapshot.completedCount();
+    if (filter == TodoFilter::COMPLETED) {
+        total = completed;
+    } else if (filter == TodoFilter::PENDING) {
+        total -= completed;
+        completed = 0;
+    }
+
+    BufferedWriter writer(out, kOutputBufferSize);
+    if (total == 0) {
+        formatter.appendEmptyList(writer, "");
+        writer.flush();
+        return true;
     }
 
-    return formatter_->formatTodoList(items, false);
+    formatter.beginList(writer, total, completed, "");
+    for (size_t i = 0; i < snapshot.size(); ++i) {
+        TodoItemView item = snapshot.view(i);
+        if (filter == TodoFilter::ALL || item.isCompleted() == (filter == TodoFilter::COMPLETED)) {
+            formatter.appendListItem(writer, item);
+        }
+    }
+    formatter.endList(writer, "");
+    writer.flush();
+    return true;
 }
 
 std::string CliHandler::handleComplete(const std::vector<std::string>& args) {
-    requireArgs(args, "Todo ID is required. Usage: complete <id>");
+    requireArgs(args, "Todo ID is required. Usage: complete <id>...");
+
+    if (args.size() > 1 || isIdRange(args[0])) {
+        return applyToRanges(parseIdRanges(args),
+                             [this](const IdRange& range) { return repository_.completeRange(range); },
+                             "marked as completed");
+    }
 
     int id = parseId(args[0]);
 
-    // Find the item
-    auto item = repository_.findById(id);
-    if (!item) {
+    CompleteResult result = repository_.markCompleted(id);
+    if (result.status == CompleteStatus::NOT_FOUND) {
         throw NotFoundException(id);
     }
-
-    // Check if already completed
-    if (item->isCompleted()) {
+    if (result.status == CompleteStatus::ALREADY_COMPLETED) {
         throw ValidationException("Todo item is already completed");
     }
 
-    // Mark as completed
-    item->setCompleted(true);
-    repository_.update(*item);
+    return formatter_->formatItemResult("Todo item marked as completed", *result.item);
+}
 
-    std::ostringstream oss;
-    oss << formatter_->formatSuccess("Todo item marked as completed");
-    oss << "\n\n";
-    oss << formatter_->formatTodoItem(*item, true);
+std::string CliHandler::handleDelete(const std::vector<std::string>& args,
+                                     const std::map<std::string, std::string>& options) {
+    if (options.count("completed") || options.count("older-than")) {
+        if (!args.empty()) {
+            throw ValidationException("IDs cannot be combined with --completed or --older-than");
+        }
+        return handleDeleteMatching(options);
+    }
 
-    return oss.str();
-}
+    requireArgs(args, "Todo ID is required. Usage: delete <id>...");
 
-std::string CliHandler::handleDelete(const std::vector<std::string>& args) {
-    requireArgs(args, "Todo ID is required. Usage: delete <id>");
+    if (args.size() > 1 || isIdRange(args[0])) {
+        return applyToRanges(parseIdRanges(args),
+                             [this](const IdRange& range) { return repository_.removeRange(range); },
+                             "deleted");
+    }
 
     int id = parseId(args[0]);
 
-    // Find the item first to verify it exists
-    auto item = repository_.findById(id);
+    auto item = repository_.removeReturning(id);
     if (!item) {
         throw NotFoundException(id);
     }
 
-    // Delete the item
-    repository_.remove(id);
+    return formatter_->formatItemResult("Todo item deleted successfully", *item);
+}
 
+std::string CliHandler::handleSearch(const std::vector<std::string>& args,
+                                     const std::map<std::string, std::string>& options) {
     std::ostringstream oss;
-    oss << formatter_->formatSuccess("Todo item deleted successfully");
-    oss << "\n\n";
-    oss << formatter_->formatTodoItem(*item, true);
-
+    streamSearch(args, options, oss);
     return oss.str();
 }
 
-std::string CliHandler::handleSearch(const std::vector<std::string>& args) {
+void CliHandler::streamSearch(const std::vector<std::string>& args,
+                              const std::map<std::string, std::string>& options, std::ostream& out) {
     requireArgs(args, "Search query is required. Usage: search <query>");
 
     const std::string& query = args[0];
@@ -189,23 +413,143 @@ std::string CliHandler::handleSearch(const std::vector<std::string>& args) {
         throw ValidationException("Search query cannot be empty");
     }
 
-    auto items = repository_.findByTitle(query);
+    SearchEngine engine = parseSearchEngine(options);
+    bool fullText = engine == SearchEngine::FTS;
 
-    if (items.empty()) {
-        return formatter_->formatInfo("No todo items found matching: " + query);
+    if (engine == SearchEngine::SIMD) {
+        if (parsePageSize(options)) {
+            throw ValidationException("--limit and --after are not supported with --engine=simd");
+        }
+        streamSimdSearch(query, out);
+        return;
+    }
+
+    BufferedWriter writer = makeWriter(out);
+
+    if (auto pageSize = parsePageSize(options)) {
+        auto after = findOption(options, "after");
+        TodoPage page = fullText ? repository_.searchPage(query, *pageSize, after)
+                                 : repository_.findPageByTitle(query, *pageSize, after);
+        writePage(page, query, writer);
+        writer.flush();
+        return;
+    }
+
+    // Read the header counts and the rows from one snapshot
+    Transaction snapshot(repository_.getDatabase());
+
+    TodoStats stats = fullText ? repository_.searchStats(query) : repository_.statsByTitle(query);
+
+    if (stats.total == 0) {
+        formatter_->appendEmptyList(writer, query);
+        writer.flush();
+        return;
+    }
+
+    formatter_->beginList(writer, static_cast<size_t>(stats.total), static_cast<size_t>(stats.completed), query);
+
+    TodoViewVisitor writeItem = [this, &writer](const TodoItemView& item) {
+        formatter_->appendListItem(writer, item);
+    };
+    if (fullText) {
+        repository_.forEachSearchResultView(query, writeItem);
+    } else {
+        repository_.forEachViewByTitle(query, writeItem);
+    }
+    formatter_->endList(writer, "");
+    writer.flush();
+
+    snapshot.commit();
+}
+
+void CliHandler::streamSimdSearch(const std::string& query, std::ostream& out) {
+    // One scan loads the table into columns; the title arena is then
+    // searched in a single vectorized pass
+    TodoSnapshot snapshot(repository_.getDatabase());
+    TodoSnapshot::Rows rows = snapshot.filterByTitle(query);
+
+    BufferedWriter writer = makeWriter(out);
+    if (rows.empty()) {
+        formatter_->appendEmptyList(writer, query);
+        writer.flush();
+        return;
+    }
+
+    snapshot.sortNewestFirst(rows);
+
+    size_t completed = 0;
+    for (TodoSnapshot::Row row : rows) {
+        completed += snapshot.isCompleted(row);
+    }
+
+    formatter_->beginList(writer, rows.size(), completed, query);
+    for (TodoSnapshot::Row row : rows) {
+        formatter_->appendListItem(writer, snapshot.view(row));
+    }
+    formatter_->endList(writer, "");
+    writer.flush();
+}
+
+void CliHandler::streamExport(const std::map<std::string, std::string>& options, std::ostream& out) {
+    ExportFormat format = parseExportFormat(findOption(options, "format").value_or("jsonl"));
+
+    size_t threads = 1;
+    if (auto parallel = findOption(options, "parallel")) {
+        int value = 0;
+        auto result = std::from_chars(parallel->data(), parallel->data() + parallel->size(), value);
+        if (result.ec != std::errc() || result.ptr != parallel->data() + parallel->size() ||
+            value < 1 || value > kMaxExportThreads) {
+            throw ValidationException("Parallel must be a number from 1 to " +
+                                      std::to_string(kMaxExportThreads) + ": " + *parallel);
+        }
+        threads = static_cast<size_t>(value);
+    }
+
+    Exporter exporter(repository_.getDatabase(), format);
+    exporter.exportParallel(repository_.getDatabase().getPath(), threads, out);
+}
+
+std::string CliHandler::handleImport(const std::vector<std::string>& args,
+                                     const std::map<std::string, std::string>& options) {
+    if (options.count("abort")) {
+        if (!args.empty()) {
+            throw ValidationException("A file cannot be combined with --abort");
+        }
+        size_t rows = Importer(repository_.getDatabase(), ExportFormat::JSONL).abort();
+        return formatter_->formatSuccess("Import aborted; the " + std::to_string(rows) + " todo item" +
+                                         (rows == 1 ? "" : "s") + " already imported are kept");
+    }
+
+    requireArgs(args, "File is required. Usage: import <file> [--format=jsonl|csv] | import --abort");
+    const std::string& path = args[0];
+
+    ExportFormat format = ExportFormat::JSONL;
+    if (auto name = findOption(options, "format")) {
+        format = parseExportFormat(*name);
+    } else if (path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0) {
+        format = ExportFormat::CSV;
     }
 
+    Importer importer(repository_.getDatabase(), format);
+    ImportResult result = importer.importFile(path);
+
     std::ostringstream oss;
-    oss << formatter_->formatHeader("Search Results for: " + query) << "\n";
-    oss << formatter_->separator() << "\n\n";
-    oss << formatter_->formatTodoList(items, false);
+    oss << result.rows << " todo item" << (result.rows == 1 ? "" : "s") << " imported successfully";
+    if (result.resumed) {
+        oss << " (resumed; " << result.total_rows << " in total)";
+    }
+    return formatter_->formatSuccess(oss.str());
+}
 
-    return oss.str();
+std::string CliHandler::handleStats() {
+    TodoStats stats = repository_.stats();
+    return formatter_->formatStats(static_cast<size_t>(stats.total),
+                                   static_cast<size_t>(stats.completed));
 }
 
 std::string CliHandler::handleHelp(const std::vector<std::string>& args) {
     if (args.empty()) {
-        return CommandParser::getUsage();
+        return formatter_->formatHelp("", CommandParser::getUsage());
     }
 
     // Get help for specific command
@@ -216,20 +560,13 @@ std::string CliHandler::handleHelp(const std::vector<std::string>& args) {
         throw ValidationException("Unknown command: " + cmdStr);
     }
 
-    std::ostringstream oss;
-    oss << formatter_->formatHeader("Help for: " + cmdStr) << "\n";
-    oss << formatter_->separator() << "\n\n";
-    oss << CommandParser::getCommandHelp(cmd);
-
-    return oss.str();
+    return formatter_->formatHelp("Help for: " + cmdStr, CommandParser::getCommandHelp(cmd));
 }
 
 std::string CliHandler::handleVersion() {
-    std::ostringstream oss;
-    oss << formatter_->formatHeader("Todo List CLI") << "\n";
-    oss << "Version: " << TODOLIST_VERSION_MAJOR << "." << TODOLIST_VERSION_MINOR << "." << TODOLIST_VERSION_PATCH << "\n";
-    oss << "Build: " << TODOLIST_VERSION;
-    return oss.str();
+    std::ostringstream version;
+    version << TODOLIST_VERSION_MAJOR << "." << TODOLIST_VERSION_MINOR << "." << TODOLIST_VERSION_PATCH;
+    return formatter_->formatVersion(version.str(), TODOLIST_VERSION);
 }
 
 Formatter& CliHandler::getFormatter() {
@@ -258,6 +595,207 @@ int CliHandler::parseId(const std::string& idStr) const {
     }
 }
 
+std::vector<IdRange> CliHandler::parseIdRanges(const std::vector<std::string>& args) const {
+    std::vector<IdRange> ranges;
+    ranges.reserve(args.size());
+
+    for (const auto& arg : args) {
+        if (!isIdRange(arg)) {
+            int id = parseId(arg);
+            ranges.push_back({id, id});
+            continue;
+        }
+
+        size_t dash = arg.find('-', 1);
+        int first = parseId(arg.substr(0, dash));
+        int last = parseId(arg.substr(dash + 1));
+
+        if (first > last) {
+            throw ValidationException("Invalid ID range: " + arg);
+        }
+
+        ranges.push_back({first, last});
+    }
+
+    // Sort and merge overlapping or adjacent ranges
+    std::sort(ranges.begin(), ranges.end(),
+              [](const IdRange& a, const IdRange& b) { return a.first < b.first; });
+
+    std::vector<IdRange> merged;
+    for (const auto& range : ranges) {
+        if (!merged.empty() && static_cast<long long>(range.first) <= static_cast<long long>(merged.back().last) + 1) {
+            merged.back().last = std::max(merged.back().last, range.last);
+        } else {
+            merged.push_back(range);
+        }
+    }
+
+    return merged;
+}
+
+std::optional<int> CliHandler::parsePageSize(const std::map<std::string, std::string>& options) const {
+    auto limit = options.find("limit");
+    if (limit == options.end()) {
+        if (options.count("after")) {
+            return kDefaultPageSize;
+        }
+        return std::nullopt;
+    }
+
+    try {
+        size_t pos;
+        int pageSize = std::stoi(limit->second, &pos);
+
+        if (pos != limit->second.length() || pageSize <= 0) {
+            throw ValidationException("Limit must be a positive number: " + limit->second);
+        }
+
+        return pageSize;
+    } catch (const std::invalid_argument&) {
+        throw ValidationException("Limit must be a positive number: " + limit->second);
+    } catch (const std::out_of_range&) {
+        throw ValidationException("Limit is out of range: " + limit->second);
+    }
+}
+
+BufferedWriter CliHandler::makeWriter(std::ostream& out) const {
+    return BufferedWriter(out, kOutputBufferSize, resource_);
+}
+
+void CliHandler::writePage(const TodoPage& page, const std::string& query, BufferedWriter& out) const {
+    if (page.items.empty()) {
+        formatter_->appendEmptyList(out, query);
+        return;
+    }
+
+    size_t completed = std::count_if(page.items.begin(), page.items.end(),
+                                      [](const TodoItem& item) { return item.isCompleted(); });
+    formatter_->beginList(out, page.items.size(), completed, query);
+    formatter_->appendListItems(out, page.items);
+    formatter_->endList(out, page.next_cursor ? *page.next_cursor : "");
+}
+
+void CliHandler::endStreamedOutput(const Formatter& formatter, std::ostream& out) {
+    if (formatter.isStructured()) {
+        out.flush();
+    } else {
+        out << std::endl;
+    }
+}
+
+std::time_t CliHandler::parseDuration(const std::string& durationStr) const {
+    if (durationStr.size() < 2) {
+        throw ValidationException("Invalid duration: " + durationStr + " (expected e.g. 30d, 12h)");
+    }
+
+    std::time_t unit = 0;
+    switch (durationStr.back()) {
+        case 's': unit = 1; break;
+        case 'm': unit = 60; break;
+        case 'h': unit = 60 * 60; break;
+        case 'd': unit = 24 * 60 * 60; break;
+        case 'w': unit = 7 * 24 * 60 * 60; break;
+        default:
+            throw ValidationException("Invalid duration unit: " + durationStr + " (use s, m, h, d or w)");
+    }
+
+    std::string amountStr = durationStr.substr(0, durationStr.size() - 1);
+    try {
+        size_t pos;
+        long long amount = std::stoll(amountStr, &pos);
+
+        if (pos != amountStr.length() || amount < 0) {
+            throw ValidationException("Invalid duration: " + durationStr);
+        }
+        if (amount > std::numeric_limits<std::time_t>::max() / unit) {
+            throw ValidationException("Duration is out of range: " + durationStr);
+        }
+
+        return static_cast<std::time_t>(amount) * unit;
+    } catch (const std::invalid_argument&) {
+        throw ValidationException("Invalid duration: " + durationStr);
+    } catch (const std::out_of_range&) {
+        throw ValidationException("Duration is out of range: " + durationStr);
+    }
+}
+
+std::string CliHandler::applyToRanges(const std::vector<IdRange>& ranges,
+                                      const std::function<int(const IdRange&)>& operation,
+                                      const std::string& verb) {
+    std::vector<std::string> steps;
+    bool found = false;
+    long long total = 0;
+
+    for (const auto& range : ranges) {
+        IdRange remaining = range;
+
+        while (true) {
+            // Each chunk is looked up and changed in its own transaction, so
+            // batches are atomic and the write lock is released between them
+            Transaction transaction(repository_.getDatabase(), TransactionMode::IMMEDIATE);
+
+            auto chunk = repository_.nextIdChunk(remaining, kBulkBatchSize);
+            if (!chunk) {
+                break;
+            }
+
+            found = true;
+            int changed = operation(*chunk);
+            transaction.commit();
+            total += changed;
+
+            steps.push_back("IDs " + std::to_string(chunk->first) + "-" + std::to_string(chunk->last) + ": " +
+                            std::to_string(changed) + " " + verb);
+
+            if (chunk->last >= remaining.last) {
+                break;
+            }
+            remaining.first = chunk->last + 1;
+        }
+    }
+
+    if (!found) {
+        throw NotFoundException("No todo items found with the given IDs");
+    }
+
+    return formatter_->formatBulkResult(steps, "Total: " + std::to_string(total) + " items " + verb, total);
+}
+
+std::string CliHandler::handleDeleteMatching(const std::map<std::string, std::string>& options) {
+    BulkFilter filter;
+
+    if (options.count("completed")) {
+        filter.completed = true;
+    }
+
+    auto olderThan = options.find("older-than");
+    if (olderThan != options.end()) {
+        std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+        std::time_t duration = parseDuration(olderThan->second);
+        // A cutoff before the epoch just matches nothing, but one past now
+        // would match everything
+        if (now < 0 || duration < 0) {
+            throw ValidationException("Duration is out of range: " + olderThan->second);
+        }
+        filter.created_before = now - duration;
+    }
+
+    std::vector<std::string> steps;
+    long long total = 0;
+    int deleted;
+
+    while ((deleted = repository_.removeMatching(filter, kBulkBatchSize)) > 0) {
+        total += deleted;
+        steps.push_back("Batch " + std::to_string(steps.size() + 1) + ": " + std::to_string(deleted) + " deleted");
+    }
+
+    if (total == 0) {
+        return formatter_->formatInfo("No todo items matched the filter.");
+    }
+
+    return formatter_->formatBulkResult(steps, "Total: " + std::to_string(total) + " items deleted", total);
+}
+
 void CliHandler::requireArgs(const std::vector<std::string>& args, const std::string& message) const {
     if (args.empty()) {
         throw ValidationException(message);
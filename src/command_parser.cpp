@@ -16,26 +16,33 @@ std::optional<std::string> ParsedCommand::getOption(const std::string& option) c
     return std::nullopt;
 }
 
-ParsedCommand CommandParser::parse(int argc, char* argv[]) const {
-    std::vector<std::string> args;
+ParsedCommand CommandParser::parse(int argc, char* argv[], std::pmr::memory_resource* resource) const {
+    // View the arguments in place rather than copying each one
+    std::pmr::vector<std::string_view> tokens(resource);
+    tokens.reserve(argc > 1 ? static_cast<size_t>(argc - 1) : 0);
     // Skip program name (argv[0])
     for (int i = 1; i < argc; ++i) {
-        args.push_back(argv[i]);
+        tokens.emplace_back(argv[i]);
     }
-    return parse(args);
+    return parseTokens(tokens.data(), tokens.size());
 }
 
 ParsedCommand CommandParser::parse(const std::vector<std::string>& args) const {
+    std::vector<std::string_view> tokens(args.begin(), args.end());
+    return parseTokens(tokens.data(), tokens.size());
+}
+
+ParsedCommand CommandParser::parseTokens(const std::string_view* args, size_t count) const {
     ParsedCommand result;
     result.command = Command::UNKNOWN;
 
-    if (args.empty()) {
+    if (count == 0) {
         result.command = Command::HELP;
         return result;
     }
 
     // First argument is the command
-    const std::string& cmdStr = args[0];
+    std::string_view cmdStr = args[0];
 
     // Check for special flags that override command parsing
     if (cmdStr == "-h" || cmdStr == "--help") {
@@ -49,26 +56,35 @@ ParsedCommand CommandParser::parse(const std::vector<std::string>& args) const {
     }
 
     // Parse the command
-    result.command = stringToCommand(cmdStr);
+    result.command = stringToCommand(std::string(cmdStr));
 
     // Parse remaining arguments
-    for (size_t i = 1; i < args.size(); ++i) {
-        const std::string& arg = args[i];
+    result.args.reserve(count - 1);
+    for (size_t i = 1; i < count; ++i) {
+        std::string_view arg = args[i];
 
         if (isFlag(arg)) {
-            std::string flagName = parseFlag(arg);
+            std::string_view flagName = parseFlag(arg);
+
+            // Inline value (--name=value)
+            size_t equals = flagName.find('=');
+            if (equals != std::string_view::npos) {
+                result.options.insert_or_assign(std::string(flagName.substr(0, equals)),
+                                                std::string(flagName.substr(equals + 1)));
+                continue;
+            }
 
             // Check if next argument is the value for this flag
-            if (i + 1 < args.size() && !isFlag(args[i + 1])) {
-                result.options[flagName] = args[i + 1];
+            if (i + 1 < count && !isFlag(args[i + 1]) && !isSwitch(flagName)) {
+                result.options.insert_or_assign(std::string(flagName), std::string(args[i + 1]));
                 ++i; // Skip the value argument
             } else {
                 // Boolean flag (no value)
-                result.options[flagName] = "true";
+                result.options.insert_or_assign(std::string(flagName), std::string("true"));
             }
         } else {
             // Positional argument
-            result.args.push_back(arg);
+            result.args.emplace_back(arg);
         }
     }
 
@@ -82,6 +98,9 @@ std::string CommandParser::commandToString(Command cmd) {
         case Command::COMPLETE: return "complete";
         case Command::DELETE:   return "delete";
         case Command::SEARCH:   return "search";
+        case Command::STATS:    return "stats";
+        case Command::EXPORT:   return "export";
+        case Command::IMPORT:   return "import";
         case Command::HELP:     return "help";
         case Command::VERSION:  return "version";
         case Command::UNKNOWN:  return "unknown";
@@ -104,6 +123,12 @@ Command CommandParser::stringToCommand(const std::string& str) {
         return Command::DELETE;
     } else if (lower == "search" || lower == "s" || lower == "find") {
         return Command::SEARCH;
+    } else if (lower == "stats" || lower == "stat" || lower == "st") {
+        return Command::STATS;
+    } else if (lower == "export") {
+        return Command::EXPORT;
+    } else if (lower == "import") {
+        return Command::IMPORT;
     } else if (lower == "help" || lower == "h") {
         return Command::HELP;
     } else if (lower == "version" || lower == "v") {
@@ -117,44 +142,93 @@ std::string CommandParser::getCommandHelp(Command cmd) {
     switch (cmd) {
         case Command::ADD:
             return "add <title> [description]\n"
-                   "  Add a new todo item.\n"
+                   "add --stdin\n"
+                   "  Add a new todo item. With --stdin, read one item per line\n"
+                   "  (title, optionally followed by a tab and a description)\n"
+                   "  and create them all in a single transaction.\n"
                    "  Aliases: a, new\n"
                    "  Examples:\n"
                    "    todo add \"Buy groceries\"\n"
-                   "    todo add \"Fix bug\" \"Fix the memory leak in parser\"";
+                   "    todo add \"Fix bug\" \"Fix the memory leak in parser\"\n"
+                   "    cat todos.txt | todo add --stdin";
 
         case Command::LIST:
-            return "list [filter]\n"
+            return "list [filter] [--limit <n>] [--after <cursor>] [--snapshot]\n"
                    "  List todo items. Optional filter: all, completed, pending.\n"
+                   "  With --limit, show one page and print the cursor for the next.\n"
+                   "  With --snapshot, read a memory-mapped copy of the list kept\n"
+                   "  beside the database instead of querying it; the copy is\n"
+                   "  created on first use and refreshed after every change.\n"
                    "  Aliases: l, ls\n"
                    "  Examples:\n"
                    "    todo list\n"
                    "    todo list completed\n"
-                   "    todo list pending";
+                   "    todo list pending --limit 20\n"
+                   "    todo list pending --snapshot";
 
         case Command::COMPLETE:
-            return "complete <id>\n"
-                   "  Mark a todo item as completed.\n"
+            return "complete <id>...\n"
+                   "  Mark todo items as completed. Accepts several IDs and\n"
+                   "  ranges, processed in batches.\n"
                    "  Aliases: c, done\n"
                    "  Examples:\n"
                    "    todo complete 1\n"
-                   "    todo done 42";
+                   "    todo done 42\n"
+                   "    todo complete 1 2 5-900";
 
         case Command::DELETE:
-            return "delete <id>\n"
-                   "  Delete a todo item.\n"
+            return "delete <id>...\n"
+                   "delete [--completed] [--older-than <duration>]\n"
+                   "  Delete todo items by ID or range, or every item matching\n"
+                   "  the filters (duration units: s, m, h, d, w).\n"
                    "  Aliases: d, del, rm\n"
                    "  Examples:\n"
                    "    todo delete 1\n"
-                   "    todo rm 42";
+                   "    todo rm 42\n"
+                   "    todo delete 10-20 35\n"
+                   "    todo delete --completed --older-than 30d";
 
         case Command::SEARCH:
-            return "search <query>\n"
-                   "  Search for todo items by title.\n"
+            return "search <query> [--engine=fts|substring|simd] [--limit <n>] [--after <cursor>]\n"
+                   "  Search for todo items. The default full-text engine matches\n"
+                   "  words and word prefixes in titles and descriptions, best\n"
+                   "  matches first; --engine=substring matches any part of the title.\n"
+                   "  --engine=simd finds the same items by scanning all titles in\n"
+                   "  memory with vector instructions (no --limit).\n"
                    "  Aliases: s, find\n"
                    "  Examples:\n"
                    "    todo search \"groceries\"\n"
-                   "    todo find bug";
+                   "    todo find bug\n"
+                   "    todo search --engine=substring rocer";
+
+        case Command::STATS:
+            return "stats\n"
+                   "  Show the number of total, pending and completed todo items.\n"
+                   "  Aliases: stat, st\n"
+                   "  Example:\n"
+                   "    todo stats";
+
+        case Command::EXPORT:
+            return "export [--format=jsonl|csv] [--parallel <n>]\n"
+                   "  Write every todo item to standard output in id order, as\n"
+                   "  JSON Lines (default) or CSV with a header row. With\n"
+                   "  --parallel, n read connections scan id ranges at once.\n"
+                   "  Example:\n"
+                   "    todo export --format=csv > todos.csv\n"
+                   "    todo export --parallel 4 > todos.jsonl";
+
+        case Command::IMPORT:
+            return "import <file> [--format=jsonl|csv]\n"
+                   "import --abort\n"
+                   "  Add the todo items in a file written by export (ids are\n"
+                   "  reassigned). The format defaults to csv for .csv files and\n"
+                   "  jsonl otherwise. An interrupted import continues where it\n"
+                   "  stopped when run again on the same file; --abort ends it\n"
+                   "  instead, keeping the items imported so far.\n"
+                   "  Examples:\n"
+                   "    todo import todos.jsonl\n"
+                   "    todo import legacy.txt --format=csv\n"
+                   "    todo import --abort";
 
         case Command::HELP:
             return "help [command]\n"
@@ -186,25 +260,39 @@ std::string CommandParser::getUsage() {
     oss << getCommandHelp(Command::COMPLETE) << "\n\n";
     oss << getCommandHelp(Command::DELETE) << "\n\n";
     oss << getCommandHelp(Command::SEARCH) << "\n\n";
+    oss << getCommandHelp(Command::STATS) << "\n\n";
+    oss << getCommandHelp(Command::EXPORT) << "\n\n";
+    oss << getCommandHelp(Command::IMPORT) << "\n\n";
     oss << getCommandHelp(Command::HELP) << "\n\n";
-    oss << getCommandHelp(Command::VERSION) << "\n";
+    oss << getCommandHelp(Command::VERSION) << "\n\n";
+
+    oss << "Output options (any command):\n";
+    oss << "  --output=<format>        text (default), json, or ndjson (lists one item per line)\n\n";
+
+    oss << "Database options (any command; also read from TODOLIST_<NAME> variables):\n";
+    oss << "  --journal-mode=<mode>    delete, truncate, persist, memory, wal (default), off\n";
+    oss << "  --synchronous=<level>    off, normal (default), full, extra\n";
+    oss << "  --busy-timeout=<ms>      wait this long for a locked database (default 5000)\n";
+    oss << "  --cache-size=<n>         page cache: pages, or KiB if negative (default -16384)\n";
+    oss << "  --mmap-size=<bytes>      memory-mapped I/O size (default 268435456)\n";
+    oss << "  --temp-store=<where>     default, file, memory (default)\n";
+    oss << "  --page-size=<bytes>      page size for new databases (default 4096)\n";
 
     return oss.str();
 }
 
-bool CommandParser::isFlag(const std::string& str) {
+bool CommandParser::isFlag(std::string_view str) {
     return !str.empty() && str[0] == '-';
 }
 
-std::string CommandParser::parseFlag(const std::string& flag) {
-    std::string result = flag;
+bool CommandParser::isSwitch(std::string_view name) {
+    return name == "abort" || name == "completed" || name == "snapshot" || name == "stdin";
+}
 
+std::string_view CommandParser::parseFlag(std::string_view flag) {
     // Remove leading dashes
-    while (!result.empty() && result[0] == '-') {
-        result = result.substr(1);
-    }
-
-    return result;
+    size_t start = flag.find_first_not_of('-');
+    return start == std::string_view::npos ? std::string_view() : flag.substr(start);
 }
 
 } // namespace todolist
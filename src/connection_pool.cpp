@@ -0,0 +1,112 @@
+#include "todolist/connection_pool.h"
+#include "todolist/exceptions.h"
+
+namespace todolist {
+
+ConnectionPool::ConnectionPool(const std::string& db_path, size_t read_connections,
+                               const DatabaseOptions& options)
+{
+    if (db_path.empty() || db_path == ":memory:") {
+        throw ValidationException("A connection pool needs a database file, not an in-memory database");
+    }
+    if (read_connections == 0) {
+        throw ValidationException("A connection pool needs at least one read connection");
+    }
+
+    // The writer creates the schema and switches the file to WAL before
+    // any reader opens it
+    DatabaseOptions writer_options = options;
+    writer_options.journal_mode = "WAL";
+    writer_options.read_only = false;
+
+    writer_ = std::make_unique<Connection>();
+    writer_->database = std::make_unique<Database>(db_path, writer_options);
+    writer_->repository = std::make_unique<TodoRepository>(*writer_->database);
+
+    DatabaseOptions reader_options = writer_options;
+    reader_options.read_only = true;
+
+    readers_.reserve(read_connections);
+    for (size_t i = 0; i < read_connections; ++i) {
+        auto reader = std::make_unique<Connection>();
+        reader->database = std::make_unique<Database>(db_path, reader_options);
+        reader->repository = std::make_unique<TodoRepository>(*reader->database);
+        readers_.push_back(std::move(reader));
+    }
+}
+
+ConnectionPool::~ConnectionPool() = default;
+
+ConnectionPool::Lease ConnectionPool::acquireReader() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    Connection* free_reader = nullptr;
+
+    available_.wait(lock, [this, &free_reader] {
+        for (auto& reader : readers_) {
+            if (!reader->in_use) {
+                free_reader = reader.get();
+                return true;
+            }
+        }
+        return false;
+    });
+
+    free_reader->in_use = true;
+    return Lease(this, free_reader);
+}
+
+ConnectionPool::Lease ConnectionPool::acquireWriter() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    available_.wait(lock, [this] { return !writer_->in_use; });
+
+    writer_->in_use = true;
+    return Lease(this, writer_.get());
+}
+
+void ConnectionPool::release(Connection* connection) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        connection->in_use = false;
+    }
+    // Readers and the writer wait on the same condition
+    available_.notify_all();
+}
+
+ConnectionPool::Lease::Lease(ConnectionPool* pool, Connection* connection)
+    : pool_(pool)
+    , connection_(connection)
+{
+}
+
+ConnectionPool::Lease::~Lease() {
+    release();
+}
+
+ConnectionPool::Lease::Lease(Lease&& other) noexcept
+    : pool_(other.pool_)
+    , connection_(other.connection_)
+{
+    other.pool_ = nullptr;
+    other.connection_ = nullptr;
+}
+
+ConnectionPool::Lease& ConnectionPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        release();
+        pool_ = other.pool_;
+        connection_ = other.connection_;
+        other.pool_ = nullptr;
+        other.connection_ = nullptr;
+    }
+    return *this;
+}
+
+void ConnectionPool::Lease::release() {
+    if (connection_) {
+        pool_->release(connection_);
+        pool_ = nullptr;
+        connection_ = nullptr;
+    }
+}
+
+} // namespace todolist
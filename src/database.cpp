@@ -1,13 +1,166 @@
 #include "todolist/database.h"
+#include "todolist/exceptions.h"
+#include "todolist/migrations.h"
 #include <sqlite3.h>
 #include <sstream>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <initializer_list>
 
 namespace todolist {
 
-Database::Database(const std::string& db_path)
+namespace {
+
+/**
+ * @brief Names of the settings in DatabaseOptions, as used by set()
+ */
+const char* const kOptionNames[] = {
+    "journal_mode", "synchronous", "mmap_size", "cache_size",
+    "temp_store", "busy_timeout", "page_size"
+};
+
+std::string toUpper(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    return text;
+}
+
+/**
+ * @brief Check a value against the keywords a PRAGMA accepts
+ * @return The value in upper case, safe to splice into a PRAGMA statement
+ * @throws ValidationException if the value is not one of the choices
+ */
+std::string checkChoice(const char* option, const std::string& value,
+                        std::initializer_list<const char*> choices) {
+    std::string upper = toUpper(value);
+    for (const char* choice : choices) {
+        if (upper == choice) {
+            return upper;
+        }
+    }
+    throw ValidationException("Invalid " + std::string(option) + ": " + value);
+}
+
+long long parseInteger(const char* option, const std::string& value, long long min, long long max) {
+    char* end = nullptr;
+    errno = 0;
+    long long number = std::strtoll(value.c_str(), &end, 10);
+    if (value.empty() || *end != '\0' || errno == ERANGE || number < min || number > max) {
+        throw ValidationException("Invalid " + std::string(option) + ": " + value);
+    }
+    return number;
+}
+
+std::string checkJournalMode(const std::string& value) {
+    return checkChoice("journal_mode", value, {"DELETE", "TRUNCATE", "PERSIST", "MEMORY", "WAL", "OFF"});
+}
+
+std::string checkSynchronous(const std::string& value) {
+    return checkChoice("synchronous", value, {"OFF", "NORMAL", "FULL", "EXTRA"});
+}
+
+std::string checkTempStore(const std::string& value) {
+    return checkChoice("temp_store", value, {"DEFAULT", "FILE", "MEMORY"});
+}
+
+} // anonymous namespace
+
+DatabaseOptions DatabaseOptions::fromEnvironment() {
+    DatabaseOptions options;
+    for (const char* name : kOptionNames) {
+        const char* value = std::getenv(("TODOLIST_" + toUpper(name)).c_str());
+        if (value != nullptr) {
+            options.set(name, value);
+        }
+    }
+    return options;
+}
+
+bool DatabaseOptions::set(const std::string& name, const std::string& value) {
+    std::string key = name;
+    std::replace(key.begin(), key.end(), '-', '_');
+
+    if (key == "journal_mode") {
+        journal_mode = checkJournalMode(value);
+    } else if (key == "synchronous") {
+        synchronous = checkSynchronous(value);
+    } else if (key == "mmap_size") {
+        mmap_size = parseInteger("mmap_size", value, 0, INT64_MAX);
+    } else if (key == "cache_size") {
+        cache_size = static_cast<int>(parseInteger("cache_size", value, INT32_MIN, INT32_MAX));
+    } else if (key == "temp_store") {
+        temp_store = checkTempStore(value);
+    } else if (key == "busy_timeout") {
+        busy_timeout = static_cast<int>(parseInteger("busy_timeout", value, 0, INT32_MAX));
+    } else if (key == "page_size") {
+        long long size = parseInteger("page_size", value, 512, 65536);
+        if ((size & (size - 1)) != 0) {
+            throw ValidationException("Invalid page_size: " + value + " (must be a power of two)");
+        }
+        page_size = static_cast<int>(size);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+Statement::Statement(sqlite3_stmt* stmt, bool* in_use)
+    : stmt_(stmt)
+    , in_use_(in_use)
+{
+}
+
+Statement::~Statement() {
+    release();
+}
+
+Statement::Statement(Statement&& other) noexcept
+    : stmt_(other.stmt_)
+    , in_use_(other.in_use_)
+{
+    other.stmt_ = nullptr;
+    other.in_use_ = nullptr;
+}
+
+Statement& Statement::operator=(Statement&& other) noexcept {
+    if (this != &other) {
+        release();
+        stmt_ = other.stmt_;
+        in_use_ = other.in_use_;
+        other.stmt_ = nullptr;
+        other.in_use_ = nullptr;
+    }
+    return *this;
+}
+
+void Statement::release() {
+    if (!stmt_) {
+        return;
+    }
+
+    if (in_use_) {
+        // Return the statement to the cache in a clean state
+        sqlite3_reset(stmt_);
+        sqlite3_clear_bindings(stmt_);
+        *in_use_ = false;
+    } else {
+        sqlite3_finalize(stmt_);
+    }
+
+    stmt_ = nullptr;
+    in_use_ = nullptr;
+}
+
+Database::Database(const std::string& db_path, const DatabaseOptions& options)
     : db_(nullptr)
+    , options_(options)
 {
-    int result = sqlite3_open(db_path.c_str(), &db_);
+    int flags = SQLITE_OPEN_NOMUTEX |
+                (options.read_only ? SQLITE_OPEN_READONLY : SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE);
+    int result = sqlite3_open_v2(db_path.c_str(), &db_, flags, nullptr);
 
     if (result != SQLITE_OK) {
         std::string error_msg = "Failed to open database: ";
@@ -21,40 +174,55 @@ Database::Database(const std::string& db_path)
         throw DatabaseException(error_msg);
     }
 
-    // Initialize schema (create tables if needed)
+    // Apply connection settings, then initialize schema (create tables if needed)
     try {
-        initializeSchema();
+        configure(options);
+        if (!options.read_only) {
+            initializeSchema();
+        }
     } catch (...) {
-        sqlite3_close(db_);
-        db_ = nullptr;
+        close();
         throw;
     }
 }
 
 Database::~Database() {
-    if (db_) {
-        sqlite3_close(db_);
-        db_ = nullptr;
-    }
+    close();
 }
 
 Database::Database(Database&& other) noexcept
     : db_(other.db_)
+    , options_(std::move(other.options_))
+    , statement_cache_(std::move(other.statement_cache_))
 {
     other.db_ = nullptr;
+    other.statement_cache_.clear();
 }
 
 Database& Database::operator=(Database&& other) noexcept {
     if (this != &other) {
-        if (db_) {
-            sqlite3_close(db_);
-        }
+        close();
         db_ = other.db_;
+        options_ = std::move(other.options_);
+        statement_cache_ = std::move(other.statement_cache_);
         other.db_ = nullptr;
+        other.statement_cache_.clear();
     }
     return *this;
 }
 
+void Database::close() {
+    for (auto& entry : statement_cache_) {
+        sqlite3_finalize(entry.second.stmt);
+    }
+    statement_cache_.clear();
+
+    if (db_) {
+        sqlite3_close(db_);
+        db_ = nullptr;
+    }
+}
+
 void Database::execute(const std::string& sql) {
     if (!db_) {
         throw DatabaseException("Database is not open");
@@ -75,6 +243,90 @@ void Database::execute(const std::string& sql) {
     }
 }
 
+Statement Database::prepare(std::string_view sql) {
+    if (!db_) {
+        throw DatabaseException("Database is not open");
+    }
+
+    auto it = statement_cache_.find(sql);
+    if (it != statement_cache_.end() && !it->second.in_use) {
+        it->second.in_use = true;
+        return Statement(it->second.stmt, &it->second.in_use);
+    }
+
+    // Either not cached yet, or the cached copy is still in use by an
+    // outer caller (e.g. a nested query); compile a new statement.
+    unsigned int flags = it == statement_cache_.end() ? SQLITE_PREPARE_PERSISTENT : 0;
+    sqlite3_stmt* stmt = nullptr;
+    int result = sqlite3_prepare_v3(db_, sql.data(), static_cast<int>(sql.size()),
+                                    flags, &stmt, nullptr);
+
+    if (result != SQLITE_OK) {
+        throw DatabaseException("Failed to prepare statement: " + getLastError());
+    }
+
+    if (it != statement_cache_.end()) {
+        return Statement(stmt, nullptr);
+    }
+
+    auto inserted = statement_cache_.emplace(std::string(sql), CachedStatement{stmt, true});
+    return Statement(stmt, &inserted.first->second.in_use);
+}
+
+void Database::clearStatementCache() {
+    for (auto it = statement_cache_.begin(); it != statement_cache_.end();) {
+        if (it->second.in_use) {
+            ++it;
+            continue;
+        }
+        sqlite3_finalize(it->second.stmt);
+        it = statement_cache_.erase(it);
+    }
+}
+
+std::string Database::pragma(const std::string& name) {
+    Statement stmt = prepare("PRAGMA " + name);
+
+    if (sqlite3_step(stmt.get()) != SQLITE_ROW) {
+        throw DatabaseException("Failed to read PRAGMA " + name + ": " + getLastError());
+    }
+
+    const unsigned char* value = sqlite3_column_text(stmt.get(), 0);
+    return value ? reinterpret_cast<const char*>(value) : "";
+}
+
+void Database::configure(const DatabaseOptions& options) {
+    // Set first so that switching the journal mode waits for other connections
+    sqlite3_busy_timeout(db_, options.busy_timeout);
+
+    // Closing the last connection would otherwise checkpoint the WAL and
+    // rewrite the database file even after read-only commands, making
+    // snapshot files look stale. Commits still checkpoint automatically,
+    // so the WAL stays bounded.
+    sqlite3_db_config(db_, SQLITE_DBCONFIG_NO_CKPT_ON_CLOSE, 1, nullptr);
+
+    // Values are validated (or are integers) before being spliced into the
+    // PRAGMA text, since PRAGMA arguments cannot be bound as parameters
+    // The page size and journal mode are properties of the file, so
+    // read-only connections use whatever the writer chose
+    std::ostringstream sql;
+    if (!options.read_only) {
+        sql << "PRAGMA page_size = " << options.page_size << ";"
+            << "PRAGMA journal_mode = " << checkJournalMode(options.journal_mode) << ";";
+    }
+    sql << "PRAGMA synchronous = " << checkSynchronous(options.synchronous) << ";"
+        << "PRAGMA cache_size = " << options.cache_size << ";"
+        << "PRAGMA mmap_size = " << options.mmap_size << ";"
+        << "PRAGMA temp_store = " << checkTempStore(options.temp_store) << ";";
+
+    execute(sql.str());
+}
+
+std::string Database::getPath() const {
+    const char* path = db_ ? sqlite3_db_filename(db_, "main") : nullptr;
+    return path ? path : "";
+}
+
 std::string Database::getLastError() const {
     if (!db_) {
         return "Database is not open";
@@ -83,25 +335,105 @@ std::string Database::getLastError() const {
 }
 
 void Database::initializeSchema() {
-    const char* create_table_sql = R"(
-        CREATE TABLE IF NOT EXISTS todos (
-            id INTEGER PRIMARY KEY AUTOINCREMENT,
-            title TEXT NOT NULL,
-            description TEXT,
-            completed INTEGER DEFAULT 0,
-            created_at INTEGER NOT NULL
-        );
-    )";
-
-    execute(create_table_sql);
-
-    // Create an index on completed status for faster filtering
-    const char* create_index_sql = R"(
-        CREATE INDEX IF NOT EXISTS idx_todos_completed
-        ON todos(completed);
-    )";
-
-    execute(create_index_sql);
+    // Steady state: the schema is current and opening costs one PRAGMA read
+    int version = schemaVersion();
+    if (version == latestSchemaVersion()) {
+        return;
+    }
+    if (version > latestSchemaVersion()) {
+        throw DatabaseException("Database schema version " + std::to_string(version) +
+                                " is newer than this build supports (" +
+                                std::to_string(latestSchemaVersion()) + ")");
+    }
+
+    runMigrations(*this);
+}
+
+int Database::schemaVersion() {
+    Statement stmt = prepare("PRAGMA user_version");
+    if (sqlite3_step(stmt.get()) != SQLITE_ROW) {
+        throw DatabaseException("Failed to read schema version: " + getLastError());
+    }
+    return sqlite3_column_int(stmt.get(), 0);
+}
+
+bool Database::tableExists(const char* name) {
+    Statement stmt = prepare("SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = ?");
+    sqlite3_bind_text(stmt.get(), 1, name, -1, SQLITE_STATIC);
+    return sqlite3_step(stmt.get()) == SQLITE_ROW;
+}
+
+Transaction::Transaction(Database& database, TransactionMode mode)
+    : database_(database)
+    , finished_(false)
+{
+    switch (mode) {
+        case TransactionMode::DEFERRED:  database_.execute("BEGIN DEFERRED"); break;
+        case TransactionMode::IMMEDIATE: database_.execute("BEGIN IMMEDIATE"); break;
+        case TransactionMode::EXCLUSIVE: database_.execute("BEGIN EXCLUSIVE"); break;
+    }
+}
+
+Transaction::~Transaction() {
+    rollback();
+}
+
+void Transaction::commit() {
+    if (finished_) {
+        throw DatabaseException("Transaction is no longer active");
+    }
+    database_.execute("COMMIT");
+    finished_ = true;
+}
+
+void Transaction::rollback() {
+    if (finished_) {
+        return;
+    }
+    finished_ = true;
+
+    // Some errors (e.g. SQLITE_FULL) make SQLite roll back by itself
+    if (!sqlite3_get_autocommit(database_.getHandle())) {
+        sqlite3_exec(database_.getHandle(), "ROLLBACK", nullptr, nullptr, nullptr);
+    }
+}
+
+bool Transaction::isActive() const {
+    return !finished_ && !sqlite3_get_autocommit(database_.getHandle());
+}
+
+// Savepoints nest strictly, so one name suffices: SQLite resolves RELEASE
+// and ROLLBACK TO against the innermost savepoint with that name.
+Savepoint::Savepoint(Database& database)
+    : database_(database)
+    , finished_(false)
+{
+    database_.execute("SAVEPOINT todolist_savepoint");
+}
+
+Savepoint::~Savepoint() {
+    rollback();
+}
+
+void Savepoint::release() {
+    if (finished_) {
+        throw DatabaseException("Savepoint is no longer active");
+    }
+    database_.execute("RELEASE todolist_savepoint");
+    finished_ = true;
+}
+
+void Savepoint::rollback() {
+    if (finished_) {
+        return;
+    }
+    finished_ = true;
+
+    if (!sqlite3_get_autocommit(database_.getHandle())) {
+        sqlite3_exec(database_.getHandle(),
+                     "ROLLBACK TO todolist_savepoint; RELEASE todolist_savepoint",
+                     nullptr, nullptr, nullptr);
+    }
 }
 
 } // namespace todolist
@@ -0,0 +1,316 @@
+#include "todolist/exporter.h"
+#include "todolist/buffered_writer.h"
+#include "todolist/exceptions.h"
+#include "todolist/json_escape.h"
+#include <sqlite3.h>
+#include <algorithm>
+#include <charconv>
+#include <condition_variable>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace todolist {
+
+namespace {
+
+/// Rows of one id range, in rowid order (a range scan of the table b-tree)
+constexpr const char* kRangeSql =
+    "SELECT id, title, description, completed, created_at FROM todos WHERE id BETWEEN ?1 AND ?2 ORDER BY id";
+
+constexpr const char* kCsvHeader = "id,title,description,completed,created_at\r\n";
+
+/// Ids per block in parallel exports
+constexpr sqlite3_int64 kBlockIds = 4096;
+
+/// Blocks each thread may run ahead of the writer in parallel exports
+constexpr size_t kBlocksPerThread = 2;
+
+template <typename Sink>
+void appendInteger(Sink& out, long long value) {
+    char digits[24];
+    char* end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+    out.append(digits, static_cast<size_t>(end - digits));
+}
+
+/**
+ * @brief Append a CSV field, quoting it only if it contains a separator,
+ * quote or line break
+ */
+template <typename Sink>
+void appendCsvField(Sink& out, const char* text, size_t size) {
+    const char* end = text + size;
+    bool needsQuotes = std::any_of(text, end, [](char c) {
+        return c == ',' || c == '"' || c == '\n' || c == '\r';
+    });
+    if (!needsQuotes) {
+        out.append(text, size);
+        return;
+    }
+
+    out.push_back('"');
+    const char* run = text;
+    for (const char* p = text; p != end; ++p) {
+        if (*p == '"') {
+            out.append(run, static_cast<size_t>(p + 1 - run));
+            out.push_back('"');
+            run = p + 1;
+        }
+    }
+    out.append(run, static_cast<size_t>(end - run));
+    out.push_back('"');
+}
+
+/**
+ * @brief Get a text column without copying it
+ */
+std::pair<const char*, size_t> columnText(sqlite3_stmt* stmt, int column) {
+    const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, column));
+    if (!text) {
+        return {"", 0};
+    }
+    return {text, static_cast<size_t>(sqlite3_column_bytes(stmt, column))};
+}
+
+/**
+ * @brief Append the current row of a kRangeSql statement
+ */
+template <typename Sink>
+void appendRow(Sink& out, sqlite3_stmt* stmt, ExportFormat format) {
+    auto title = columnText(stmt, 1);
+    auto description = columnText(stmt, 2);
+    bool completed = sqlite3_column_int(stmt, 3) != 0;
+
+    if (format == ExportFormat::JSONL) {
+        out.append("{\"id\":", 6);
+        appendInteger(out, sqlite3_column_int64(stmt, 0));
+        out.append(",\"title\":", 9);
+        appendJsonString(out, std::string_view(title.first, title.second));
+        out.append(",\"description\":", 15);
+        appendJsonString(out, std::string_view(description.first, description.second));
+        if (completed) {
+            out.append(",\"completed\":true,\"created_at\":", 31);
+        } else {
+            out.append(",\"completed\":false,\"created_at\":", 32);
+        }
+        appendInteger(out, sqlite3_column_int64(stmt, 4));
+        out.append("}\n", 2);
+    } else {
+        appendInteger(out, sqlite3_column_int64(stmt, 0));
+        out.push_back(',');
+        appendCsvField(out, title.first, title.second);
+        out.push_back(',');
+        appendCsvField(out, description.first, description.second);
+        out.append(completed ? ",1," : ",0,", 3);
+        appendInteger(out, sqlite3_column_int64(stmt, 4));
+        out.append("\r\n", 2);
+    }
+}
+
+/**
+ * @brief Append every row whose id is in [first, last]
+ * @return Number of rows appended
+ */
+template <typename Sink>
+size_t appendRange(Sink& out, Database& database, sqlite3_int64 first, sqlite3_int64 last, ExportFormat format) {
+    Statement statement = database.prepare(kRangeSql);
+    sqlite3_stmt* stmt = statement.get();
+    sqlite3_bind_int64(stmt, 1, first);
+    sqlite3_bind_int64(stmt, 2, last);
+
+    size_t rows = 0;
+    int result;
+    while ((result = sqlite3_step(stmt)) == SQLITE_ROW) {
+        appendRow(out, stmt, format);
+        ++rows;
+    }
+
+    if (result != SQLITE_DONE) {
+        throw DatabaseException("Error exporting todo items: " + database.getLastError());
+    }
+    return rows;
+}
+
+} // anonymous namespace
+
+ExportFormat parseExportFormat(const std::string& name) {
+    if (name == "jsonl") {
+        return ExportFormat::JSONL;
+    }
+    if (name == "csv") {
+        return ExportFormat::CSV;
+    }
+    throw ValidationException("Invalid export format: " + name + " (use jsonl or csv)");
+}
+
+Exporter::Exporter(Database& database, ExportFormat format)
+    : database_(database)
+    , format_(format) {
+}
+
+size_t Exporter::exportTo(std::ostream& out) {
+    Transaction snapshot(database_);
+
+    BufferedWriter writer(out);
+    if (format_ == ExportFormat::CSV) {
+        writer.append(kCsvHeader);
+    }
+    size_t rows = appendRange(writer, database_, std::numeric_limits<sqlite3_int64>::min(),
+                              std::numeric_limits<sqlite3_int64>::max(), format_);
+    writer.flush();
+
+    snapshot.commit();
+    return rows;
+}
+
+size_t Exporter::exportParallel(const std::string& db_path, size_t threads, std::ostream& out) {
+    if (threads <= 1 || db_path.empty() || db_path == ":memory:") {
+        return exportTo(out);
+    }
+
+    sqlite3_int64 first = 0;
+    sqlite3_int64 last = 0;
+    bool empty = true;
+    {
+        Statement bounds = database_.prepare("SELECT min(id), max(id) FROM todos");
+        if (sqlite3_step(bounds.get()) == SQLITE_ROW && sqlite3_column_type(bounds.get(), 0) != SQLITE_NULL) {
+            first = sqlite3_column_int64(bounds.get(), 0);
+            last = sqlite3_column_int64(bounds.get(), 1);
+            empty = false;
+        }
+    }
+    if (empty) {
+        return exportTo(out);
+    }
+
+    const size_t blocks = static_cast<size_t>((last - first) / kBlockIds) + 1;
+    threads = std::min(threads, blocks);
+    const size_t window = threads * kBlocksPerThread;
+
+    // Output of one block, handed from a reader thread to the writer.
+    // Block b uses slot b % window, which is free once block b - window
+    // has been written.
+    struct Slot {
+        std::string data;
+        size_t rows = 0;
+        bool ready = false;
+    };
+    std::vector<Slot> slots(window);
+    std::mutex mutex;
+    std::condition_variable changed;
+    size_t next_block = 0;
+    size_t written = 0;
+    bool stopping = false;
+    std::exception_ptr error;
+
+    auto read = [&] {
+        try {
+            DatabaseOptions options = database_.getOptions();
+            options.read_only = true;
+            Database reader(db_path, options);
+            std::string buffer;
+
+            while (true) {
+                size_t block;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    changed.wait(lock, [&] {
+                        return stopping || next_block >= blocks || next_block < written + window;
+                    });
+                    if (stopping || next_block >= blocks) {
+                        return;
+                    }
+                    block = next_block++;
+                }
+
+                sqlite3_int64 low = first + static_cast<sqlite3_int64>(block) * kBlockIds;
+                sqlite3_int64 high = std::min(last, low + (kBlockIds - 1));
+                buffer.clear();
+                size_t rows = appendRange(buffer, reader, low, high, format_);
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    Slot& slot = slots[block % window];
+                    slot.data.swap(buffer);
+                    slot.rows = rows;
+                    slot.ready = true;
+                }
+                changed.notify_all();
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+            stopping = true;
+            changed.notify_all();
+        }
+    };
+
+    std::vector<std::thread> readers;
+    auto stop = [&] {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        changed.notify_all();
+        for (auto& thread : readers) {
+            thread.join();
+        }
+    };
+
+    BufferedWriter writer(out);
+    size_t rows = 0;
+    try {
+        for (size_t i = 0; i < threads; ++i) {
+            readers.emplace_back(read);
+        }
+        if (format_ == ExportFormat::CSV) {
+            writer.append(kCsvHeader);
+        }
+
+        std::string data;
+        for (size_t block = 0; block < blocks; ++block) {
+            Slot& slot = slots[block % window];
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&] { return stopping || slot.ready; });
+                if (!slot.ready) {
+                    break;
+                }
+                data.swap(slot.data);
+                rows += slot.rows;
+                slot.ready = false;
+            }
+
+            writer.append(data);
+
+            // Hand the drained buffer back so its capacity is reused
+            data.clear();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                slot.data.swap(data);
+                ++written;
+            }
+            changed.notify_all();
+        }
+    } catch (...) {
+        stop();
+        throw;
+    }
+    stop();
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    writer.flush();
+    return rows;
+}
+
+} // namespace todolist
@@ -1,124 +1,462 @@
 #include "todolist/formatter.h"
-#include <sstream>
-#include <iomanip>
+#include "todolist/buffered_writer.h"
+#include "todolist/timestamp_formatter.h"
 #include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <ctime>
 
 namespace todolist {
 
-Formatter::Formatter(bool useColor)
-    : useColor_(useColor) {
+namespace {
+
+/**
+ * @brief Color policies for the formatting templates
+ *
+ * With NoColor the escape codes are compiled out rather than appended
+ * as empty strings.
+ */
+struct AnsiColor {
+    static constexpr bool kEnabled = true;
+};
+
+struct NoColor {
+    static constexpr bool kEnabled = false;
+};
+
+/**
+ * @brief Call fn with the color policy matching useColor
+ */
+template <typename Fn>
+void withColorPolicy(bool useColor, Fn&& fn) {
+    if (useColor) {
+        fn(AnsiColor{});
+    } else {
+        fn(NoColor{});
+    }
 }
 
-std::string Formatter::formatTodoItem(const TodoItem& item, bool showDescription) const {
-    std::ostringstream oss;
+template <typename Sink>
+void appendText(Sink& out, std::string_view text) {
+    out.append(text.data(), text.size());
+}
+
+template <typename Sink>
+void appendNumber(Sink& out, size_t value) {
+    char digits[24];
+    char* end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+    out.append(digits, static_cast<size_t>(end - digits));
+}
+
+template <typename ColorPolicy, typename Sink>
+void appendColor(Sink& out, const char* color) {
+    if constexpr (ColorPolicy::kEnabled) {
+        out.append(color, std::strlen(color));
+    }
+}
+
+template <typename ColorPolicy, typename Sink>
+void appendColoredText(Sink& out, std::string_view text, const char* color) {
+    appendColor<ColorPolicy>(out, color);
+    appendText(out, text);
+    appendColor<ColorPolicy>(out, Color::RESET);
+}
+
+template <typename ColorPolicy, typename Sink>
+void appendHeaderText(Sink& out, std::string_view title) {
+    appendColor<ColorPolicy>(out, Color::BOLD);
+    appendColoredText<ColorPolicy>(out, title, Color::BRIGHT_CYAN);
+}
+
+template <typename Sink>
+void appendRule(Sink& out, size_t length = 80, char character = '-') {
+    for (size_t i = 0; i < length; ++i) {
+        out.push_back(character);
+    }
+}
+
+/**
+ * @brief Append a message with a colored prefix, e.g. "✓ " in green
+ */
+template <typename ColorPolicy, typename Sink>
+void appendMessage(Sink& out, const char* color, std::string_view prefix, std::string_view message) {
+    appendColor<ColorPolicy>(out, color);
+    appendText(out, prefix);
+    appendText(out, message);
+    appendColor<ColorPolicy>(out, Color::RESET);
+}
 
+/// Items whose timestamps appendList formats in one batch
+constexpr size_t kTimestampBatch = 64;
+
+template <typename ColorPolicy, typename Sink>
+void appendItem(Sink& out, const TodoItemView& item, bool showDescription, std::string_view created) {
     // ID and status indicator
-    oss << applyColor(Color::DIM) << "[" << item.getId() << "]" << applyColor(Color::RESET);
-    oss << " ";
+    char id[16];
+    char* idEnd = std::to_chars(id, id + sizeof(id), item.getId()).ptr;
+    appendColor<ColorPolicy>(out, Color::DIM);
+    out.push_back('[');
+    out.append(id, static_cast<size_t>(idEnd - id));
+    out.push_back(']');
+    appendColor<ColorPolicy>(out, Color::RESET);
+    out.push_back(' ');
 
     // Checkbox with color
     if (item.isCompleted()) {
-        oss << applyColor(Color::BRIGHT_GREEN) << "[✓]" << applyColor(Color::RESET);
+        appendColoredText<ColorPolicy>(out, "[✓]", Color::BRIGHT_GREEN);
     } else {
-        oss << applyColor(Color::YELLOW) << "[ ]" << applyColor(Color::RESET);
+        appendColoredText<ColorPolicy>(out, "[ ]", Color::YELLOW);
     }
-    oss << " ";
+    out.push_back(' ');
 
     // Title with strikethrough effect for completed items
-    if (item.isCompleted()) {
-        oss << applyColor(Color::DIM) << item.getTitle() << applyColor(Color::RESET);
-    } else {
-        oss << applyColor(Color::BOLD) << item.getTitle() << applyColor(Color::RESET);
-    }
+    appendColoredText<ColorPolicy>(out, item.getTitle(), item.isCompleted() ? Color::DIM : Color::BOLD);
 
     // Description if requested and available
     if (showDescription && !item.getDescription().empty()) {
-        oss << "\n    " << applyColor(Color::DIM) << item.getDescription() << applyColor(Color::RESET);
+        appendText(out, "\n    ");
+        appendColoredText<ColorPolicy>(out, item.getDescription(), Color::DIM);
     }
 
     // Created timestamp
-    oss << "\n    " << applyColor(Color::DIM) << "Created: " << item.getFormattedCreatedAt() << applyColor(Color::RESET);
+    appendText(out, "\n    ");
+    appendColor<ColorPolicy>(out, Color::DIM);
+    appendText(out, "Created: ");
+    appendText(out, created);
+    appendColor<ColorPolicy>(out, Color::RESET);
+}
 
-    return oss.str();
+template <typename ColorPolicy, typename Sink>
+void appendItem(Sink& out, const TodoItemView& item, bool showDescription) {
+    char created[TodoItem::kFormattedTimeSize];
+    appendItem<ColorPolicy>(out, item, showDescription, std::string_view(created, item.formatCreatedAt(created)));
 }
 
-std::string Formatter::formatTodoList(const std::vector<TodoItem>& items, bool showDescription) const {
-    if (items.empty()) {
-        return formatInfo("No todo items found.");
-    }
+template <typename ColorPolicy, typename Sink>
+void appendListHeader(Sink& out, size_t total, size_t completed) {
+    appendHeaderText<ColorPolicy>(out, "Todo Items");
+    out.push_back('\n');
+    appendRule(out);
+    appendText(out, "\n\n");
+
+    size_t pending = total - completed;
+
+    appendColor<ColorPolicy>(out, Color::BRIGHT_BLUE);
+    appendText(out, "ℹ Total: ");
+    appendNumber(out, total);
+    appendText(out, " items");
+    appendColor<ColorPolicy>(out, Color::RESET);
+    appendText(out, " | ");
+    appendColor<ColorPolicy>(out, Color::YELLOW);
+    appendNumber(out, pending);
+    appendText(out, " pending");
+    appendColor<ColorPolicy>(out, Color::RESET);
+    appendText(out, " | ");
+    appendColor<ColorPolicy>(out, Color::BRIGHT_GREEN);
+    appendNumber(out, completed);
+    appendText(out, " completed");
+    appendColor<ColorPolicy>(out, Color::RESET);
+    appendText(out, "\n\n");
+}
 
-    std::ostringstream oss;
+/**
+ * @brief Append list items, each followed by a blank line, formatting their
+ * timestamps in batches
+ */
+template <typename ColorPolicy, typename Sink>
+void appendItems(Sink& out, const std::vector<TodoItem>& items, bool showDescription) {
+    std::time_t times[kTimestampBatch];
+    TimestampFormatter::Text created[kTimestampBatch];
+    TimestampFormatter& timestamps = TimestampFormatter::forThread();
+    for (size_t first = 0; first < items.size(); first += kTimestampBatch) {
+        size_t count = std::min(kTimestampBatch, items.size() - first);
+        for (size_t i = 0; i < count; ++i) {
+            times[i] = items[first + i].getCreatedAtUnix();
+        }
+        timestamps.formatBatch(times, count, created);
 
-    // Header
-    oss << formatHeader("Todo Items") << "\n";
-    oss << separator() << "\n\n";
+        for (size_t i = 0; i < count; ++i) {
+            appendItem<ColorPolicy>(out, items[first + i], showDescription, created[i].view());
+            appendText(out, "\n\n");
+        }
+    }
+}
+
+template <typename ColorPolicy, typename Sink>
+void appendList(Sink& out, const std::vector<TodoItem>& items, bool showDescription) {
+    if (items.empty()) {
+        appendMessage<ColorPolicy>(out, Color::BRIGHT_BLUE, "ℹ ", "No todo items found.");
+        return;
+    }
 
-    // Count statistics
     size_t completed = std::count_if(items.begin(), items.end(),
                                       [](const TodoItem& item) { return item.isCompleted(); });
-    size_t pending = items.size() - completed;
-
-    oss << formatInfo("Total: " + std::to_string(items.size()) + " items");
-    oss << " | ";
-    oss << colorize(std::to_string(pending) + " pending", Color::YELLOW);
-    oss << " | ";
-    oss << colorize(std::to_string(completed) + " completed", Color::BRIGHT_GREEN);
-    oss << "\n\n";
-
-    // Items
-    for (const auto& item : items) {
-        oss << formatTodoItem(item, showDescription);
-        oss << "\n\n";
-    }
 
-    oss << separator();
+    appendListHeader<ColorPolicy>(out, items.size(), completed);
+    appendItems<ColorPolicy>(out, items, showDescription);
+    appendRule(out);
+}
+
+template <typename ColorPolicy, typename Sink>
+void appendStatsBlock(Sink& out, size_t total, size_t completed) {
+    appendHeaderText<ColorPolicy>(out, "Todo Statistics");
+    out.push_back('\n');
+    appendRule(out);
+    out.push_back('\n');
 
-    return oss.str();
+    size_t pending = total - completed;
+    size_t percent = total == 0 ? 0 : completed * 100 / total;
+
+    appendText(out, "Total:     ");
+    appendNumber(out, total);
+    appendText(out, "\nPending:   ");
+    appendColor<ColorPolicy>(out, Color::YELLOW);
+    appendNumber(out, pending);
+    appendColor<ColorPolicy>(out, Color::RESET);
+    appendText(out, "\nCompleted: ");
+    appendColor<ColorPolicy>(out, Color::BRIGHT_GREEN);
+    appendNumber(out, completed);
+    appendColor<ColorPolicy>(out, Color::RESET);
+    appendText(out, " (");
+    appendNumber(out, percent);
+    appendText(out, "%)\n");
+    appendRule(out);
+}
+
+} // anonymous namespace
+
+Formatter::Formatter(bool useColor)
+    : useColor_(useColor) {
+}
+
+std::string Formatter::formatTodoItem(const TodoItem& item, bool showDescription) const {
+    std::string out;
+    appendTodoItem(out, item, showDescription);
+    return out;
+}
+
+template <typename Sink>
+void Formatter::appendTodoItem(Sink& out, const TodoItemView& item, bool showDescription) const {
+    withColorPolicy(useColor_, [&](auto policy) {
+        appendItem<decltype(policy)>(out, item, showDescription);
+    });
+}
+
+std::string Formatter::formatTodoList(const std::vector<TodoItem>& items, bool showDescription) const {
+    std::string out;
+    appendTodoList(out, items, showDescription);
+    return out;
+}
+
+template <typename Sink>
+void Formatter::appendTodoList(Sink& out, const std::vector<TodoItem>& items, bool showDescription) const {
+    withColorPolicy(useColor_, [&](auto policy) {
+        appendList<decltype(policy)>(out, items, showDescription);
+    });
+}
+
+std::string Formatter::formatTodoListHeader(size_t total, size_t completed) const {
+    std::string out;
+    appendTodoListHeader(out, total, completed);
+    return out;
+}
+
+template <typename Sink>
+void Formatter::appendTodoListHeader(Sink& out, size_t total, size_t completed) const {
+    withColorPolicy(useColor_, [&](auto policy) {
+        appendListHeader<decltype(policy)>(out, total, completed);
+    });
+}
+
+std::string Formatter::formatTodoListFooter() const {
+    return separator();
+}
+
+template <typename Sink>
+void Formatter::appendTodoListFooter(Sink& out) const {
+    appendSeparator(out);
+}
+
+std::string Formatter::formatStats(size_t total, size_t completed) const {
+    std::string out;
+    appendStats(out, total, completed);
+    return out;
+}
+
+template <typename Sink>
+void Formatter::appendStats(Sink& out, size_t total, size_t completed) const {
+    withColorPolicy(useColor_, [&](auto policy) {
+        appendStatsBlock<decltype(policy)>(out, total, completed);
+    });
 }
 
 std::string Formatter::formatSuccess(const std::string& message) const {
-    std::ostringstream oss;
-    oss << applyColor(Color::BRIGHT_GREEN) << "✓ " << message << applyColor(Color::RESET);
-    return oss.str();
+    std::string out;
+    appendSuccess(out, message);
+    return out;
+}
+
+template <typename Sink>
+void Formatter::appendSuccess(Sink& out, std::string_view message) const {
+    withColorPolicy(useColor_, [&](auto policy) {
+        appendMessage<decltype(policy)>(out, Color::BRIGHT_GREEN, "✓ ", message);
+    });
 }
 
 std::string Formatter::formatError(const std::string& message) const {
-    std::ostringstream oss;
-    oss << applyColor(Color::BRIGHT_RED) << "✗ Error: " << message << applyColor(Color::RESET);
-    return oss.str();
+    std::string out;
+    appendError(out, message);
+    return out;
+}
+
+template <typename Sink>
+void Formatter::appendError(Sink& out, std::string_view message) const {
+    withColorPolicy(useColor_, [&](auto policy) {
+        appendMessage<decltype(policy)>(out, Color::BRIGHT_RED, "✗ Error: ", message);
+    });
 }
 
 std::string Formatter::formatWarning(const std::string& message) const {
-    std::ostringstream oss;
-    oss << applyColor(Color::BRIGHT_YELLOW) << "⚠ Warning: " << message << applyColor(Color::RESET);
-    return oss.str();
+    std::string out;
+    appendWarning(out, message);
+    return out;
+}
+
+template <typename Sink>
+void Formatter::appendWarning(Sink& out, std::string_view message) const {
+    withColorPolicy(useColor_, [&](auto policy) {
+        appendMessage<decltype(policy)>(out, Color::BRIGHT_YELLOW, "⚠ Warning: ", message);
+    });
 }
 
 std::string Formatter::formatInfo(const std::string& message) const {
-    std::ostringstream oss;
-    oss << applyColor(Color::BRIGHT_BLUE) << "ℹ " << message << applyColor(Color::RESET);
-    return oss.str();
+    std::string out;
+    appendInfo(out, message);
+    return out;
+}
+
+template <typename Sink>
+void Formatter::appendInfo(Sink& out, std::string_view message) const {
+    withColorPolicy(useColor_, [&](auto policy) {
+        appendMessage<decltype(policy)>(out, Color::BRIGHT_BLUE, "ℹ ", message);
+    });
 }
 
 std::string Formatter::formatHeader(const std::string& title) const {
-    std::ostringstream oss;
-    oss << applyColor(Color::BOLD) << applyColor(Color::BRIGHT_CYAN) << title << applyColor(Color::RESET);
-    return oss.str();
+    std::string out;
+    appendHeader(out, title);
+    return out;
+}
+
+template <typename Sink>
+void Formatter::appendHeader(Sink& out, std::string_view title) const {
+    withColorPolicy(useColor_, [&](auto policy) {
+        appendHeaderText<decltype(policy)>(out, title);
+    });
 }
 
 std::string Formatter::colorize(const std::string& text, const char* color) const {
-    if (!useColor_) {
-        return text;
-    }
-    std::ostringstream oss;
-    oss << color << text << Color::RESET;
-    return oss.str();
+    std::string out;
+    appendColorized(out, text, color);
+    return out;
+}
+
+template <typename Sink>
+void Formatter::appendColorized(Sink& out, std::string_view text, const char* color) const {
+    withColorPolicy(useColor_, [&](auto policy) {
+        appendColoredText<decltype(policy)>(out, text, color);
+    });
 }
 
 std::string Formatter::separator(size_t length, char character) const {
     return std::string(length, character);
 }
 
+template <typename Sink>
+void Formatter::appendSeparator(Sink& out, size_t length, char character) const {
+    appendRule(out, length, character);
+}
+
+std::string Formatter::formatItemResult(const std::string& message, const TodoItem& item) const {
+    std::string out = formatSuccess(message);
+    out += "\n\n";
+    appendTodoItem(out, item, true);
+    return out;
+}
+
+std::string Formatter::formatBulkResult(const std::vector<std::string>& steps,
+                                        const std::string& summary, long long /*count*/) const {
+    std::string out;
+    for (const auto& step : steps) {
+        appendSuccess(out, step);
+        out.push_back('\n');
+    }
+    appendInfo(out, summary);
+    return out;
+}
+
+std::string Formatter::formatHelp(const std::string& title, const std::string& text) const {
+    if (title.empty()) {
+        return text;
+    }
+
+    std::string out;
+    appendHeader(out, title);
+    out.push_back('\n');
+    appendSeparator(out);
+    out += "\n\n";
+    out += text;
+    return out;
+}
+
+std::string Formatter::formatVersion(const std::string& version, const std::string& build) const {
+    std::string out;
+    appendHeader(out, "Todo List CLI");
+    out += "\nVersion: " + version + "\nBuild: " + build;
+    return out;
+}
+
+bool Formatter::isStructured() const {
+    return false;
+}
+
+void Formatter::beginList(BufferedWriter& out, size_t total, size_t completed, std::string_view query) const {
+    if (!query.empty()) {
+        appendHeader(out, "Search Results for: " + std::string(query));
+        out.push_back('\n');
+        appendSeparator(out);
+        out.append("\n\n", 2);
+    }
+    appendTodoListHeader(out, total, completed);
+}
+
+void Formatter::appendListItem(BufferedWriter& out, const TodoItemView& item) const {
+    appendTodoItem(out, item, false);
+    out.append("\n\n", 2);
+}
+
+void Formatter::appendListItems(BufferedWriter& out, const std::vector<TodoItem>& items) const {
+    withColorPolicy(useColor_, [&](auto policy) {
+        appendItems<decltype(policy)>(out, items, false);
+    });
+}
+
+void Formatter::endList(BufferedWriter& out, std::string_view next_cursor) const {
+    appendTodoListFooter(out);
+    if (!next_cursor.empty()) {
+        out.push_back('\n');
+        appendInfo(out, "More items available. Next page: --after " + std::string(next_cursor));
+    }
+}
+
+void Formatter::appendEmptyList(BufferedWriter& out, std::string_view query) const {
+    if (query.empty()) {
+        appendInfo(out, "No todo items found.");
+    } else {
+        appendInfo(out, "No todo items found matching: " + std::string(query));
+    }
+}
+
 void Formatter::setColorEnabled(bool enabled) {
     useColor_ = enabled;
 }
@@ -127,8 +465,25 @@ bool Formatter::isColorEnabled() const {
     return useColor_;
 }
 
-const char* Formatter::applyColor(const char* color) const {
-    return useColor_ ? color : "";
-}
+// The supported sinks
+#define TODOLIST_FORMATTER_SINK(Sink)                                                               \
+    template void Formatter::appendTodoItem(Sink&, const TodoItemView&, bool) const;                \
+    template void Formatter::appendTodoList(Sink&, const std::vector<TodoItem>&, bool) const;       \
+    template void Formatter::appendTodoListHeader(Sink&, size_t, size_t) const;                     \
+    template void Formatter::appendTodoListFooter(Sink&) const;                                     \
+    template void Formatter::appendStats(Sink&, size_t, size_t) const;                              \
+    template void Formatter::appendSuccess(Sink&, std::string_view) const;                          \
+    template void Formatter::appendError(Sink&, std::string_view) const;                            \
+    template void Formatter::appendWarning(Sink&, std::string_view) const;                          \
+    template void Formatter::appendInfo(Sink&, std::string_view) const;                             \
+    template void Formatter::appendHeader(Sink&, std::string_view) const;                           \
+    template void Formatter::appendColorized(Sink&, std::string_view, const char*) const;             \
+    template void Formatter::appendSeparator(Sink&, size_t, char) const;
+
+TODOLIST_FORMATTER_SINK(std::string)
+TODOLIST_FORMATTER_SINK(std::pmr::string)
+TODOLIST_FORMATTER_SINK(BufferedWriter)
+
+#undef TODOLIST_FORMATTER_SINK
 
 } // namespace todolist
@@ -0,0 +1,890 @@
+#include "todolist/importer.h"
+#include "todolist/exceptions.h"
+#include "todolist/migrations.h"
+#include <sqlite3.h>
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <filesystem>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <fstream>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace todolist {
+
+namespace {
+
+constexpr const char* kInsertSql =
+    "INSERT INTO todos (title, description, completed, created_at) VALUES (?, ?, ?, ?)";
+
+/**
+ * @brief A whole input file, memory-mapped where the platform allows
+ */
+class MappedInput {
+public:
+    /**
+     * @throws ValidationException if the file cannot be read
+     */
+    explicit MappedInput(const std::string& path) {
+#ifdef _WIN32
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            throw ValidationException("Cannot read import file: " + path);
+        }
+        buffer_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+#else
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw ValidationException("Cannot read import file: " + path);
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+            ::close(fd);
+            throw ValidationException("Cannot read import file: " + path);
+        }
+        size_ = static_cast<size_t>(info.st_size);
+        if (size_ > 0) {
+            void* mapped = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                ::close(fd);
+                throw ValidationException("Cannot map import file: " + path);
+            }
+            // Read once, front to back
+            ::madvise(mapped, size_, MADV_SEQUENTIAL);
+            data_ = static_cast<const char*>(mapped);
+        }
+        ::close(fd);
+#endif
+    }
+
+    ~MappedInput() {
+#ifndef _WIN32
+        if (data_) {
+            ::munmap(const_cast<char*>(data_), size_);
+        }
+#endif
+    }
+
+    MappedInput(const MappedInput&) = delete;
+    MappedInput& operator=(const MappedInput&) = delete;
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    std::vector<char> buffer_;
+#endif
+};
+
+/**
+ * @brief One parsed input row
+ *
+ * Text points into the input when it needed no unescaping, and into the
+ * scanner's scratch buffers otherwise; either way it stays valid until
+ * the next row is read.
+ */
+struct ImportRow {
+    std::string_view title;
+    std::string_view description;
+    bool completed = false;
+    bool has_created_at = false;
+    int64_t created_at = 0;
+};
+
+bool parseInteger(std::string_view text, int64_t& value) {
+    auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return !text.empty() && result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+/**
+ * @brief Input position and error reporting shared by the format scanners
+ */
+class Scanner {
+public:
+    /**
+     * @brief Byte offset of the next row
+     */
+    size_t position() const { return static_cast<size_t>(pos_ - begin_); }
+
+    /**
+     * @brief Line number of the next row
+     */
+    size_t line() const { return line_; }
+
+    /**
+     * @brief Continue from a checkpoint; positions before the current one are ignored
+     */
+    void seek(size_t position, size_t line) {
+        if (position > this->position()) {
+            pos_ = begin_ + position;
+            line_ = line;
+        }
+    }
+
+protected:
+    Scanner(const char* begin, const char* end, const char* format)
+        : begin_(begin)
+        , pos_(begin)
+        , end_(end)
+        , format_(format) {
+    }
+
+    /**
+     * @brief Reject the row being read
+     */
+    [[noreturn]] void fail(const std::string& message) const {
+        throw ValidationException("Invalid " + std::string(format_) + " at line " + std::to_string(row_line_) +
+                                  ": " + message);
+    }
+
+    const char* begin_;
+    const char* pos_;
+    const char* end_;
+    size_t line_ = 1;
+    size_t row_line_ = 1;  ///< Line the current row starts on
+
+private:
+    const char* format_;
+};
+
+/**
+ * @brief Reads JSON Lines rows
+ *
+ * A row is a JSON object on one line. Strings without escapes are returned
+ * in place; unknown keys are skipped without being decoded.
+ */
+class JsonLinesScanner : public Scanner {
+public:
+    JsonLinesScanner(const char* begin, const char* end)
+        : Scanner(begin, end, "JSON") {
+    }
+
+    /**
+     * @brief Read the next row
+     * @return false at the end of the input
+     */
+    bool next(ImportRow& row) {
+        while (true) {
+            skipSpace();
+            if (pos_ == end_) {
+                return false;
+            }
+            if (*pos_ != '\n') {
+                break;
+            }
+            ++pos_;
+            ++line_;
+        }
+        row_line_ = line_;
+
+        row = ImportRow();
+        expect('{');
+        skipSpace();
+        if (peek() != '}') {
+            while (true) {
+                std::string_view key = parseString(key_);
+                skipSpace();
+                expect(':');
+                skipSpace();
+
+                if (key == "title") {
+                    row.title = parseString(title_);
+                } else if (key == "description") {
+                    row.description = match("null") ? std::string_view() : parseString(description_);
+                } else if (key == "completed") {
+                    row.completed = parseCompleted();
+                } else if (key == "created_at") {
+                    row.created_at = parseIntegerValue("created_at");
+                    row.has_created_at = true;
+                } else {
+                    skipValue();
+                }
+
+                skipSpace();
+                if (peek() != ',') {
+                    break;
+                }
+                ++pos_;
+                skipSpace();
+            }
+        }
+        expect('}');
+        skipSpace();
+
+        if (row.title.empty()) {
+            fail("title is missing or empty");
+        }
+        if (pos_ != end_) {
+            if (*pos_ != '\n') {
+                fail("unexpected text after the object");
+            }
+            ++pos_;
+            ++line_;
+        }
+        return true;
+    }
+
+private:
+    /// The end of the input reads as the end of the line
+    char peek() const {
+        return pos_ != end_ ? *pos_ : '\n';
+    }
+
+    void skipSpace() {
+        while (pos_ != end_ && (*pos_ == ' ' || *pos_ == '\t' || *pos_ == '\r')) {
+            ++pos_;
+        }
+    }
+
+    void expect(char c) {
+        if (pos_ == end_ || *pos_ != c) {
+            fail(std::string("expected '") + c + "'");
+        }
+        ++pos_;
+    }
+
+    bool match(const char* literal) {
+        size_t size = std::strlen(literal);
+        if (static_cast<size_t>(end_ - pos_) >= size && std::memcmp(pos_, literal, size) == 0) {
+            pos_ += size;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Read a string, unescaping into scratch only if it has escapes
+     */
+    std::string_view parseString(std::string& scratch) {
+        expect('"');
+        const char* run = pos_;
+        bool escaped = false;
+
+        while (true) {
+            if (pos_ == end_) {
+                fail("unterminated string");
+            }
+            unsigned char c = static_cast<unsigned char>(*pos_);
+            if (c == '"') {
+                break;
+            }
+            if (c < 0x20) {
+                fail("unescaped control character in string");
+            }
+            if (c != '\\') {
+                ++pos_;
+                continue;
+            }
+            if (!escaped) {
+                scratch.clear();
+                escaped = true;
+            }
+            scratch.append(run, pos_);
+            ++pos_;
+            appendEscape(scratch);
+            run = pos_;
+        }
+
+        std::string_view text(run, static_cast<size_t>(pos_ - run));
+        if (escaped) {
+            scratch.append(text);
+            text = scratch;
+        }
+        ++pos_;
+        return text;
+    }
+
+    void appendEscape(std::string& out) {
+        if (pos_ == end_) {
+            fail("unterminated string");
+        }
+        switch (*pos_++) {
+            case '"':  out.push_back('"'); return;
+            case '\\': out.push_back('\\'); return;
+            case '/':  out.push_back('/'); return;
+            case 'b':  out.push_back('\b'); return;
+            case 'f':  out.push_back('\f'); return;
+            case 'n':  out.push_back('\n'); return;
+            case 'r':  out.push_back('\r'); return;
+            case 't':  out.push_back('\t'); return;
+            case 'u':  break;
+            default:   fail("invalid escape in string");
+        }
+
+        uint32_t code = parseHex4();
+        if (code >= 0xDC00 && code <= 0xDFFF) {
+            fail("unpaired surrogate in string");
+        }
+        if (code >= 0xD800 && code <= 0xDBFF) {
+            if (end_ - pos_ < 2 || pos_[0] != '\\' || pos_[1] != 'u') {
+                fail("unpaired surrogate in string");
+            }
+            pos_ += 2;
+            uint32_t low = parseHex4();
+            if (low < 0xDC00 || low > 0xDFFF) {
+                fail("unpaired surrogate in string");
+            }
+            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+        }
+        appendUtf8(out, code);
+    }
+
+    uint32_t parseHex4() {
+        if (end_ - pos_ < 4) {
+            fail("invalid \\u escape in string");
+        }
+        uint32_t code = 0;
+        auto result = std::from_chars(pos_, pos_ + 4, code, 16);
+        if (result.ptr != pos_ + 4) {
+            fail("invalid \\u escape in string");
+        }
+        pos_ += 4;
+        return code;
+    }
+
+    static void appendUtf8(std::string& out, uint32_t code) {
+        if (code < 0x80) {
+            out.push_back(static_cast<char>(code));
+        } else if (code < 0x800) {
+            out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else if (code < 0x10000) {
+            out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        } else {
+            out.push_back(static_cast<char>(0xF0 | (code >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+            out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+        }
+    }
+
+    int64_t parseIntegerValue(const char* key) {
+        const char* start = pos_;
+        if (pos_ != end_ && *pos_ == '-') {
+            ++pos_;
+        }
+        while (pos_ != end_ && *pos_ >= '0' && *pos_ <= '9') {
+            ++pos_;
+        }
+        int64_t value = 0;
+        if (!parseInteger(std::string_view(start, static_cast<size_t>(pos_ - start)), value)) {
+            fail(std::string(key) + " must be an integer");
+        }
+        return value;
+    }
+
+    bool parseCompleted() {
+        if (match("true")) {
+            return true;
+        }
+        if (match("false")) {
+            return false;
+        }
+        if (match("1")) {
+            return true;
+        }
+        if (match("0")) {
+            return false;
+        }
+        fail("completed must be true, false, 0 or 1");
+    }
+
+    /**
+     * @brief Skip a value of an unknown key, nested objects and arrays included
+     */
+    void skipValue() {
+        size_t depth = 0;
+        while (true) {
+            char c = peek();
+            if (c == '\n') {
+                fail("unterminated object");
+            }
+            if (c == '"') {
+                parseString(skipped_);
+            } else if (c == '{' || c == '[') {
+                ++depth;
+                ++pos_;
+            } else if (c == '}' || c == ']') {
+                if (depth == 0) {
+                    return;
+                }
+                --depth;
+                ++pos_;
+            } else if (c == ',' && depth == 0) {
+                return;
+            } else {
+                ++pos_;
+            }
+        }
+    }
+
+    std::string key_;
+    std::string title_;
+    std::string description_;
+    std::string skipped_;
+};
+
+/**
+ * @brief Reads RFC 4180 CSV rows, with columns named by a header row
+ *
+ * Unquoted fields and quoted fields without doubled quotes are returned
+ * in place. Records end with CRLF or LF.
+ */
+class CsvScanner : public Scanner {
+public:
+    CsvScanner(const char* begin, const char* end)
+        : Scanner(begin, end, "CSV") {
+        // An empty file has no header and no rows
+        if (!readRecord()) {
+            return;
+        }
+        for (size_t i = 0; i < fields_.size(); ++i) {
+            std::string_view name = fields_[i];
+            if (name == "title") {
+                title_ = i;
+            } else if (name == "description") {
+                description_ = i;
+            } else if (name == "completed") {
+                completed_ = i;
+            } else if (name == "created_at") {
+                created_at_ = i;
+            }
+        }
+        if (title_ == kMissing) {
+            fail("the header has no title column");
+        }
+        columns_ = fields_.size();
+    }
+
+    /**
+     * @brief Read the next row
+     * @return false at the end of the input
+     */
+    bool next(ImportRow& row) {
+        if (columns_ == 0 || !readRecord()) {
+            return false;
+        }
+        if (fields_.size() != columns_) {
+            fail("expected " + std::to_string(columns_) + " fields, found " + std::to_string(fields_.size()));
+        }
+
+        row = ImportRow();
+        row.title = fields_[title_];
+        if (row.title.empty()) {
+            fail("title cannot be empty");
+        }
+        if (description_ != kMissing) {
+            row.description = fields_[description_];
+        }
+        if (completed_ != kMissing) {
+            std::string_view completed = fields_[completed_];
+            if (completed == "1" || completed == "true") {
+                row.completed = true;
+            } else if (!completed.empty() && completed != "0" && completed != "false") {
+                fail("completed must be true, false, 0 or 1");
+            }
+        }
+        if (created_at_ != kMissing && !fields_[created_at_].empty()) {
+            if (!parseInteger(fields_[created_at_], row.created_at)) {
+                fail("created_at must be an integer");
+            }
+            row.has_created_at = true;
+        }
+        return true;
+    }
+
+private:
+    static constexpr size_t kMissing = static_cast<size_t>(-1);
+
+    /**
+     * @brief Split the next non-blank record into fields_
+     * @return false at the end of the input
+     */
+    bool readRecord() {
+        while (pos_ != end_ && (*pos_ == '\n' || (*pos_ == '\r' && end_ - pos_ > 1 && pos_[1] == '\n'))) {
+            pos_ += *pos_ == '\r' ? 2 : 1;
+            ++line_;
+        }
+        if (pos_ == end_) {
+            return false;
+        }
+        row_line_ = line_;
+
+        fields_.clear();
+        while (true) {
+            // A deque, so that views into earlier buffers survive growth
+            if (fields_.size() == scratch_.size()) {
+                scratch_.emplace_back();
+            }
+            fields_.push_back(parseField(scratch_[fields_.size()]));
+
+            if (pos_ == end_) {
+                return true;
+            }
+            char c = *pos_++;
+            if (c == ',') {
+                continue;
+            }
+            if (c == '\r' && pos_ != end_ && *pos_ == '\n') {
+                ++pos_;
+                c = '\n';
+            }
+            if (c != '\n') {
+                fail("unexpected text after a field");
+            }
+            ++line_;
+            return true;
+        }
+    }
+
+    std::string_view parseField(std::string& scratch) {
+        if (pos_ == end_ || *pos_ != '"') {
+            const char* start = pos_;
+            while (pos_ != end_ && *pos_ != ',' && *pos_ != '\n' && *pos_ != '\r') {
+                ++pos_;
+            }
+            return std::string_view(start, static_cast<size_t>(pos_ - start));
+        }
+
+        ++pos_;
+        const char* run = pos_;
+        bool escaped = false;
+        while (true) {
+            const char* quote = static_cast<const char*>(std::memchr(pos_, '"', static_cast<size_t>(end_ - pos_)));
+            if (!quote) {
+                fail("unterminated quoted field");
+            }
+            line_ += static_cast<size_t>(std::count(pos_, quote, '\n'));
+            pos_ = quote + 1;
+
+            if (pos_ == end_ || *pos_ != '"') {
+                std::string_view text(run, static_cast<size_t>(quote - run));
+                if (escaped) {
+                    scratch.append(text);
+                    text = scratch;
+                }
+                return text;
+            }
+
+            // A doubled quote: keep one
+            if (!escaped) {
+                scratch.clear();
+                escaped = true;
+            }
+            scratch.append(run, pos_);
+            ++pos_;
+            run = pos_;
+        }
+    }
+
+    std::vector<std::string_view> fields_;
+    std::deque<std::string> scratch_;
+    size_t columns_ = 0;
+    size_t title_ = kMissing;
+    size_t description_ = kMissing;
+    size_t completed_ = kMissing;
+    size_t created_at_ = kMissing;
+};
+
+void bindText(sqlite3_stmt* stmt, int index, std::string_view text) {
+    // An empty view may have no data pointer, which would bind NULL
+    sqlite3_bind_text(stmt, index, text.empty() ? "" : text.data(), static_cast<int>(text.size()), SQLITE_STATIC);
+}
+
+/**
+ * @brief Id above which every row was inserted after the import started
+ */
+int64_t lastTodoId(Database& database) {
+    Statement statement = database.prepare(
+        "SELECT MAX(COALESCE((SELECT seq FROM sqlite_sequence WHERE name = 'todos'), 0), "
+        "COALESCE((SELECT MAX(id) FROM todos), 0))");
+    if (sqlite3_step(statement.get()) != SQLITE_ROW) {
+        throw DatabaseException("Failed to read todo ids: " + database.getLastError());
+    }
+    return sqlite3_column_int64(statement.get(), 0);
+}
+
+/**
+ * @brief Read the SQL of the indexes or triggers on todos
+ * @param type "index" or "trigger"
+ * @return Name and CREATE statement of each
+ */
+std::vector<std::pair<std::string, std::string>> schemaObjects(Database& database, const char* type) {
+    Statement objects = database.prepare(
+        "SELECT name, sql FROM sqlite_master "
+        "WHERE tbl_name = 'todos' AND type = ? AND sql IS NOT NULL ORDER BY name");
+    sqlite3_bind_text(objects.get(), 1, type, -1, SQLITE_STATIC);
+
+    std::vector<std::pair<std::string, std::string>> found;
+    int result;
+    while ((result = sqlite3_step(objects.get())) == SQLITE_ROW) {
+        found.emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(objects.get(), 0)),
+                           reinterpret_cast<const char*>(sqlite3_column_text(objects.get(), 1)));
+    }
+    if (result != SQLITE_DONE) {
+        throw DatabaseException("Failed to read schema: " + database.getLastError());
+    }
+    return found;
+}
+
+/**
+ * @brief Drop the indexes on todos, recording how to recreate them
+ *
+ * Only indexes are deferred for the whole import; triggers stay in place
+ * between load transactions, so changes to existing rows keep the search
+ * indexes and statistics right while an import is pending.
+ */
+void deferSchema(Database& database) {
+    Statement record = database.prepare("INSERT OR REPLACE INTO import_deferred (name, sql) VALUES (?, ?)");
+    for (const auto& index : schemaObjects(database, "index")) {
+        sqlite3_bind_text(record.get(), 1, index.first.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(record.get(), 2, index.second.c_str(), -1, SQLITE_TRANSIENT);
+        if (sqlite3_step(record.get()) != SQLITE_DONE) {
+            throw DatabaseException("Failed to record deferred schema: " + database.getLastError());
+        }
+        sqlite3_reset(record.get());
+
+        database.execute("DROP INDEX \"" + index.first + "\"");
+    }
+}
+
+/**
+ * @brief Recreate what deferSchema() dropped
+ */
+void restoreSchema(Database& database) {
+    std::vector<std::string> creates;
+    {
+        Statement deferred = database.prepare("SELECT sql FROM import_deferred ORDER BY rowid");
+        int result;
+        while ((result = sqlite3_step(deferred.get())) == SQLITE_ROW) {
+            creates.emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(deferred.get(), 0)));
+        }
+        if (result != SQLITE_DONE) {
+            throw DatabaseException("Failed to read deferred schema: " + database.getLastError());
+        }
+    }
+
+    for (const auto& create : creates) {
+        database.execute(create);
+    }
+    database.execute("DELETE FROM import_deferred");
+}
+
+/**
+ * @brief Read the CREATE statement of a trigger
+ * @return The SQL, or an empty string if there is no such trigger
+ */
+std::string triggerSql(Database& database, const std::string& name) {
+    Statement trigger = database.prepare(
+        "SELECT sql FROM sqlite_master WHERE type = 'trigger' AND name = ? AND sql IS NOT NULL");
+    sqlite3_bind_text(trigger.get(), 1, name.c_str(), -1, SQLITE_TRANSIENT);
+    int result = sqlite3_step(trigger.get());
+    if (result == SQLITE_ROW) {
+        return reinterpret_cast<const char*>(sqlite3_column_text(trigger.get(), 0));
+    }
+    if (result != SQLITE_DONE) {
+        throw DatabaseException("Failed to read schema: " + database.getLastError());
+    }
+    return "";
+}
+
+/**
+ * @brief Insert every remaining row, committing and checkpointing every rows_per_transaction rows
+ * @param imported_rows Rows imported by earlier runs
+ * @return Rows inserted
+ *
+ * Within each transaction the insert triggers that indexInsertedTodos()
+ * stands in for are dropped for the inserts and recreated after the
+ * search indexes and statistics have been updated for the new rows in
+ * bulk, so no other connection, and no state left by a crash, ever sees
+ * todos without them. Every other trigger on todos fires as usual.
+ */
+template <typename RowScanner>
+size_t loadRows(Database& database, RowScanner& scanner, size_t rows_per_transaction, size_t imported_rows) {
+    const sqlite3_int64 now = static_cast<sqlite3_int64>(std::time(nullptr));
+
+    ImportRow row;
+    size_t rows = 0;
+    bool more = scanner.next(row);
+
+    while (more) {
+        Transaction transaction(database, TransactionMode::IMMEDIATE);
+
+        // The write lock is held, so every id above this is from this chunk
+        int64_t chunk_after_id = lastTodoId(database);
+        std::vector<std::string> triggers;
+        for (const std::string& name : bulkInsertTriggers()) {
+            std::string sql = triggerSql(database, name);
+            if (!sql.empty()) {
+                database.execute("DROP TRIGGER \"" + name + "\"");
+                triggers.push_back(std::move(sql));
+            }
+        }
+
+        // Prepared after the drops, which would otherwise force a re-prepare
+        Statement insert = database.prepare(kInsertSql);
+        sqlite3_stmt* stmt = insert.get();
+        size_t chunk = 0;
+        do {
+            bindText(stmt, 1, row.title);
+            bindText(stmt, 2, row.description);
+            sqlite3_bind_int(stmt, 3, row.completed ? 1 : 0);
+            sqlite3_bind_int64(stmt, 4, row.has_created_at ? row.created_at : now);
+
+            if (sqlite3_step(stmt) != SQLITE_DONE) {
+                throw DatabaseException("Failed to insert todo item: " + database.getLastError());
+            }
+            sqlite3_reset(stmt);
+            ++chunk;
+        } while (chunk < rows_per_transaction && (more = scanner.next(row)));
+        rows += chunk;
+
+        indexInsertedTodos(database, chunk_after_id);
+        for (const auto& sql : triggers) {
+            database.execute(sql);
+        }
+
+        Statement progress = database.prepare(
+            "UPDATE import_checkpoint SET position = ?, line = ?, imported_rows = ? WHERE id = 1");
+        sqlite3_bind_int64(progress.get(), 1, static_cast<sqlite3_int64>(scanner.position()));
+        sqlite3_bind_int64(progress.get(), 2, static_cast<sqlite3_int64>(scanner.line()));
+        sqlite3_bind_int64(progress.get(), 3, static_cast<sqlite3_int64>(imported_rows + rows));
+        if (sqlite3_step(progress.get()) != SQLITE_DONE) {
+            throw DatabaseException("Failed to record import progress: " + database.getLastError());
+        }
+
+        transaction.commit();
+
+        // Read ahead only once the chunk is committed, so a bad line does
+        // not undo it, and input that ends on a chunk boundary does not
+        // start an empty transaction
+        more = more && scanner.next(row);
+    }
+    return rows;
+}
+
+/**
+ * @brief Start or resume an import, load the rest of the input and finish
+ */
+template <typename RowScanner>
+ImportResult importRows(Database& database, const std::string& source, const MappedInput& input,
+                        RowScanner& scanner, size_t rows_per_transaction) {
+    ImportResult result;
+    {
+        Transaction transaction(database, TransactionMode::IMMEDIATE);
+
+        Statement checkpoint = database.prepare(
+            "SELECT source, position, line, imported_rows, after_id FROM import_checkpoint WHERE id = 1");
+        int step = sqlite3_step(checkpoint.get());
+        if (step == SQLITE_ROW) {
+            std::string pending = reinterpret_cast<const char*>(sqlite3_column_text(checkpoint.get(), 0));
+            if (pending != source) {
+                throw ValidationException("An import of " + pending + " has not finished; run it again to "
+                                      "resume it, or run import --abort");
+            }
+            size_t position = static_cast<size_t>(sqlite3_column_int64(checkpoint.get(), 1));
+            size_t line = static_cast<size_t>(sqlite3_column_int64(checkpoint.get(), 2));
+            result.total_rows = static_cast<size_t>(sqlite3_column_int64(checkpoint.get(), 3));
+            result.resumed = true;
+
+            // The checkpoint must still fall at the start of a line
+            if (position > input.size() || (position > 0 && input.data()[position - 1] != '\n')) {
+                throw ValidationException("The imported part of " + source + " has changed since the import "
+                                      "stopped; run import --abort to keep the rows imported so far");
+            }
+            scanner.seek(position, line);
+        } else if (step == SQLITE_DONE) {
+            int64_t after_id = lastTodoId(database);
+            deferSchema(database);
+
+            Statement start = database.prepare(
+                "INSERT INTO import_checkpoint (id, source, position, line, imported_rows, after_id) "
+                "VALUES (1, ?, 0, 1, 0, ?)");
+            sqlite3_bind_text(start.get(), 1, source.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_int64(start.get(), 2, after_id);
+            if (sqlite3_step(start.get()) != SQLITE_DONE) {
+                throw DatabaseException("Failed to record import progress: " + database.getLastError());
+            }
+        } else {
+            throw DatabaseException("Failed to read import progress: " + database.getLastError());
+        }
+
+        transaction.commit();
+    }
+
+    result.rows = loadRows(database, scanner, rows_per_transaction, result.total_rows);
+    result.total_rows += result.rows;
+
+    // Recreate the indexes; the derived data is already up to date
+    Transaction transaction(database, TransactionMode::IMMEDIATE);
+    restoreSchema(database);
+    database.execute("DELETE FROM import_checkpoint");
+    transaction.commit();
+
+    return result;
+}
+
+} // anonymous namespace
+
+Importer::Importer(Database& database, ExportFormat format, size_t rows_per_transaction)
+    : database_(database)
+    , format_(format)
+    , rows_per_transaction_(rows_per_transaction > 0 ? rows_per_transaction : 1) {
+}
+
+size_t Importer::abort() {
+    Transaction transaction(database_, TransactionMode::IMMEDIATE);
+
+    Statement checkpoint = database_.prepare("SELECT imported_rows FROM import_checkpoint WHERE id = 1");
+    int step = sqlite3_step(checkpoint.get());
+    if (step == SQLITE_DONE) {
+        throw ValidationException("No import is in progress");
+    }
+    if (step != SQLITE_ROW) {
+        throw DatabaseException("Failed to read import progress: " + database_.getLastError());
+    }
+    size_t rows = static_cast<size_t>(sqlite3_column_int64(checkpoint.get(), 0));
+
+    restoreSchema(database_);
+    database_.execute("DELETE FROM import_checkpoint");
+    transaction.commit();
+    return rows;
+}
+
+ImportResult Importer::importFile(const std::string& path) {
+    MappedInput input(path);
+    const std::string source = std::filesystem::absolute(path).lexically_normal().string();
+
+    // Scanners read the CSV header up front, so a bad header fails before
+    // anything is changed
+    const char* begin = input.data();
+    const char* end = begin + input.size();
+    if (format_ == ExportFormat::CSV) {
+        CsvScanner scanner(begin, end);
+        return importRows(database_, source, input, scanner, rows_per_transaction_);
+    }
+    JsonLinesScanner scanner(begin, end);
+    return importRows(database_, source, input, scanner, rows_per_transaction_);
+}
+
+} // namespace todolist
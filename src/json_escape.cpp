@@ -0,0 +1,115 @@
+#include "todolist/json_escape.h"
+#include <algorithm>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define TODOLIST_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace todolist {
+
+namespace {
+
+inline bool needsEscape(unsigned char c) {
+    return c < 0x20 || c == '"' || c == '\\' || c >= 0x80;
+}
+
+size_t findScalar(const char* text, size_t position, size_t size) {
+    while (position < size && !needsEscape(static_cast<unsigned char>(text[position]))) {
+        ++position;
+    }
+    return position;
+}
+
+#ifdef TODOLIST_X86_SIMD
+
+// A byte needs escaping if it is '"', '\\' or below 0x20. The unsigned
+// min of a byte and 0x1F equals the byte only for bytes up to 0x1F.
+// Non-ASCII bytes are reported too, for UTF-8 checking; movemask reads
+// the top bit of each byte, so OR-ing the bytes in adds them for free.
+
+__attribute__((target("sse2")))
+size_t findSse2(const char* text, size_t position, size_t size) {
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1F);
+
+    while (position + 16 <= size) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + position));
+        __m128i special = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(bytes, quote), _mm_cmpeq_epi8(bytes, backslash)),
+            _mm_cmpeq_epi8(_mm_min_epu8(bytes, control), bytes));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_or_si128(special, bytes)));
+        if (mask) {
+            return position + static_cast<size_t>(__builtin_ctz(mask));
+        }
+        position += 16;
+    }
+
+    return findScalar(text, position, size);
+}
+
+__attribute__((target("avx2")))
+size_t findAvx2(const char* text, size_t position, size_t size) {
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i control = _mm256_set1_epi8(0x1F);
+
+    while (position + 32 <= size) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + position));
+        __m256i special = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(bytes, quote), _mm256_cmpeq_epi8(bytes, backslash)),
+            _mm256_cmpeq_epi8(_mm256_min_epu8(bytes, control), bytes));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_or_si256(special, bytes)));
+        if (mask) {
+            return position + static_cast<size_t>(__builtin_ctz(mask));
+        }
+        position += 32;
+    }
+
+    return findSse2(text, position, size);
+}
+
+#endif // TODOLIST_X86_SIMD
+
+} // anonymous namespace
+
+size_t findJsonEscape(const char* text, size_t size, SimdLevel level) {
+    switch (std::min(level, detectSimdLevel())) {
+#ifdef TODOLIST_X86_SIMD
+        case SimdLevel::AVX2:
+            return findAvx2(text, 0, size);
+        case SimdLevel::SSE2:
+            return findSse2(text, 0, size);
+#endif
+        default:
+            return findScalar(text, 0, size);
+    }
+}
+
+size_t utf8SequenceLength(const char* text, size_t size) {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(text);
+    auto continuation = [&](size_t i, unsigned char low = 0x80, unsigned char high = 0xBF) {
+        return i < size && bytes[i] >= low && bytes[i] <= high;
+    };
+
+    // Table 3-7 of the Unicode standard: the second byte's range rules out
+    // overlong forms, surrogates and code points above U+10FFFF
+    unsigned char lead = bytes[0];
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        return continuation(1) ? 2 : 0;
+    }
+    if (lead >= 0xE0 && lead <= 0xEF) {
+        unsigned char low = lead == 0xE0 ? 0xA0 : 0x80;
+        unsigned char high = lead == 0xED ? 0x9F : 0xBF;
+        return continuation(1, low, high) && continuation(2) ? 3 : 0;
+    }
+    if (lead >= 0xF0 && lead <= 0xF4) {
+        unsigned char low = lead == 0xF0 ? 0x90 : 0x80;
+        unsigned char high = lead == 0xF4 ? 0x8F : 0xBF;
+        return continuation(1, low, high) && continuation(2) && continuation(3) ? 4 : 0;
+    }
+    return 0;
+}
+
+} // namespace todolist
@@ -0,0 +1,208 @@
+#include "todolist/json_formatter.h"
+#include "todolist/buffered_writer.h"
+#include "todolist/exceptions.h"
+#include "todolist/json_escape.h"
+
+namespace todolist {
+
+namespace {
+
+template <typename Sink>
+void appendText(Sink& out, std::string_view text) {
+    out.append(text.data(), text.size());
+}
+
+/**
+ * @brief Append an item object, with the same keys as Exporter
+ */
+template <typename Sink>
+void appendItemObject(Sink& out, const TodoItemView& item) {
+    appendText(out, "{\"id\":");
+    appendJsonInteger(out, item.getId());
+    appendText(out, ",\"title\":");
+    appendJsonString(out, item.getTitle());
+    appendText(out, ",\"description\":");
+    appendJsonString(out, item.getDescription());
+    appendText(out, item.isCompleted() ? ",\"completed\":true,\"created_at\":" : ",\"completed\":false,\"created_at\":");
+    appendJsonInteger(out, static_cast<long long>(item.getCreatedAtUnix()));
+    out.push_back('}');
+}
+
+/**
+ * @brief Format {"status":"ok","message":...}
+ */
+std::string okMessage(const std::string& message) {
+    std::string out = "{\"status\":\"ok\",\"message\":";
+    appendJsonString(out, message);
+    out.push_back('}');
+    return out;
+}
+
+} // anonymous namespace
+
+OutputMode parseOutputMode(const std::string& name) {
+    if (name == "text") {
+        return OutputMode::TEXT;
+    }
+    if (name == "json") {
+        return OutputMode::JSON;
+    }
+    if (name == "ndjson") {
+        return OutputMode::NDJSON;
+    }
+    throw ValidationException("Invalid output format: " + name + " (use text, json or ndjson)");
+}
+
+std::unique_ptr<Formatter> makeFormatter(OutputMode mode, bool useColor) {
+    if (mode == OutputMode::TEXT) {
+        return std::make_unique<Formatter>(useColor);
+    }
+    return std::make_unique<JsonFormatter>(mode == OutputMode::NDJSON);
+}
+
+JsonFormatter::JsonFormatter(bool lines)
+    : Formatter(false)
+    , lines_(lines) {
+}
+
+std::string JsonFormatter::formatStats(size_t total, size_t completed) const {
+    std::string out = "{\"total\":";
+    appendJsonInteger(out, static_cast<long long>(total));
+    out += ",\"completed\":";
+    appendJsonInteger(out, static_cast<long long>(completed));
+    out += ",\"pending\":";
+    appendJsonInteger(out, static_cast<long long>(total - completed));
+    out.push_back('}');
+    return out;
+}
+
+std::string JsonFormatter::formatSuccess(const std::string& message) const {
+    return okMessage(message);
+}
+
+std::string JsonFormatter::formatError(const std::string& message) const {
+    std::string out = "{\"status\":\"error\",\"error\":";
+    appendJsonString(out, message);
+    out.push_back('}');
+    return out;
+}
+
+std::string JsonFormatter::formatWarning(const std::string& message) const {
+    return okMessage(message);
+}
+
+std::string JsonFormatter::formatInfo(const std::string& message) const {
+    return okMessage(message);
+}
+
+std::string JsonFormatter::formatItemResult(const std::string& message, const TodoItem& item) const {
+    std::string out = "{\"status\":\"ok\",\"message\":";
+    appendJsonString(out, message);
+    out += ",\"item\":";
+    appendItemObject(out, item);
+    out.push_back('}');
+    return out;
+}
+
+std::string JsonFormatter::formatBulkResult(const std::vector<std::string>& steps,
+                                            const std::string& summary, long long count) const {
+    std::string out = "{\"status\":\"ok\",\"message\":";
+    appendJsonString(out, summary);
+    out += ",\"count\":";
+    appendJsonInteger(out, count);
+    out += ",\"steps\":[";
+    for (size_t i = 0; i < steps.size(); ++i) {
+        if (i > 0) {
+            out.push_back(',');
+        }
+        appendJsonString(out, steps[i]);
+    }
+    out += "]}";
+    return out;
+}
+
+std::string JsonFormatter::formatHelp(const std::string& /*title*/, const std::string& text) const {
+    std::string out = "{\"status\":\"ok\",\"help\":";
+    appendJsonString(out, text);
+    out.push_back('}');
+    return out;
+}
+
+std::string JsonFormatter::formatVersion(const std::string& version, const std::string& build) const {
+    std::string out = "{\"version\":";
+    appendJsonString(out, version);
+    out += ",\"build\":";
+    appendJsonString(out, build);
+    out.push_back('}');
+    return out;
+}
+
+bool JsonFormatter::isStructured() const {
+    return true;
+}
+
+void JsonFormatter::beginList(BufferedWriter& out, size_t total, size_t completed, std::string_view query) const {
+    listed_ = 0;
+    if (lines_) {
+        return;
+    }
+
+    out.push_back('{');
+    if (!query.empty()) {
+        appendText(out, "\"query\":");
+        appendJsonString(out, query);
+        out.push_back(',');
+    }
+    appendText(out, "\"total\":");
+    appendJsonInteger(out, static_cast<long long>(total));
+    appendText(out, ",\"completed\":");
+    appendJsonInteger(out, static_cast<long long>(completed));
+    appendText(out, ",\"items\":[");
+}
+
+void JsonFormatter::appendListItem(BufferedWriter& out, const TodoItemView& item) const {
+    if (lines_) {
+        appendItemObject(out, item);
+        out.push_back('\n');
+        return;
+    }
+
+    if (listed_++ > 0) {
+        out.push_back(',');
+    }
+    appendItemObject(out, item);
+}
+
+void JsonFormatter::appendListItems(BufferedWriter& out, const std::vector<TodoItem>& items) const {
+    for (const auto& item : items) {
+        appendListItem(out, item);
+    }
+}
+
+void JsonFormatter::endList(BufferedWriter& out, std::string_view next_cursor) const {
+    if (lines_) {
+        if (!next_cursor.empty()) {
+            appendText(out, "{\"next_cursor\":");
+            appendJsonString(out, next_cursor);
+            appendText(out, "}\n");
+        }
+        return;
+    }
+
+    out.push_back(']');
+    if (!next_cursor.empty()) {
+        appendText(out, ",\"next_cursor\":");
+        appendJsonString(out, next_cursor);
+    }
+    appendText(out, "}\n");
+}
+
+void JsonFormatter::appendEmptyList(BufferedWriter& out, std::string_view query) const {
+    if (lines_) {
+        return;
+    }
+    beginList(out, 0, 0, query);
+    endList(out, "");
+}
+
+} // namespace todolist
@@ -3,11 +3,15 @@
 #include <memory>
 #include <cstdlib>
 #include <unistd.h>
+#include "todolist/command_arena.h"
 #include "todolist/command_parser.h"
 #include "todolist/cli_handler.h"
 #include "todolist/database.h"
+#include "todolist/exceptions.h"
 #include "todolist/todo_repository.h"
 #include "todolist/formatter.h"
+#include "todolist/json_formatter.h"
+#include "todolist/snapshot_file.h"
 
 namespace {
 
@@ -32,24 +36,70 @@ std::string getDatabasePath() {
 
 int main(int argc, char* argv[]) {
     try {
+        // Scratch memory for this command's parsing and output buffers
+        todolist::CommandArena arena;
+
         // Parse command-line arguments
         todolist::CommandParser parser;
-        auto parsedCmd = parser.parse(argc, argv);
+        auto parsedCmd = parser.parse(argc, argv, arena.resource());
 
-        // Set up database and repository
         std::string dbPath = getDatabasePath();
-        todolist::Database database(dbPath);
+        bool useColor = isatty(fileno(stdout));
+
+        // Text (colored if output is a TTY) unless --output asks for JSON
+        todolist::OutputMode outputMode = todolist::OutputMode::TEXT;
+        if (auto output = parsedCmd.getOption("output")) {
+            try {
+                outputMode = todolist::parseOutputMode(*output);
+            } catch (const todolist::ValidationException& e) {
+                std::cout << todolist::Formatter(useColor).formatError(e.what()) << std::endl;
+                return 1;
+            }
+        }
+
+        // list --snapshot is served from the snapshot file without opening
+        // SQLite, as long as the file matches the database
+        bool useSnapshot = parsedCmd.command == todolist::Command::LIST && parsedCmd.hasFlag("snapshot");
+        if (useSnapshot) {
+            if (auto snapshot = todolist::SnapshotFile::openCurrent(dbPath)) {
+                auto formatter = todolist::makeFormatter(outputMode, useColor);
+                if (todolist::CliHandler::streamSnapshotList(*snapshot, parsedCmd.args, parsedCmd.options,
+                                                             *formatter, std::cout)) {
+                    todolist::CliHandler::endStreamedOutput(*formatter, std::cout);
+                    return 0;
+                }
+            }
+        }
+
+        // Connection settings: defaults, then TODOLIST_* variables, then flags
+        todolist::DatabaseOptions dbOptions;
+        try {
+            dbOptions = todolist::DatabaseOptions::fromEnvironment();
+            for (const auto& option : parsedCmd.options) {
+                dbOptions.set(option.first, option.second);
+            }
+        } catch (const todolist::ValidationException& e) {
+            std::cout << todolist::makeFormatter(outputMode, useColor)->formatError(e.what()) << std::endl;
+            return 1;
+        }
+
+        // Set up database and repository
+        todolist::Database database(dbPath, dbOptions);
         todolist::TodoRepository repository(database);
 
-        // Set up formatter (detect if output is a TTY for color support)
-        bool useColor = isatty(fileno(stdout));
-        auto formatter = std::make_unique<todolist::Formatter>(useColor);
+        // Set up formatter
+        auto formatter = todolist::makeFormatter(outputMode, useColor);
 
         // Set up CLI handler
-        todolist::CliHandler handler(repository, std::move(formatter));
+        todolist::CliHandler handler(repository, std::move(formatter), arena.resource());
 
         // Execute the command
-        return handler.execute(parsedCmd);
+        int status = handler.execute(parsedCmd);
+
+        // Keep an existing snapshot current after writes; a stale or
+        // missing one read by list --snapshot is rebuilt here
+        todolist::SnapshotFile::refresh(dbPath, database, useSnapshot);
+        return status;
 
     } catch (const todolist::DatabaseException& e) {
         std::cerr << "Database error: " << e.what() << std::endl;
@@ -0,0 +1,410 @@
+#include "todolist/migrations.h"
+#include <sqlite3.h>
+#include <string>
+
+namespace todolist {
+
+namespace {
+
+/**
+ * @brief An external-content FTS5 index over columns of todos
+ *
+ * Indexes are populated online: rows that exist when the index is
+ * created are copied in id order by backfill chunks, while triggers keep
+ * new rows and already-copied rows in sync. Until the copy finishes the
+ * update and delete triggers skip rows that have not been copied yet,
+ * since removing a row that was never indexed would corrupt an
+ * external-content index; such rows are copied with their current values
+ * when their chunk comes.
+ */
+struct FtsIndex {
+    const char* table;         ///< Virtual table name
+    const char* create_sql;    ///< CREATE VIRTUAL TABLE statement
+    const char* columns;       ///< Indexed columns, e.g. "title, description"
+    const char* new_values;    ///< The columns of NEW, e.g. "new.title, new.description"
+    const char* old_values;    ///< The columns of OLD
+};
+
+const FtsIndex kFullTextIndex = {
+    "todos_fts",
+    "CREATE VIRTUAL TABLE IF NOT EXISTS todos_fts "
+    "USING fts5(title, description, content='todos', content_rowid='id')",
+    "title, description",
+    "new.title, new.description",
+    "old.title, old.description",
+};
+
+const FtsIndex kTrigramIndex = {
+    "todos_trigram",
+    "CREATE VIRTUAL TABLE IF NOT EXISTS todos_trigram "
+    "USING fts5(title, content='todos', content_rowid='id', tokenize='trigram')",
+    "title",
+    "new.title",
+    "old.title",
+};
+
+void setSchemaVersion(Database& database, int version) {
+    database.execute("PRAGMA user_version = " + std::to_string(version));
+}
+
+/**
+ * @brief Check whether a table has a column, so ALTER TABLE ADD COLUMN can be rerun
+ */
+bool columnExists(Database& database, const char* table, const char* column) {
+    Statement info = database.prepare("SELECT 1 FROM pragma_table_info(?) WHERE name = ?");
+    sqlite3_bind_text(info.get(), 1, table, -1, SQLITE_STATIC);
+    sqlite3_bind_text(info.get(), 2, column, -1, SQLITE_STATIC);
+    int result = sqlite3_step(info.get());
+    if (result != SQLITE_ROW && result != SQLITE_DONE) {
+        throw DatabaseException("Failed to read table columns: " + database.getLastError());
+    }
+    return result == SQLITE_ROW;
+}
+
+/**
+ * @brief (Re)create the triggers that keep an FTS index in sync
+ * @param index The index
+ * @param backfilling Whether to skip rows the backfill has not copied yet
+ */
+void createFtsTriggers(Database& database, const FtsIndex& index, bool backfilling) {
+    std::string table = index.table;
+    std::string columns = index.columns;
+    std::string remove = "INSERT INTO " + table + "(" + table + ", rowid, " + columns + ") "
+                         "VALUES ('delete', old.id, " + index.old_values + ");";
+    std::string insert = "INSERT INTO " + table + "(rowid, " + columns + ") "
+                         "VALUES (new.id, " + index.new_values + ");";
+
+    // Rows up to done_id have been copied; rows above last_id were inserted
+    // after the index was created and are maintained by the insert trigger
+    std::string when;
+    if (backfilling) {
+        std::string progress = " FROM schema_backfill WHERE name = '" + table + "')";
+        when = " WHEN old.id <= (SELECT done_id" + progress +
+               " OR old.id > (SELECT last_id" + progress;
+    }
+
+    database.execute(
+        "DROP TRIGGER IF EXISTS " + table + "_insert;"
+        "DROP TRIGGER IF EXISTS " + table + "_delete;"
+        "DROP TRIGGER IF EXISTS " + table + "_update;"
+        "CREATE TRIGGER " + table + "_insert AFTER INSERT ON todos BEGIN " + insert + " END;"
+        "CREATE TRIGGER " + table + "_delete AFTER DELETE ON todos" + when + " BEGIN " + remove + " END;"
+        "CREATE TRIGGER " + table + "_update AFTER UPDATE OF " + columns + " ON todos" + when +
+        " BEGIN " + remove + " " + insert + " END;");
+}
+
+void applyFtsIndex(Database& database, const FtsIndex& index) {
+    database.execute(
+        "CREATE TABLE IF NOT EXISTS schema_backfill ("
+        "    name TEXT PRIMARY KEY,"
+        "    done_id INTEGER NOT NULL,"
+        "    last_id INTEGER NOT NULL"
+        ")");
+
+    if (database.tableExists(index.table)) {
+        // Either fully built (a database from before versioning) or a
+        // backfill that was interrupted and will resume; the triggers are
+        // already in place in both cases
+        return;
+    }
+
+    database.execute(index.create_sql);
+
+    Statement max_id = database.prepare("SELECT COALESCE(MAX(id), 0) FROM todos");
+    if (sqlite3_step(max_id.get()) != SQLITE_ROW) {
+        throw DatabaseException("Failed to read todo ids: " + database.getLastError());
+    }
+    sqlite3_int64 last_id = sqlite3_column_int64(max_id.get(), 0);
+
+    if (last_id == 0) {
+        createFtsTriggers(database, index, false);
+        return;
+    }
+
+    Statement progress = database.prepare(
+        "INSERT OR REPLACE INTO schema_backfill (name, done_id, last_id) VALUES (?, 0, ?)");
+    sqlite3_bind_text(progress.get(), 1, index.table, -1, SQLITE_STATIC);
+    sqlite3_bind_int64(progress.get(), 2, last_id);
+    if (sqlite3_step(progress.get()) != SQLITE_DONE) {
+        throw DatabaseException("Failed to record backfill progress: " + database.getLastError());
+    }
+
+    createFtsTriggers(database, index, true);
+}
+
+bool backfillFtsIndex(Database& database, const FtsIndex& index, size_t chunk_rows) {
+    Statement progress = database.prepare("SELECT done_id, last_id FROM schema_backfill WHERE name = ?");
+    sqlite3_bind_text(progress.get(), 1, index.table, -1, SQLITE_STATIC);
+
+    int result = sqlite3_step(progress.get());
+    if (result == SQLITE_DONE) {
+        return true;
+    }
+    if (result != SQLITE_ROW) {
+        throw DatabaseException("Failed to read backfill progress: " + database.getLastError());
+    }
+    sqlite3_int64 done_id = sqlite3_column_int64(progress.get(), 0);
+    sqlite3_int64 last_id = sqlite3_column_int64(progress.get(), 1);
+
+    // Find the end of this chunk, then copy it
+    Statement chunk_end = database.prepare(
+        "SELECT MAX(id) FROM (SELECT id FROM todos WHERE id > ? AND id <= ? ORDER BY id LIMIT ?)");
+    sqlite3_bind_int64(chunk_end.get(), 1, done_id);
+    sqlite3_bind_int64(chunk_end.get(), 2, last_id);
+    sqlite3_bind_int64(chunk_end.get(), 3, static_cast<sqlite3_int64>(chunk_rows));
+    if (sqlite3_step(chunk_end.get()) != SQLITE_ROW) {
+        throw DatabaseException("Failed to read todo ids: " + database.getLastError());
+    }
+    sqlite3_int64 end_id = sqlite3_column_type(chunk_end.get(), 0) == SQLITE_NULL
+        ? last_id : sqlite3_column_int64(chunk_end.get(), 0);
+
+    std::string table = index.table;
+    Statement copy = database.prepare(
+        "INSERT INTO " + table + "(rowid, " + index.columns + ") "
+        "SELECT id, " + index.columns + " FROM todos WHERE id > ? AND id <= ?");
+    sqlite3_bind_int64(copy.get(), 1, done_id);
+    sqlite3_bind_int64(copy.get(), 2, end_id);
+    if (sqlite3_step(copy.get()) != SQLITE_DONE) {
+        throw DatabaseException("Failed to backfill " + table + ": " + database.getLastError());
+    }
+
+    Statement advance = database.prepare("UPDATE schema_backfill SET done_id = ? WHERE name = ?");
+    sqlite3_bind_int64(advance.get(), 1, end_id);
+    sqlite3_bind_text(advance.get(), 2, index.table, -1, SQLITE_STATIC);
+    if (sqlite3_step(advance.get()) != SQLITE_DONE) {
+        throw DatabaseException("Failed to record backfill progress: " + database.getLastError());
+    }
+
+    return end_id >= last_id;
+}
+
+void finishFtsIndex(Database& database, const FtsIndex& index) {
+    Statement progress = database.prepare("DELETE FROM schema_backfill WHERE name = ?");
+    sqlite3_bind_text(progress.get(), 1, index.table, -1, SQLITE_STATIC);
+    if (sqlite3_step(progress.get()) != SQLITE_DONE) {
+        throw DatabaseException("Failed to clear backfill progress: " + database.getLastError());
+    }
+
+    createFtsTriggers(database, index, false);
+}
+
+const std::vector<Migration> kMigrations = {
+    {
+        1, "Create the todos table",
+        [](Database& database) {
+            database.execute(R"(
+                CREATE TABLE IF NOT EXISTS todos (
+                    id INTEGER PRIMARY KEY AUTOINCREMENT,
+                    title TEXT NOT NULL,
+                    description TEXT,
+                    completed INTEGER DEFAULT 0,
+                    created_at INTEGER NOT NULL
+                );
+
+                CREATE INDEX IF NOT EXISTS idx_todos_completed
+                ON todos(completed);
+            )");
+        },
+    },
+    {
+        // Indexes matching the list ordering (newest first, id as
+        // tie-breaker), used for ordered scans and keyset pagination.
+        // SQLite builds a b-tree index in a single statement.
+        2, "Add indexes for ordered listing",
+        [](Database& database) {
+            database.execute(R"(
+                CREATE INDEX IF NOT EXISTS idx_todos_created_at
+                ON todos(created_at, id);
+                CREATE INDEX IF NOT EXISTS idx_todos_completed_created_at
+                ON todos(completed, created_at, id);
+            )");
+        },
+    },
+    {
+        3, "Add the full-text index over titles and descriptions",
+        [](Database& database) { applyFtsIndex(database, kFullTextIndex); },
+        [](Database& database, size_t chunk_rows) { return backfillFtsIndex(database, kFullTextIndex, chunk_rows); },
+        [](Database& database) { finishFtsIndex(database, kFullTextIndex); },
+    },
+    {
+        4, "Add the trigram index over titles for substring search",
+        [](Database& database) { applyFtsIndex(database, kTrigramIndex); },
+        [](Database& database, size_t chunk_rows) { return backfillFtsIndex(database, kTrigramIndex, chunk_rows); },
+        [](Database& database) { finishFtsIndex(database, kTrigramIndex); },
+    },
+    {
+        // Single-row summary of item counts, maintained by triggers so
+        // that statistics never need to scan the todos table
+        5, "Add the trigger-maintained statistics summary",
+        [](Database& database) {
+            database.execute(R"(
+                CREATE TABLE IF NOT EXISTS todo_stats (
+                    id INTEGER PRIMARY KEY CHECK (id = 1),
+                    total INTEGER NOT NULL,
+                    completed INTEGER NOT NULL
+                );
+
+                CREATE TRIGGER IF NOT EXISTS todo_stats_insert AFTER INSERT ON todos BEGIN
+                    UPDATE todo_stats SET total = total + 1,
+                                          completed = completed + (new.completed = 1);
+                END;
+
+                CREATE TRIGGER IF NOT EXISTS todo_stats_delete AFTER DELETE ON todos BEGIN
+                    UPDATE todo_stats SET total = total - 1,
+                                          completed = completed - (old.completed = 1);
+                END;
+
+                CREATE TRIGGER IF NOT EXISTS todo_stats_update AFTER UPDATE OF completed ON todos
+                WHEN (old.completed = 1) IS NOT (new.completed = 1) BEGIN
+                    UPDATE todo_stats SET completed = completed + (new.completed = 1) - (old.completed = 1);
+                END;
+
+                INSERT OR IGNORE INTO todo_stats(id, total, completed)
+                SELECT 1, COUNT(*), COALESCE(SUM(completed = 1), 0) FROM todos;
+            )");
+        },
+    },
+    {
+        // Progress of a bulk import, so that an interrupted one resumes
+        // where it stopped, and the indexes it dropped for the load, to be
+        // recreated when it finishes
+        6, "Add bulk import checkpoints",
+        [](Database& database) {
+            database.execute(R"(
+                CREATE TABLE IF NOT EXISTS import_checkpoint (
+                    id INTEGER PRIMARY KEY CHECK (id = 1),
+                    source TEXT NOT NULL,
+                    position INTEGER NOT NULL,
+                    line INTEGER NOT NULL,
+                    imported_rows INTEGER NOT NULL,
+                    after_id INTEGER NOT NULL
+                );
+
+                CREATE TABLE IF NOT EXISTS import_deferred (
+                    name TEXT PRIMARY KEY,
+                    sql TEXT NOT NULL
+                );
+            )");
+        },
+    },
+    {
+        // A count of the rows written to todos, so that a snapshot file can
+        // tell whether it is current from the database contents rather
+        // than from file metadata alone. The update trigger now fires for
+        // every update to count it, and still adjusts the completed count.
+        7, "Count changes to todos",
+        [](Database& database) {
+            if (!columnExists(database, "todo_stats", "changes")) {
+                database.execute("ALTER TABLE todo_stats ADD COLUMN changes INTEGER NOT NULL DEFAULT 0");
+            }
+            database.execute(R"(
+                DROP TRIGGER IF EXISTS todo_stats_insert;
+                DROP TRIGGER IF EXISTS todo_stats_delete;
+                DROP TRIGGER IF EXISTS todo_stats_update;
+
+                CREATE TRIGGER todo_stats_insert AFTER INSERT ON todos BEGIN
+                    UPDATE todo_stats SET total = total + 1,
+                                          completed = completed + (new.completed = 1),
+                                          changes = changes + 1;
+                END;
+
+                CREATE TRIGGER todo_stats_delete AFTER DELETE ON todos BEGIN
+                    UPDATE todo_stats SET total = total - 1,
+                                          completed = completed - (old.completed = 1),
+                                          changes = changes + 1;
+                END;
+
+                CREATE TRIGGER todo_stats_update AFTER UPDATE ON todos BEGIN
+                    UPDATE todo_stats SET completed = completed + (new.completed = 1) - (old.completed = 1),
+                                          changes = changes + 1;
+                END;
+            )");
+        },
+    },
+};
+
+} // anonymous namespace
+
+const std::vector<Migration>& schemaMigrations() {
+    return kMigrations;
+}
+
+int latestSchemaVersion() {
+    return kMigrations.back().version;
+}
+
+void indexInsertedTodos(Database& database, int64_t after_id) {
+    for (const FtsIndex* index : {&kFullTextIndex, &kTrigramIndex}) {
+        std::string table = index->table;
+        Statement copy = database.prepare(
+            "INSERT INTO " + table + "(rowid, " + index->columns + ") "
+            "SELECT id, " + index->columns + " FROM todos WHERE id > ?");
+        sqlite3_bind_int64(copy.get(), 1, after_id);
+        if (sqlite3_step(copy.get()) != SQLITE_DONE) {
+            throw DatabaseException("Failed to index " + table + ": " + database.getLastError());
+        }
+    }
+
+    Statement stats = database.prepare(
+        "UPDATE todo_stats SET total = total + (SELECT COUNT(*) FROM todos WHERE id > ?1), "
+        "completed = completed + (SELECT COUNT(*) FROM todos WHERE id > ?1 AND completed = 1), "
+        "changes = changes + 1");
+    sqlite3_bind_int64(stats.get(), 1, after_id);
+    if (sqlite3_step(stats.get()) != SQLITE_DONE) {
+        throw DatabaseException("Failed to update statistics: " + database.getLastError());
+    }
+}
+
+const std::vector<std::string>& bulkInsertTriggers() {
+    static const std::vector<std::string> triggers = {
+        std::string(kFullTextIndex.table) + "_insert",
+        std::string(kTrigramIndex.table) + "_insert",
+        "todo_stats_insert",
+    };
+    return triggers;
+}
+
+void runMigrations(Database& database, size_t chunk_rows) {
+    if (chunk_rows == 0) {
+        chunk_rows = 1;
+    }
+
+    for (const auto& migration : kMigrations) {
+        if (database.schemaVersion() >= migration.version) {
+            continue;
+        }
+
+        {
+            Transaction transaction(database, TransactionMode::IMMEDIATE);
+            // Another process may have migrated while we waited for the lock
+            if (database.schemaVersion() >= migration.version) {
+                continue;
+            }
+            migration.apply(database);
+            if (!migration.backfill) {
+                setSchemaVersion(database, migration.version);
+                transaction.commit();
+                continue;
+            }
+            transaction.commit();
+        }
+
+        bool done = false;
+        while (!done) {
+            Transaction transaction(database, TransactionMode::IMMEDIATE);
+            done = migration.backfill(database, chunk_rows);
+            transaction.commit();
+        }
+
+        Transaction transaction(database, TransactionMode::IMMEDIATE);
+        if (database.schemaVersion() < migration.version) {
+            if (migration.finish) {
+                migration.finish(database);
+            }
+            setSchemaVersion(database, migration.version);
+        }
+        transaction.commit();
+    }
+}
+
+} // namespace todolist
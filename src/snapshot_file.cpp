@@ -0,0 +1,518 @@
+#include "todolist/snapshot_file.h"
+#include "todolist/exceptions.h"
+#include "todolist/todo_snapshot.h"
+#include <sqlite3.h>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+
+#ifdef _WIN32
+#include <chrono>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define TODOLIST_X86_CRC32 1
+#include <immintrin.h>
+#endif
+
+namespace todolist {
+
+namespace {
+
+constexpr char kMagic[8] = {'T', 'O', 'D', 'O', 'S', 'N', 'A', 'P'};
+
+/// Completion flag bit of SnapshotRecord::flags
+constexpr std::uint32_t kCompletedFlag = 1;
+
+/**
+ * @brief Fixed header at the start of a snapshot file
+ */
+struct SnapshotHeader {
+    char magic[8];                 ///< kMagic
+    std::uint32_t version;         ///< SnapshotFile::kVersion
+    std::uint32_t header_size;     ///< sizeof(SnapshotHeader)
+    std::uint64_t record_count;    ///< Number of records
+    std::uint64_t completed_count; ///< Number of records with kCompletedFlag
+    std::uint64_t heap_size;       ///< Bytes in the string heap
+    DatabaseStamp stamp;           ///< Database state the snapshot was taken at
+    std::uint32_t checksum;        ///< CRC-32C of the bytes before this field and everything after the header
+    std::uint32_t reserved;        ///< Zero
+};
+
+/**
+ * @brief One todo item in the record table
+ */
+struct SnapshotRecord {
+    std::int64_t created_at;          ///< Unix seconds
+    std::int32_t id;                  ///< Todo item id
+    std::uint32_t flags;              ///< kCompletedFlag
+    std::uint32_t title_offset;       ///< Title position in the heap
+    std::uint32_t title_size;         ///< Title length in bytes
+    std::uint32_t description_offset; ///< Description position in the heap
+    std::uint32_t description_size;   ///< Description length in bytes
+};
+
+static_assert(sizeof(DatabaseStamp) == 72, "DatabaseStamp is stored in the file header");
+static_assert(sizeof(SnapshotHeader) == 120, "Snapshot header layout changed");
+static_assert(sizeof(SnapshotRecord) == 32, "Snapshot record layout changed");
+
+constexpr size_t kChecksumOffset = offsetof(SnapshotHeader, checksum);
+
+/**
+ * @brief Byte-at-a-time CRC-32C table for the reflected polynomial 0x82F63B78
+ */
+const std::array<std::uint32_t, 256>& crcTable() {
+    static const std::array<std::uint32_t, 256> table = [] {
+        std::array<std::uint32_t, 256> entries{};
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            std::uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1u)));
+            }
+            entries[i] = crc;
+        }
+        return entries;
+    }();
+    return table;
+}
+
+std::uint32_t crc32cScalar(const unsigned char* data, size_t size, std::uint32_t crc) {
+    const auto& table = crcTable();
+    for (size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ data[i]) & 0xFFu] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+#ifdef TODOLIST_X86_CRC32
+
+__attribute__((target("sse4.2")))
+std::uint32_t crc32cSse42(const unsigned char* data, size_t size, std::uint32_t crc) {
+#if defined(__x86_64__)
+    std::uint64_t wide = crc;
+    for (; size >= 8; data += 8, size -= 8) {
+        std::uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        wide = _mm_crc32_u64(wide, word);
+    }
+    crc = static_cast<std::uint32_t>(wide);
+#endif
+    for (; size >= 4; data += 4, size -= 4) {
+        std::uint32_t word;
+        std::memcpy(&word, data, sizeof(word));
+        crc = _mm_crc32_u32(crc, word);
+    }
+    for (; size > 0; ++data, --size) {
+        crc = _mm_crc32_u8(crc, *data);
+    }
+    return crc;
+}
+
+bool hasSse42() {
+    static const bool supported = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse4.2") != 0;
+    }();
+    return supported;
+}
+
+#endif // TODOLIST_X86_CRC32
+
+/**
+ * @brief Decode a big-endian 32-bit integer, as SQLite stores them
+ */
+std::uint32_t readBigEndian32(const unsigned char* bytes) {
+    return (std::uint32_t{bytes[0]} << 24) | (std::uint32_t{bytes[1]} << 16) |
+           (std::uint32_t{bytes[2]} << 8) | std::uint32_t{bytes[3]};
+}
+
+/**
+ * @brief Read bytes from a file, returning false if it is missing or too short
+ */
+bool readFileBytes(const std::string& path, std::streamoff offset, unsigned char* buffer, size_t size) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file || !file.seekg(offset)) {
+        return false;
+    }
+    file.read(reinterpret_cast<char*>(buffer), static_cast<std::streamsize>(size));
+    return file.gcount() == static_cast<std::streamsize>(size);
+}
+
+/**
+ * @brief Fill the stat()-derived fields of a stamp
+ * @return false if the file does not exist
+ */
+bool statFile(const std::string& path, std::uint64_t& size, std::uint64_t& mtime_ns,
+              std::uint64_t* device, std::uint64_t* inode) {
+#ifdef _WIN32
+    std::error_code error;
+    auto bytes = std::filesystem::file_size(path, error);
+    if (error) {
+        return false;
+    }
+    auto modified = std::filesystem::last_write_time(path, error);
+    size = bytes;
+    mtime_ns = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(modified.time_since_epoch()).count());
+    (void)device;
+    (void)inode;
+#else
+    struct stat info;
+    if (::stat(path.c_str(), &info) != 0) {
+        return false;
+    }
+#if defined(__APPLE__)
+    const struct timespec& modified = info.st_mtimespec;
+#else
+    const struct timespec& modified = info.st_mtim;
+#endif
+    size = static_cast<std::uint64_t>(info.st_size);
+    mtime_ns = static_cast<std::uint64_t>(modified.tv_sec) * 1000000000u +
+               static_cast<std::uint64_t>(modified.tv_nsec);
+    if (device) {
+        *device = static_cast<std::uint64_t>(info.st_dev);
+    }
+    if (inode) {
+        *inode = static_cast<std::uint64_t>(info.st_ino);
+    }
+#endif
+    return true;
+}
+
+/**
+ * @brief Read the change count on a bare read-only connection
+ * @param db_path Path to the database file
+ * @param changes Receives the count
+ * @return false if the database cannot be opened or queried
+ *
+ * Database would apply every connection setting and check the schema
+ * version first; this needs one statement and nothing else.
+ */
+bool readChangesDirect(const std::string& db_path, std::uint64_t& changes) {
+    sqlite3* db = nullptr;
+    bool found = false;
+    if (sqlite3_open_v2(db_path.c_str(), &db, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX, nullptr) == SQLITE_OK) {
+        // As in Database: closing must not rewrite the files the stamp reads
+        sqlite3_db_config(db, SQLITE_DBCONFIG_NO_CKPT_ON_CLOSE, 1, nullptr);
+
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(db, "SELECT changes FROM todo_stats WHERE id = 1", -1, &stmt, nullptr) == SQLITE_OK) {
+            int result = sqlite3_step(stmt);
+            if (result == SQLITE_ROW || result == SQLITE_DONE) {
+                changes = result == SQLITE_ROW ? static_cast<std::uint64_t>(sqlite3_column_int64(stmt, 0)) : 0;
+                found = true;
+            }
+        }
+        sqlite3_finalize(stmt);
+    }
+    sqlite3_close(db);
+    return found;
+}
+
+/**
+ * @brief Append the raw bytes of a trivially copyable value
+ */
+template <typename T>
+void appendBytes(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/**
+ * @brief Convert a heap position to the 32-bit form stored in records
+ * @throws TodoListException if the heap has outgrown the format
+ */
+std::uint32_t heapPosition(size_t value) {
+    if (value > std::numeric_limits<std::uint32_t>::max()) {
+        throw TodoListException("Todo list is too large for a snapshot file");
+    }
+    return static_cast<std::uint32_t>(value);
+}
+
+} // anonymous namespace
+
+std::uint32_t crc32c(const void* data, size_t size, std::uint32_t crc) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+#ifdef TODOLIST_X86_CRC32
+    if (hasSse42()) {
+        return ~crc32cSse42(bytes, size, crc);
+    }
+#endif
+    return ~crc32cScalar(bytes, size, crc);
+}
+
+DatabaseStamp DatabaseStamp::of(const std::string& db_path) {
+    DatabaseStamp stamp;
+    if (!statFile(db_path, stamp.size, stamp.mtime_ns, &stamp.device, &stamp.inode)) {
+        return stamp;
+    }
+
+    // Offset 24 of the database header: incremented by every commit in
+    // rollback-journal modes and by checkpoints in WAL mode
+    unsigned char counter[4];
+    if (readFileBytes(db_path, 24, counter, sizeof(counter))) {
+        stamp.change_counter = readBigEndian32(counter);
+    }
+
+    // Offsets 12-23 of the WAL header: checkpoint sequence and the salts,
+    // which change whenever the WAL is restarted from the beginning
+    std::string wal_path = db_path + "-wal";
+    if (statFile(wal_path, stamp.wal_size, stamp.wal_mtime_ns, nullptr, nullptr)) {
+        unsigned char header[12];
+        if (readFileBytes(wal_path, 12, header, sizeof(header))) {
+            stamp.change_counter |= std::uint64_t{readBigEndian32(header)} << 32;
+            stamp.wal_salt = (std::uint64_t{readBigEndian32(header + 4)} << 32) | readBigEndian32(header + 8);
+        }
+    }
+    return stamp;
+}
+
+bool DatabaseStamp::operator==(const DatabaseStamp& other) const {
+    return device == other.device && inode == other.inode && size == other.size &&
+           mtime_ns == other.mtime_ns && wal_size == other.wal_size &&
+           wal_mtime_ns == other.wal_mtime_ns && change_counter == other.change_counter &&
+           wal_salt == other.wal_salt && changes == other.changes;
+}
+
+std::uint64_t DatabaseStamp::readChanges(Database& database) {
+    Statement statement = database.prepare("SELECT changes FROM todo_stats WHERE id = 1");
+    int result = sqlite3_step(statement.get());
+    if (result == SQLITE_DONE) {
+        return 0;
+    }
+    if (result != SQLITE_ROW) {
+        throw DatabaseException("Failed to read change count: " + database.getLastError());
+    }
+    return static_cast<std::uint64_t>(sqlite3_column_int64(statement.get(), 0));
+}
+
+SnapshotFile::~SnapshotFile() {
+#ifndef _WIN32
+    if (data_) {
+        ::munmap(const_cast<unsigned char*>(data_), size_);
+    }
+#endif
+}
+
+std::unique_ptr<SnapshotFile> SnapshotFile::open(const std::string& path) {
+    std::unique_ptr<SnapshotFile> snapshot(new SnapshotFile());
+
+#ifdef _WIN32
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return nullptr;
+    }
+    snapshot->buffer_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    snapshot->data_ = snapshot->buffer_.data();
+    snapshot->size_ = snapshot->buffer_.size();
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(SnapshotHeader))) {
+        ::close(fd);
+        return nullptr;
+    }
+    // The mapping stays valid after close, and after the file is replaced
+    size_t size = static_cast<size_t>(info.st_size);
+    void* mapped = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        return nullptr;
+    }
+    snapshot->data_ = static_cast<const unsigned char*>(mapped);
+    snapshot->size_ = size;
+#endif
+
+    if (!snapshot->validate()) {
+        return nullptr;
+    }
+    return snapshot;
+}
+
+std::unique_ptr<SnapshotFile> SnapshotFile::openCurrent(const std::string& db_path) {
+    std::unique_ptr<SnapshotFile> snapshot = open(pathFor(db_path));
+    if (!snapshot) {
+        return nullptr;
+    }
+
+    // The file fields rule out most changes without opening SQLite
+    DatabaseStamp stamp = DatabaseStamp::of(db_path);
+    stamp.changes = snapshot->stamp().changes;
+    if (snapshot->stamp() != stamp) {
+        return nullptr;
+    }
+
+    std::uint64_t changes = 0;
+    if (!readChangesDirect(db_path, changes) || changes != stamp.changes) {
+        return nullptr;
+    }
+    return snapshot;
+}
+
+bool SnapshotFile::validate() {
+    if (size_ < sizeof(SnapshotHeader)) {
+        return false;
+    }
+
+    SnapshotHeader header;
+    std::memcpy(&header, data_, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+        header.header_size != sizeof(SnapshotHeader)) {
+        return false;
+    }
+
+    // Sizes are checked before multiplying so a damaged count cannot overflow
+    size_t body = size_ - sizeof(SnapshotHeader);
+    if (header.record_count > body / sizeof(SnapshotRecord) ||
+        header.heap_size != body - header.record_count * sizeof(SnapshotRecord) ||
+        header.completed_count > header.record_count) {
+        return false;
+    }
+
+    std::uint32_t checksum = crc32c(data_, kChecksumOffset);
+    checksum = crc32c(data_ + sizeof(SnapshotHeader), body, checksum);
+    if (checksum != header.checksum) {
+        return false;
+    }
+
+    record_count_ = static_cast<size_t>(header.record_count);
+    completed_count_ = static_cast<size_t>(header.completed_count);
+    records_ = data_ + sizeof(SnapshotHeader);
+    heap_ = reinterpret_cast<const char*>(records_ + record_count_ * sizeof(SnapshotRecord));
+    stamp_ = header.stamp;
+
+    // write() only produces records inside the heap, and the checksum
+    // shows the bytes are the ones it wrote, so view() can trust them
+    // without a sweep over every record here
+    return true;
+}
+
+TodoItemView SnapshotFile::view(size_t index) const {
+    SnapshotRecord record;
+    std::memcpy(&record, records_ + index * sizeof(SnapshotRecord), sizeof(record));
+    return TodoItemView(record.id,
+                        std::string_view(heap_ + record.title_offset, record.title_size),
+                        std::string_view(heap_ + record.description_offset, record.description_size),
+                        (record.flags & kCompletedFlag) != 0,
+                        static_cast<std::time_t>(record.created_at));
+}
+
+void SnapshotFile::write(const std::string& path, Database& database, DatabaseStamp stamp) {
+    // One read transaction, so the change count matches the items
+    Transaction transaction(database, TransactionMode::DEFERRED);
+    stamp.changes = DatabaseStamp::readChanges(database);
+    TodoSnapshot snapshot(database);
+    transaction.commit();
+
+    TodoSnapshot::Rows rows = snapshot.filter(TodoFilter::ALL);
+    snapshot.sortNewestFirst(rows);
+
+    std::string records;
+    std::string heap;
+    records.reserve(rows.size() * sizeof(SnapshotRecord));
+    size_t completed = 0;
+    for (TodoSnapshot::Row row : rows) {
+        std::string_view title = snapshot.title(row);
+        std::string_view description = snapshot.description(row);
+
+        SnapshotRecord record{};
+        record.created_at = snapshot.createdAt(row);
+        record.id = snapshot.id(row);
+        record.flags = snapshot.isCompleted(row) ? kCompletedFlag : 0;
+        record.title_offset = heapPosition(heap.size());
+        record.title_size = heapPosition(title.size());
+        heap.append(title.data(), title.size());
+        record.description_offset = heapPosition(heap.size());
+        record.description_size = heapPosition(description.size());
+        heap.append(description.data(), description.size());
+
+        appendBytes(records, record);
+        completed += snapshot.isCompleted(row);
+    }
+    // The bounds check readers rely on: every record ends within a heap
+    // that 32-bit offsets can address
+    heapPosition(heap.size());
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.header_size = sizeof(SnapshotHeader);
+    header.record_count = rows.size();
+    header.completed_count = completed;
+    header.heap_size = heap.size();
+    header.stamp = stamp;
+    header.checksum = crc32c(&header, kChecksumOffset);
+    header.checksum = crc32c(records.data(), records.size(), header.checksum);
+    header.checksum = crc32c(heap.data(), heap.size(), header.checksum);
+
+    // Write beside the target and rename over it, so readers never see a
+    // partially written file
+    std::string temp_path = path + ".tmp" + std::to_string(std::random_device()());
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(records.data(), static_cast<std::streamsize>(records.size()));
+        file.write(heap.data(), static_cast<std::streamsize>(heap.size()));
+        file.close();
+        if (!file) {
+            std::filesystem::remove(temp_path);
+            throw TodoListException("Failed to write snapshot file: " + temp_path);
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temp_path, path, error);
+    if (error) {
+        std::filesystem::remove(temp_path);
+        throw TodoListException("Failed to replace snapshot file " + path + ": " + error.message());
+    }
+}
+
+bool SnapshotFile::refresh(const std::string& db_path, Database& database, bool create) {
+    if (db_path.empty() || db_path == ":memory:") {
+        return false;
+    }
+
+    try {
+        std::string path = pathFor(db_path);
+
+        // Taken before the database is read: a write that lands while the
+        // snapshot is being built changes the stamp and marks it stale
+        DatabaseStamp stamp = DatabaseStamp::of(db_path);
+        stamp.changes = DatabaseStamp::readChanges(database);
+
+        if (create) {
+            // A full check, since the caller may just have rejected the file
+            std::unique_ptr<SnapshotFile> current = open(path);
+            if (current && current->stamp() == stamp) {
+                return false;
+            }
+        } else {
+            SnapshotHeader header;
+            if (!readFileBytes(path, 0, reinterpret_cast<unsigned char*>(&header), sizeof(header)) ||
+                (std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+                 header.version == kVersion && header.stamp == stamp)) {
+                return false;
+            }
+        }
+
+        write(path, database, stamp);
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+} // namespace todolist
@@ -0,0 +1,237 @@
+#include "todolist/substring_matcher.h"
+#include <algorithm>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define TODOLIST_X86_SIMD 1
+#include <immintrin.h>
+#endif
+
+namespace todolist {
+
+namespace {
+
+inline char asciiLower(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+/**
+ * @brief Position and output of one findRows() call, shared by the kernels
+ *
+ * Kernels find candidate positions whose first and last bytes match;
+ * accept() checks the rest and maps the position to its row.
+ */
+class ArenaScan {
+public:
+    ArenaScan(const char* data, const size_t* offsets, const std::string& needle,
+              std::vector<std::uint32_t>& out)
+        : data_(data), offsets_(offsets), needle_(needle), out_(out) {}
+
+    /**
+     * @brief Verify a candidate start position
+     * @param position Offset whose first and last needle bytes already match
+     * @return true if the row holding it matches (and was emitted)
+     */
+    bool accept(size_t position) {
+        while (offsets_[row_ + 1] <= position) {
+            ++row_;
+        }
+
+        // A match must not run into the next row
+        size_t length = needle_.size();
+        if (position + length > offsets_[row_ + 1]) {
+            return false;
+        }
+        for (size_t i = 1; i + 1 < length; ++i) {
+            if (asciiLower(data_[position + i]) != needle_[i]) {
+                return false;
+            }
+        }
+
+        out_.push_back(static_cast<std::uint32_t>(row_));
+        return true;
+    }
+
+    /**
+     * @brief Move past the row that just matched
+     * @return Offset at which scanning continues
+     */
+    size_t nextRow() {
+        return offsets_[++row_];
+    }
+
+private:
+    const char* data_;
+    const size_t* offsets_;
+    const std::string& needle_;
+    std::vector<std::uint32_t>& out_;
+    size_t row_ = 0;
+};
+
+/**
+ * @brief Byte-at-a-time kernel; also finishes the tail for the vector kernels
+ */
+void scanScalar(const char* data, size_t position, size_t end, const std::string& needle, ArenaScan& scan) {
+    size_t length = needle.size();
+    char first = needle.front();
+    char last = needle.back();
+
+    while (position + length <= end) {
+        if (asciiLower(data[position]) == first && asciiLower(data[position + length - 1]) == last &&
+            scan.accept(position)) {
+            position = scan.nextRow();
+            continue;
+        }
+        ++position;
+    }
+}
+
+#ifdef TODOLIST_X86_SIMD
+
+// Lowercase ASCII letters in a vector: add 0x20 where 'A' <= byte <= 'Z'.
+// The compares are signed, so bytes >= 0x80 are never treated as letters.
+
+__attribute__((target("sse2")))
+inline __m128i lower16(__m128i bytes) {
+    __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8('A' - 1)),
+                                    _mm_cmplt_epi8(bytes, _mm_set1_epi8('Z' + 1)));
+    return _mm_add_epi8(bytes, _mm_and_si128(letters, _mm_set1_epi8(0x20)));
+}
+
+__attribute__((target("sse2")))
+void scanSse2(const char* data, size_t position, size_t end, const std::string& needle, ArenaScan& scan) {
+    size_t length = needle.size();
+    __m128i first = _mm_set1_epi8(needle.front());
+    __m128i last = _mm_set1_epi8(needle.back());
+
+    while (position + length - 1 + 16 <= end) {
+        __m128i starts = lower16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position)));
+        __m128i ends = lower16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + position + length - 1)));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(starts, first), _mm_cmpeq_epi8(ends, last))));
+
+        size_t next = position + 16;
+        while (mask) {
+            size_t candidate = position + static_cast<size_t>(__builtin_ctz(mask));
+            mask &= mask - 1;
+            if (scan.accept(candidate)) {
+                next = scan.nextRow();
+                break;
+            }
+        }
+        position = next;
+    }
+
+    scanScalar(data, position, end, needle, scan);
+}
+
+__attribute__((target("avx2")))
+inline __m256i lower32(__m256i bytes) {
+    __m256i letters = _mm256_and_si256(_mm256_cmpgt_epi8(bytes, _mm256_set1_epi8('A' - 1)),
+                                       _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), bytes));
+    return _mm256_add_epi8(bytes, _mm256_and_si256(letters, _mm256_set1_epi8(0x20)));
+}
+
+__attribute__((target("avx2")))
+void scanAvx2(const char* data, size_t position, size_t end, const std::string& needle, ArenaScan& scan) {
+    size_t length = needle.size();
+    __m256i first = _mm256_set1_epi8(needle.front());
+    __m256i last = _mm256_set1_epi8(needle.back());
+
+    while (position + length - 1 + 32 <= end) {
+        __m256i starts = lower32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + position)));
+        __m256i ends = lower32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + position + length - 1)));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(starts, first), _mm256_cmpeq_epi8(ends, last))));
+
+        size_t next = position + 32;
+        while (mask) {
+            size_t candidate = position + static_cast<size_t>(__builtin_ctz(mask));
+            mask &= mask - 1;
+            if (scan.accept(candidate)) {
+                next = scan.nextRow();
+                break;
+            }
+        }
+        position = next;
+    }
+
+    scanSse2(data, position, end, needle, scan);
+}
+
+#endif // TODOLIST_X86_SIMD
+
+} // anonymous namespace
+
+SimdLevel detectSimdLevel() {
+#ifdef TODOLIST_X86_SIMD
+    static const SimdLevel level = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            return SimdLevel::AVX2;
+        }
+        if (__builtin_cpu_supports("sse2")) {
+            return SimdLevel::SSE2;
+        }
+        return SimdLevel::SCALAR;
+    }();
+    return level;
+#else
+    return SimdLevel::SCALAR;
+#endif
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::SCALAR: return "scalar";
+        case SimdLevel::SSE2:   return "sse2";
+        case SimdLevel::AVX2:   return "avx2";
+    }
+    return "scalar";
+}
+
+SubstringMatcher::SubstringMatcher(std::string_view needle, SimdLevel level)
+    : needle_(needle)
+    , level_(std::min(level, detectSimdLevel()))
+{
+    std::transform(needle_.begin(), needle_.end(), needle_.begin(), asciiLower);
+}
+
+bool SubstringMatcher::matches(std::string_view text) const {
+    const size_t offsets[] = {0, text.size()};
+    std::vector<std::uint32_t> rows;
+    findRows(text.data(), offsets, 1, rows);
+    return !rows.empty();
+}
+
+void SubstringMatcher::findRows(const char* arena, const size_t* offsets, size_t rows,
+                                std::vector<std::uint32_t>& out) const {
+    if (rows == 0) {
+        return;
+    }
+    if (needle_.empty()) {
+        for (size_t row = 0; row < rows; ++row) {
+            out.push_back(static_cast<std::uint32_t>(row));
+        }
+        return;
+    }
+
+    ArenaScan scan(arena, offsets, needle_, out);
+    size_t start = offsets[0];
+    size_t end = offsets[rows];
+
+    switch (level_) {
+#ifdef TODOLIST_X86_SIMD
+        case SimdLevel::AVX2:
+            scanAvx2(arena, start, end, needle_, scan);
+            return;
+        case SimdLevel::SSE2:
+            scanSse2(arena, start, end, needle_, scan);
+            return;
+#endif
+        default:
+            scanScalar(arena, start, end, needle_, scan);
+            return;
+    }
+}
+
+} // namespace todolist
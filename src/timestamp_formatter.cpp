@@ -0,0 +1,190 @@
+#include "todolist/timestamp_formatter.h"
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+
+namespace todolist {
+
+namespace {
+
+constexpr std::int64_t kSecondsPerDay = 86400;
+
+std::int64_t floorDiv(std::int64_t value, std::int64_t divisor) {
+    std::int64_t quotient = value / divisor;
+    return quotient - ((value % divisor) < 0);
+}
+
+/**
+ * @brief Days since 1970-01-01 of a proleptic Gregorian date
+ *
+ * Howard Hinnant's days_from_civil: years are split into 400-year eras
+ * that start on March 1, so leap days fall at the end of each year.
+ */
+std::int64_t daysFromCivil(std::int64_t year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    const std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yearOfEra = static_cast<unsigned>(year - era * 400);
+    const unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + static_cast<std::int64_t>(dayOfEra) - 719468;
+}
+
+/**
+ * @brief Proleptic Gregorian date of a day number, the inverse of daysFromCivil
+ */
+void civilFromDays(std::int64_t days, std::int64_t& year, unsigned& month, unsigned& day) {
+    days += 719468;
+    const std::int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned dayOfEra = static_cast<unsigned>(days - era * 146097);
+    const unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    const unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    const unsigned monthIndex = (5 * dayOfYear + 2) / 153;
+    day = dayOfYear - (153 * monthIndex + 2) / 5 + 1;
+    month = monthIndex < 10 ? monthIndex + 3 : monthIndex - 9;
+    year = static_cast<std::int64_t>(yearOfEra) + era * 400 + (month <= 2);
+}
+
+bool localTime(std::time_t unix_time, std::tm& tm_time) {
+    #ifdef _WIN32
+        return localtime_s(&tm_time, &unix_time) == 0;
+    #else
+        return localtime_r(&unix_time, &tm_time) != nullptr;
+    #endif
+}
+
+/**
+ * @brief Seconds since the epoch of the wall-clock time in tm_time, as if it were UTC
+ */
+std::int64_t wallClockSeconds(const std::tm& tm_time) {
+    std::int64_t days = daysFromCivil(static_cast<std::int64_t>(tm_time.tm_year) + 1900,
+                                      static_cast<unsigned>(tm_time.tm_mon + 1),
+                                      static_cast<unsigned>(tm_time.tm_mday));
+    return days * kSecondsPerDay + tm_time.tm_hour * 3600 + tm_time.tm_min * 60 + tm_time.tm_sec;
+}
+
+/**
+ * @brief Local time minus UTC at a timestamp, in seconds
+ * @return false if the timestamp cannot be converted
+ */
+bool utcOffset(std::time_t unix_time, std::int64_t& offset) {
+    std::tm tm_time;
+    if (!localTime(unix_time, tm_time)) {
+        return false;
+    }
+    offset = wallClockSeconds(tm_time) - unix_time;
+    return true;
+}
+
+char* writeTwoDigits(char* out, unsigned value) {
+    out[0] = static_cast<char>('0' + value / 10);
+    out[1] = static_cast<char>('0' + value % 10);
+    return out + 2;
+}
+
+/**
+ * @brief Write "YYYY-MM-DD " (the year unpadded, as strftime's %Y)
+ * @return One past the last character written
+ */
+char* writeDate(char* out, std::int64_t year, unsigned month, unsigned day) {
+    out = std::to_chars(out, out + 20, year).ptr;
+    *out++ = '-';
+    out = writeTwoDigits(out, month);
+    *out++ = '-';
+    out = writeTwoDigits(out, day);
+    *out++ = ' ';
+    return out;
+}
+
+/**
+ * @brief Write "HH:MM:SS"
+ * @return One past the last character written
+ */
+char* writeClock(char* out, unsigned hour, unsigned minute, unsigned second) {
+    out = writeTwoDigits(out, hour);
+    *out++ = ':';
+    out = writeTwoDigits(out, minute);
+    *out++ = ':';
+    return writeTwoDigits(out, second);
+}
+
+char* writeClock(char* out, unsigned secondOfDay) {
+    return writeClock(out, secondOfDay / 3600, secondOfDay / 60 % 60, secondOfDay % 60);
+}
+
+} // anonymous namespace
+
+TimestampFormatter::TimestampFormatter() = default;
+
+size_t TimestampFormatter::format(std::time_t unix_time, char* buffer) {
+    if (const Day* day = findDay(unix_time)) {
+        std::memcpy(buffer, day->date, day->date_size);
+        char* end = writeClock(buffer + day->date_size, static_cast<unsigned>(unix_time - day->begin));
+        return static_cast<size_t>(end - buffer);
+    }
+
+    std::tm tm_time;
+    char* end;
+    if (localTime(unix_time, tm_time)) {
+        end = writeDate(buffer, static_cast<std::int64_t>(tm_time.tm_year) + 1900,
+                        static_cast<unsigned>(tm_time.tm_mon + 1), static_cast<unsigned>(tm_time.tm_mday));
+        end = writeClock(end, static_cast<unsigned>(tm_time.tm_hour), static_cast<unsigned>(tm_time.tm_min),
+                         static_cast<unsigned>(tm_time.tm_sec));
+    } else {
+        // Out of the range localtime handles; show UTC
+        std::int64_t days = floorDiv(unix_time, kSecondsPerDay);
+        std::int64_t year;
+        unsigned month;
+        unsigned day;
+        civilFromDays(days, year, month, day);
+        end = writeDate(buffer, year, month, day);
+        end = writeClock(end, static_cast<unsigned>(unix_time - days * kSecondsPerDay));
+    }
+    return static_cast<size_t>(end - buffer);
+}
+
+void TimestampFormatter::formatBatch(const std::time_t* times, size_t count, Text* out) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i].size = format(times[i], out[i].data);
+    }
+}
+
+TimestampFormatter& TimestampFormatter::forThread() {
+    thread_local TimestampFormatter formatter;
+    return formatter;
+}
+
+const TimestampFormatter::Day* TimestampFormatter::findDay(std::time_t unix_time) {
+    std::int64_t utcDay = floorDiv(unix_time, kSecondsPerDay);
+    Day& slot = days_[static_cast<size_t>(utcDay - floorDiv(utcDay, kCachedDays) * kCachedDays)];
+    if (unix_time >= slot.begin && unix_time < slot.end) {
+        return &slot;
+    }
+
+    std::tm tm_time;
+    if (!localTime(unix_time, tm_time) || tm_time.tm_sec > 59) {
+        return nullptr;
+    }
+    std::int64_t offset = wallClockSeconds(tm_time) - unix_time;
+
+    // The day is cached only if the offset is the same at both ends of it
+    std::int64_t localDay = floorDiv(unix_time + offset, kSecondsPerDay);
+    std::int64_t begin = localDay * kSecondsPerDay - offset;
+    std::int64_t end = begin + kSecondsPerDay;
+    std::int64_t beginOffset;
+    std::int64_t endOffset;
+    if (!utcOffset(static_cast<std::time_t>(begin), beginOffset) || beginOffset != offset ||
+        !utcOffset(static_cast<std::time_t>(end - 1), endOffset) || endOffset != offset) {
+        return nullptr;
+    }
+
+    std::int64_t year;
+    unsigned month;
+    unsigned day;
+    civilFromDays(localDay, year, month, day);
+    slot.begin = static_cast<std::time_t>(begin);
+    slot.end = static_cast<std::time_t>(end);
+    slot.date_size = static_cast<size_t>(writeDate(slot.date, year, month, day) - slot.date);
+    return &slot;
+}
+
+} // namespace todolist
@@ -1,6 +1,5 @@
 #include "todolist/todo_item.h"
-#include <sstream>
-#include <iomanip>
+#include "todolist/timestamp_formatter.h"
 
 namespace todolist {
 
@@ -41,19 +40,29 @@ TodoItem::TimePoint TodoItem::fromUnixTime(std::time_t unix_time) {
 }
 
 std::string TodoItem::getFormattedCreatedAt() const {
-    std::time_t time = getCreatedAtUnix();
-    std::tm tm_time;
-
-    // Use localtime_r for thread safety (POSIX)
-    #ifdef _WIN32
-        localtime_s(&tm_time, &time);
-    #else
-        localtime_r(&time, &tm_time);
-    #endif
-
-    std::ostringstream oss;
-    oss << std::put_time(&tm_time, "%Y-%m-%d %H:%M:%S");
-    return oss.str();
+    char buffer[kFormattedTimeSize];
+    return std::string(buffer, formatCreatedAt(buffer));
+}
+
+size_t TodoItem::formatCreatedAt(char* buffer) const {
+    return formatUnixTime(getCreatedAtUnix(), buffer);
+}
+
+size_t TodoItem::formatUnixTime(std::time_t unix_time, char* buffer) {
+    return TimestampFormatter::forThread().format(unix_time, buffer);
+}
+
+TodoItem TodoItemView::toItem() const {
+    return TodoItem(id_, std::string(title_), std::string(description_), completed_,
+                    TodoItem::fromUnixTime(created_at_));
+}
+
+void TodoItemView::copyTo(TodoItem& item) const {
+    item.setId(id_);
+    item.setTitle(title_);
+    item.setDescription(description_);
+    item.setCompleted(completed_);
+    item.setCreatedAt(TodoItem::fromUnixTime(created_at_));
 }
 
 } // namespace todolist
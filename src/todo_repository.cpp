@@ -1,42 +1,142 @@
 #include "todolist/todo_repository.h"
+#include "todolist/exceptions.h"
 #include <sqlite3.h>
+#include <limits>
 #include <sstream>
 
 namespace todolist {
 
-TodoRepository::TodoRepository(Database& database)
+namespace {
+
+/**
+ * @brief Encode a (created_at, id) position as an opaque page cursor
+ */
+std::string encodeCursor(sqlite3_int64 created_at, int id) {
+    std::ostringstream oss;
+    oss << std::hex << created_at << "-" << id;
+    return oss.str();
+}
+
+/**
+ * @brief Decode a page cursor produced by encodeCursor()
+ * @throws ValidationException if the cursor is malformed
+ */
+void decodeCursor(const std::string& cursor, sqlite3_int64& created_at, int& id) {
+    size_t dash = cursor.find('-');
+    bool valid = dash != std::string::npos && dash > 0 && dash + 1 < cursor.size() &&
+                 dash <= 16 && cursor.size() - dash - 1 <= 8 &&
+                 cursor.find_first_not_of("0123456789abcdef") == dash &&
+                 cursor.find_first_not_of("0123456789abcdef", dash + 1) == std::string::npos;
+
+    if (!valid) {
+        throw ValidationException("Invalid page cursor: " + cursor);
+    }
+
+    // Eight hex digits fit an unsigned long but not necessarily an int
+    unsigned long cursor_id = std::stoul(cursor.substr(dash + 1), nullptr, 16);
+    if (cursor_id > static_cast<unsigned long>(std::numeric_limits<int>::max())) {
+        throw ValidationException("Invalid page cursor: " + cursor);
+    }
+
+    created_at = static_cast<sqlite3_int64>(std::stoull(cursor.substr(0, dash), nullptr, 16));
+    id = static_cast<int>(cursor_id);
+}
+
+/**
+ * @brief Convert user input into an FTS5 query
+ *
+ * Each whitespace-separated word becomes a quoted prefix term ("word"*),
+ * so operators and punctuation in the input are matched literally and
+ * all words must be present.
+ */
+std::string toFtsQuery(const std::string& query) {
+    std::string fts_query;
+    std::istringstream words(query);
+    std::string word;
+
+    while (words >> word) {
+        if (!fts_query.empty()) {
+            fts_query += ' ';
+        }
+        fts_query += '"';
+        for (char c : word) {
+            if (c == '"') {
+                fts_query += '"';
+            }
+            fts_query += c;
+        }
+        fts_query += "\"*";
+    }
+
+    return fts_query;
+}
+
+/**
+ * @brief Check whether a substring query is long enough for the trigram index
+ *
+ * Patterns shorter than three characters contain no complete trigram, and a
+ * plain table scan is faster than scanning the index for them.
+ */
+bool useTrigramIndex(const std::string& query) {
+    size_t characters = 0;
+    for (char c : query) {
+        // Count UTF-8 lead bytes only
+        if ((static_cast<unsigned char>(c) & 0xC0) != 0x80) {
+            ++characters;
+        }
+    }
+    return characters >= 3;
+}
+
+/**
+ * @brief Adapt an item visitor to row views
+ *
+ * Each view is copied into the same item, so its string capacity is
+ * recycled from row to row.
+ */
+TodoViewVisitor copyingVisitor(TodoItem& item, const TodoVisitor& visitor) {
+    return [&item, &visitor](const TodoItemView& view) {
+        view.copyTo(item);
+        visitor(item);
+    };
+}
+
+} // anonymous namespace
+
+TodoRepository::TodoRepository(Database& database, size_t cache_capacity)
     : database_(database)
 {
+    if (cache_capacity > 0) {
+        cache_.emplace(cache_capacity);
+    }
 }
 
 TodoItem TodoRepository::create(const TodoItem& item) {
-    const char* sql = "INSERT INTO todos (title, description, completed, created_at) VALUES (?, ?, ?, ?)";
+    validateCache();
 
-    sqlite3_stmt* stmt = nullptr;
-    int result = sqlite3_prepare_v2(database_.getHandle(), sql, -1, &stmt, nullptr);
+    const char* sql = "INSERT INTO todos (title, description, completed, created_at) VALUES (?, ?, ?, ?)";
 
-    if (result != SQLITE_OK) {
-        throw DatabaseException("Failed to prepare insert statement: " + database_.getLastError());
-    }
+    Statement statement = database_.prepare(sql);
+    sqlite3_stmt* stmt = statement.get();
 
     // Bind parameters
-    sqlite3_bind_text(stmt, 1, item.getTitle().c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, item.getDescription().c_str(), -1, SQLITE_TRANSIENT);
+    // The item outlives the statement step, so the text can be bound without copying
+    sqlite3_bind_text(stmt, 1, item.getTitle().data(), static_cast<int>(item.getTitle().size()), SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, item.getDescription().data(), static_cast<int>(item.getDescription().size()), SQLITE_STATIC);
     sqlite3_bind_int(stmt, 3, item.isCompleted() ? 1 : 0);
     sqlite3_bind_int64(stmt, 4, static_cast<sqlite3_int64>(item.getCreatedAtUnix()));
 
     // Execute
-    result = sqlite3_step(stmt);
+    int result = sqlite3_step(stmt);
 
     if (result != SQLITE_DONE) {
         std::string error = database_.getLastError();
-        sqlite3_finalize(stmt);
         throw DatabaseException("Failed to insert todo item: " + error);
     }
 
     // Get the inserted id
     int id = static_cast<int>(sqlite3_last_insert_rowid(database_.getHandle()));
-    sqlite3_finalize(stmt);
+    noteWrite(id);
 
     // Return a copy with the id set
     TodoItem created_item = item;
@@ -44,252 +144,634 @@ TodoItem TodoRepository::create(const TodoItem& item) {
     return created_item;
 }
 
-std::optional<TodoItem> TodoRepository::findById(int id) {
-    const char* sql = "SELECT id, title, description, completed, created_at FROM todos WHERE id = ?";
+std::vector<int> TodoRepository::createBatch(const std::vector<TodoItem>& items) {
+    std::vector<int> ids;
+    ids.reserve(items.size());
+
+    if (items.empty()) {
+        return ids;
+    }
+
+    validateCache();
+
+    // A savepoint is its own transaction when none is open, and nests
+    // inside the caller's otherwise; either way a failure undoes only the batch
+    Savepoint savepoint(database_);
 
-    sqlite3_stmt* stmt = nullptr;
-    int result = sqlite3_prepare_v2(database_.getHandle(), sql, -1, &stmt, nullptr);
+    const char* sql = "INSERT INTO todos (title, description, completed, created_at) VALUES (?, ?, ?, ?)";
+
+    Statement statement = database_.prepare(sql);
+    sqlite3_stmt* stmt = statement.get();
+
+    for (const auto& item : items) {
+        sqlite3_bind_text(stmt, 1, item.getTitle().data(), static_cast<int>(item.getTitle().size()), SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 2, item.getDescription().data(), static_cast<int>(item.getDescription().size()), SQLITE_STATIC);
+        sqlite3_bind_int(stmt, 3, item.isCompleted() ? 1 : 0);
+        sqlite3_bind_int64(stmt, 4, static_cast<sqlite3_int64>(item.getCreatedAtUnix()));
+
+        if (sqlite3_step(stmt) != SQLITE_DONE) {
+            throw DatabaseException("Failed to insert todo item: " + database_.getLastError());
+        }
 
-    if (result != SQLITE_OK) {
-        throw DatabaseException("Failed to prepare select statement: " + database_.getLastError());
+        ids.push_back(static_cast<int>(sqlite3_last_insert_rowid(database_.getHandle())));
+        sqlite3_reset(stmt);
     }
 
+    savepoint.release();
+    noteWrite(std::nullopt);
+
+    return ids;
+}
+
+std::optional<TodoItem> TodoRepository::findById(int id) {
+    if (cache_) {
+        validateCache();
+        if (const TodoItem* cached = cache_->get(id)) {
+            return *cached;
+        }
+    }
+
+    const char* sql = "SELECT id, title, description, completed, created_at FROM todos WHERE id = ?";
+
+    Statement statement = database_.prepare(sql);
+    sqlite3_stmt* stmt = statement.get();
+
     sqlite3_bind_int(stmt, 1, id);
 
-    result = sqlite3_step(stmt);
+    int result = sqlite3_step(stmt);
 
     if (result == SQLITE_ROW) {
         TodoItem item = readTodoItem(stmt);
-        sqlite3_finalize(stmt);
+        if (cache_ && sqlite3_get_autocommit(database_.getHandle())) {
+            cache_->put(id, item);
+        }
         return item;
     }
 
-    sqlite3_finalize(stmt);
     return std::nullopt;
 }
 
 std::vector<TodoItem> TodoRepository::findAll() {
-    const char* sql = "SELECT id, title, description, completed, created_at FROM todos ORDER BY created_at DESC";
+    std::vector<TodoItem> items;
+    forEach(TodoFilter::ALL, [&items](const TodoItem& item) { items.push_back(item); });
+    return items;
+}
 
-    sqlite3_stmt* stmt = nullptr;
-    int result = sqlite3_prepare_v2(database_.getHandle(), sql, -1, &stmt, nullptr);
+std::vector<TodoItem> TodoRepository::findCompleted() {
+    std::vector<TodoItem> items;
+    forEach(TodoFilter::COMPLETED, [&items](const TodoItem& item) { items.push_back(item); });
+    return items;
+}
 
-    if (result != SQLITE_OK) {
-        throw DatabaseException("Failed to prepare select statement: " + database_.getLastError());
-    }
+std::vector<TodoItem> TodoRepository::findPending() {
+    std::vector<TodoItem> items;
+    forEach(TodoFilter::PENDING, [&items](const TodoItem& item) { items.push_back(item); });
+    return items;
+}
 
+std::vector<TodoItem> TodoRepository::findByTitle(const std::string& query) {
     std::vector<TodoItem> items;
-    while ((result = sqlite3_step(stmt)) == SQLITE_ROW) {
-        items.push_back(readTodoItem(stmt));
+    forEachByTitle(query, [&items](const TodoItem& item) { items.push_back(item); });
+    return items;
+}
+
+void TodoRepository::forEach(TodoFilter filter, const TodoVisitor& visitor) {
+    TodoItem item;
+    forEachView(filter, copyingVisitor(item, visitor));
+}
+
+void TodoRepository::forEachByTitle(const std::string& query, const TodoVisitor& visitor) {
+    TodoItem item;
+    forEachViewByTitle(query, copyingVisitor(item, visitor));
+}
+
+void TodoRepository::forEachView(TodoFilter filter, const TodoViewVisitor& visitor) {
+    const char* sql = nullptr;
+    const char* error_context = nullptr;
+
+    switch (filter) {
+        case TodoFilter::ALL:
+            sql = "SELECT id, title, description, completed, created_at FROM todos ORDER BY created_at DESC, id DESC";
+            error_context = "Error reading todo items: ";
+            break;
+        case TodoFilter::COMPLETED:
+            sql = "SELECT id, title, description, completed, created_at FROM todos WHERE completed = 1 ORDER BY created_at DESC, id DESC";
+            error_context = "Error reading completed items: ";
+            break;
+        case TodoFilter::PENDING:
+            sql = "SELECT id, title, description, completed, created_at FROM todos WHERE completed = 0 ORDER BY created_at DESC, id DESC";
+            error_context = "Error reading pending items: ";
+            break;
     }
 
-    sqlite3_finalize(stmt);
+    Statement statement = database_.prepare(sql);
+    visitRowViews(statement.get(), visitor, error_context);
+}
+
+void TodoRepository::forEachViewByTitle(const std::string& query, const TodoViewVisitor& visitor) {
+    // The trigram index finds candidate rows through its posting lists and
+    // verifies only those against the pattern
+    const char* sql = useTrigramIndex(query)
+        ? "SELECT t.id, t.title, t.description, t.completed, t.created_at "
+          "FROM todos_trigram JOIN todos t ON t.id = todos_trigram.rowid "
+          "WHERE todos_trigram.title LIKE ? ORDER BY t.created_at DESC, t.id DESC"
+        : "SELECT id, title, description, completed, created_at FROM todos WHERE title LIKE ? ORDER BY created_at DESC, id DESC";
+
+    Statement statement = database_.prepare(sql);
+    sqlite3_stmt* stmt = statement.get();
+
+    // Add wildcards for partial matching
+    std::string search_pattern = "%" + query + "%";
+    sqlite3_bind_text(stmt, 1, search_pattern.c_str(), -1, SQLITE_TRANSIENT);
+
+    visitRowViews(stmt, visitor, "Error searching todo items: ");
+}
+
+bool TodoRepository::update(const TodoItem& item) {
+    validateCache();
+
+    const char* sql = "UPDATE todos SET title = ?, description = ?, completed = ? WHERE id = ?";
+
+    Statement statement = database_.prepare(sql);
+    sqlite3_stmt* stmt = statement.get();
+
+    sqlite3_bind_text(stmt, 1, item.getTitle().data(), static_cast<int>(item.getTitle().size()), SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, item.getDescription().data(), static_cast<int>(item.getDescription().size()), SQLITE_STATIC);
+    sqlite3_bind_int(stmt, 3, item.isCompleted() ? 1 : 0);
+    sqlite3_bind_int(stmt, 4, item.getId());
+
+    int result = sqlite3_step(stmt);
 
     if (result != SQLITE_DONE) {
-        throw DatabaseException("Error reading todo items: " + database_.getLastError());
+        std::string error = database_.getLastError();
+        throw DatabaseException("Failed to update todo item: " + error);
     }
 
-    return items;
+    noteWrite(item.getId());
+    return sqlite3_changes(database_.getHandle()) > 0;
 }
 
-std::vector<TodoItem> TodoRepository::findCompleted() {
-    const char* sql = "SELECT id, title, description, completed, created_at FROM todos WHERE completed = 1 ORDER BY created_at DESC";
+bool TodoRepository::remove(int id) {
+    validateCache();
 
-    sqlite3_stmt* stmt = nullptr;
-    int result = sqlite3_prepare_v2(database_.getHandle(), sql, -1, &stmt, nullptr);
+    const char* sql = "DELETE FROM todos WHERE id = ?";
 
-    if (result != SQLITE_OK) {
-        throw DatabaseException("Failed to prepare select statement: " + database_.getLastError());
-    }
+    Statement statement = database_.prepare(sql);
+    sqlite3_stmt* stmt = statement.get();
 
-    std::vector<TodoItem> items;
-    while ((result = sqlite3_step(stmt)) == SQLITE_ROW) {
-        items.push_back(readTodoItem(stmt));
-    }
+    sqlite3_bind_int(stmt, 1, id);
 
-    sqlite3_finalize(stmt);
+    int result = sqlite3_step(stmt);
 
     if (result != SQLITE_DONE) {
-        throw DatabaseException("Error reading completed items: " + database_.getLastError());
+        std::string error = database_.getLastError();
+        throw DatabaseException("Failed to delete todo item: " + error);
     }
 
-    return items;
+    noteWrite(id);
+    return sqlite3_changes(database_.getHandle()) > 0;
 }
 
-std::vector<TodoItem> TodoRepository::findPending() {
-    const char* sql = "SELECT id, title, description, completed, created_at FROM todos WHERE completed = 0 ORDER BY created_at DESC";
+CompleteResult TodoRepository::markCompleted(int id) {
+    validateCache();
 
-    sqlite3_stmt* stmt = nullptr;
-    int result = sqlite3_prepare_v2(database_.getHandle(), sql, -1, &stmt, nullptr);
+    const char* sql = "UPDATE todos SET completed = 1 WHERE id = ? AND completed = 0 "
+                      "RETURNING id, title, description, completed, created_at";
 
-    if (result != SQLITE_OK) {
-        throw DatabaseException("Failed to prepare select statement: " + database_.getLastError());
+    Statement statement = database_.prepare(sql);
+    sqlite3_stmt* stmt = statement.get();
+
+    sqlite3_bind_int(stmt, 1, id);
+
+    int result = sqlite3_step(stmt);
+
+    if (result == SQLITE_ROW) {
+        TodoItem item = readTodoItem(stmt);
+        if (sqlite3_step(stmt) != SQLITE_DONE) {
+            throw DatabaseException("Failed to complete todo item: " + database_.getLastError());
+        }
+        noteWrite(id);
+        return CompleteResult{CompleteStatus::COMPLETED, std::move(item)};
     }
 
-    std::vector<TodoItem> items;
-    while ((result = sqlite3_step(stmt)) == SQLITE_ROW) {
-        items.push_back(readTodoItem(stmt));
+    if (result != SQLITE_DONE) {
+        throw DatabaseException("Failed to complete todo item: " + database_.getLastError());
     }
 
-    sqlite3_finalize(stmt);
+    // Nothing changed: either there is no such item or it was already completed
+    Statement exists = database_.prepare("SELECT 1 FROM todos WHERE id = ?");
+    sqlite3_bind_int(exists.get(), 1, id);
+
+    result = sqlite3_step(exists.get());
+
+    if (result == SQLITE_ROW) {
+        return CompleteResult{CompleteStatus::ALREADY_COMPLETED, std::nullopt};
+    }
 
     if (result != SQLITE_DONE) {
-        throw DatabaseException("Error reading pending items: " + database_.getLastError());
+        throw DatabaseException("Failed to complete todo item: " + database_.getLastError());
     }
 
-    return items;
+    return CompleteResult{CompleteStatus::NOT_FOUND, std::nullopt};
 }
 
-std::vector<TodoItem> TodoRepository::findByTitle(const std::string& query) {
-    const char* sql = "SELECT id, title, description, completed, created_at FROM todos WHERE title LIKE ? ORDER BY created_at DESC";
+std::optional<TodoItem> TodoRepository::removeReturning(int id) {
+    validateCache();
 
-    sqlite3_stmt* stmt = nullptr;
-    int result = sqlite3_prepare_v2(database_.getHandle(), sql, -1, &stmt, nullptr);
+    const char* sql = "DELETE FROM todos WHERE id = ? "
+                      "RETURNING id, title, description, completed, created_at";
 
-    if (result != SQLITE_OK) {
-        throw DatabaseException("Failed to prepare select statement: " + database_.getLastError());
-    }
+    Statement statement = database_.prepare(sql);
+    sqlite3_stmt* stmt = statement.get();
 
-    // Add wildcards for partial matching
-    std::string search_pattern = "%" + query + "%";
-    sqlite3_bind_text(stmt, 1, search_pattern.c_str(), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt, 1, id);
 
-    std::vector<TodoItem> items;
-    while ((result = sqlite3_step(stmt)) == SQLITE_ROW) {
-        items.push_back(readTodoItem(stmt));
+    int result = sqlite3_step(stmt);
+
+    if (result == SQLITE_DONE) {
+        return std::nullopt;
     }
 
-    sqlite3_finalize(stmt);
+    if (result != SQLITE_ROW) {
+        throw DatabaseException("Failed to delete todo item: " + database_.getLastError());
+    }
 
-    if (result != SQLITE_DONE) {
-        throw DatabaseException("Error searching todo items: " + database_.getLastError());
+    TodoItem item = readTodoItem(stmt);
+    if (sqlite3_step(stmt) != SQLITE_DONE) {
+        throw DatabaseException("Failed to delete todo item: " + database_.getLastError());
     }
+    noteWrite(id);
 
-    return items;
+    return item;
 }
 
-bool TodoRepository::update(const TodoItem& item) {
-    const char* sql = "UPDATE todos SET title = ?, description = ?, completed = ? WHERE id = ?";
+std::optional<IdRange> TodoRepository::nextIdChunk(const IdRange& range, int max_rows) {
+    const char* sql = "SELECT MIN(id), MAX(id) FROM "
+                      "(SELECT id FROM todos WHERE id BETWEEN ? AND ? ORDER BY id LIMIT ?)";
+
+    Statement statement = database_.prepare(sql);
+    sqlite3_stmt* stmt = statement.get();
+
+    sqlite3_bind_int(stmt, 1, range.first);
+    sqlite3_bind_int(stmt, 2, range.last);
+    sqlite3_bind_int(stmt, 3, max_rows);
 
-    sqlite3_stmt* stmt = nullptr;
-    int result = sqlite3_prepare_v2(database_.getHandle(), sql, -1, &stmt, nullptr);
+    int result = sqlite3_step(stmt);
 
-    if (result != SQLITE_OK) {
-        throw DatabaseException("Failed to prepare update statement: " + database_.getLastError());
+    if (result != SQLITE_ROW) {
+        throw DatabaseException("Failed to read id range: " + database_.getLastError());
     }
 
-    sqlite3_bind_text(stmt, 1, item.getTitle().c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt, 2, item.getDescription().c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_int(stmt, 3, item.isCompleted() ? 1 : 0);
-    sqlite3_bind_int(stmt, 4, item.getId());
+    if (sqlite3_column_type(stmt, 0) == SQLITE_NULL) {
+        return std::nullopt;
+    }
+
+    return IdRange{sqlite3_column_int(stmt, 0), sqlite3_column_int(stmt, 1)};
+}
+
+int TodoRepository::completeRange(const IdRange& range) {
+    validateCache();
+
+    const char* sql = "UPDATE todos SET completed = 1 WHERE id BETWEEN ? AND ? AND completed = 0";
+
+    Statement statement = database_.prepare(sql);
+    sqlite3_stmt* stmt = statement.get();
+
+    sqlite3_bind_int(stmt, 1, range.first);
+    sqlite3_bind_int(stmt, 2, range.last);
 
-    result = sqlite3_step(stmt);
+    int result = sqlite3_step(stmt);
 
     if (result != SQLITE_DONE) {
-        std::string error = database_.getLastError();
-        sqlite3_finalize(stmt);
-        throw DatabaseException("Failed to update todo item: " + error);
+        throw DatabaseException("Failed to complete todo items: " + database_.getLastError());
     }
 
-    int changes = sqlite3_changes(database_.getHandle());
-    sqlite3_finalize(stmt);
-
-    return changes > 0;
+    noteWrite(std::nullopt);
+    return sqlite3_changes(database_.getHandle());
 }
 
-bool TodoRepository::remove(int id) {
-    const char* sql = "DELETE FROM todos WHERE id = ?";
+int TodoRepository::removeRange(const IdRange& range) {
+    validateCache();
+
+    const char* sql = "DELETE FROM todos WHERE id BETWEEN ? AND ?";
+
+    Statement statement = database_.prepare(sql);
+    sqlite3_stmt* stmt = statement.get();
 
-    sqlite3_stmt* stmt = nullptr;
-    int result = sqlite3_prepare_v2(database_.getHandle(), sql, -1, &stmt, nullptr);
+    sqlite3_bind_int(stmt, 1, range.first);
+    sqlite3_bind_int(stmt, 2, range.last);
 
-    if (result != SQLITE_OK) {
-        throw DatabaseException("Failed to prepare delete statement: " + database_.getLastError());
+    int result = sqlite3_step(stmt);
+
+    if (result != SQLITE_DONE) {
+        throw DatabaseException("Failed to delete todo items: " + database_.getLastError());
     }
 
-    sqlite3_bind_int(stmt, 1, id);
+    noteWrite(std::nullopt);
+    return sqlite3_changes(database_.getHandle());
+}
+
+int TodoRepository::removeMatching(const BulkFilter& filter, int limit) {
+    validateCache();
+
+    // Only the conditions that are set end up in the SQL, so that the
+    // completed index stays usable; each variant is cached separately.
+    std::string sql = "DELETE FROM todos WHERE id IN (SELECT id FROM todos WHERE 1";
+    if (filter.completed) {
+        sql += " AND completed = ?1";
+    }
+    if (filter.created_before) {
+        sql += " AND created_at < ?2";
+    }
+    sql += " LIMIT ?3)";
+
+    Statement statement = database_.prepare(sql);
+    sqlite3_stmt* stmt = statement.get();
 
-    result = sqlite3_step(stmt);
+    if (filter.completed) {
+        sqlite3_bind_int(stmt, 1, *filter.completed ? 1 : 0);
+    }
+    if (filter.created_before) {
+        sqlite3_bind_int64(stmt, 2, static_cast<sqlite3_int64>(*filter.created_before));
+    }
+    sqlite3_bind_int(stmt, 3, limit);
+
+    int result = sqlite3_step(stmt);
 
     if (result != SQLITE_DONE) {
-        std::string error = database_.getLastError();
-        sqlite3_finalize(stmt);
-        throw DatabaseException("Failed to delete todo item: " + error);
+        throw DatabaseException("Failed to delete todo items: " + database_.getLastError());
     }
 
-    int changes = sqlite3_changes(database_.getHandle());
-    sqlite3_finalize(stmt);
+    noteWrite(std::nullopt);
+    return sqlite3_changes(database_.getHandle());
+}
+
+TodoStats TodoRepository::stats() {
+    const char* sql = "SELECT total, completed FROM todo_stats WHERE id = 1";
+
+    Statement statement = database_.prepare(sql);
+    sqlite3_stmt* stmt = statement.get();
+
+    int result = sqlite3_step(stmt);
+
+    if (result != SQLITE_ROW) {
+        throw DatabaseException("Failed to read todo statistics: " + database_.getLastError());
+    }
 
-    return changes > 0;
+    TodoStats stats;
+    stats.total = sqlite3_column_int(stmt, 0);
+    stats.completed = sqlite3_column_int(stmt, 1);
+    stats.pending = stats.total - stats.completed;
+    return stats;
 }
 
 int TodoRepository::count() {
-    const char* sql = "SELECT COUNT(*) FROM todos";
+    return stats().total;
+}
+
+int TodoRepository::countCompleted() {
+    return stats().completed;
+}
+
+int TodoRepository::countPending() {
+    return stats().pending;
+}
 
-    sqlite3_stmt* stmt = nullptr;
-    int result = sqlite3_prepare_v2(database_.getHandle(), sql, -1, &stmt, nullptr);
+TodoPage TodoRepository::findPage(TodoFilter filter, int limit, const std::optional<std::string>& after) {
+    std::string sql = "SELECT id, title, description, completed, created_at FROM todos WHERE 1";
 
-    if (result != SQLITE_OK) {
-        throw DatabaseException("Failed to prepare count statement: " + database_.getLastError());
+    switch (filter) {
+        case TodoFilter::COMPLETED: sql += " AND completed = 1"; break;
+        case TodoFilter::PENDING:   sql += " AND completed = 0"; break;
+        case TodoFilter::ALL:       break;
     }
 
-    result = sqlite3_step(stmt);
+    return fetchPage(std::move(sql), nullptr, limit, after);
+}
 
-    if (result != SQLITE_ROW) {
-        sqlite3_finalize(stmt);
-        throw DatabaseException("Failed to count todo items: " + database_.getLastError());
+TodoPage TodoRepository::findPageByTitle(const std::string& query, int limit,
+                                         const std::optional<std::string>& after) {
+    std::string sql = useTrigramIndex(query)
+        ? "SELECT t.id, t.title, t.description, t.completed, t.created_at "
+          "FROM todos_trigram JOIN todos t ON t.id = todos_trigram.rowid "
+          "WHERE todos_trigram.title LIKE ?1"
+        : "SELECT id, title, description, completed, created_at FROM todos WHERE title LIKE ?1";
+    std::string search_pattern = "%" + query + "%";
+    return fetchPage(std::move(sql), &search_pattern, limit, after);
+}
+
+TodoPage TodoRepository::fetchPage(std::string sql, const std::string* pattern, int limit,
+                                   const std::optional<std::string>& after) {
+    if (limit <= 0) {
+        throw ValidationException("Page size must be a positive number");
+    }
+
+    sqlite3_int64 after_created_at = 0;
+    int after_id = 0;
+    if (after) {
+        decodeCursor(*after, after_created_at, after_id);
+        sql += " AND (created_at, id) < (?2, ?3)";
     }
 
-    int count = sqlite3_column_int(stmt, 0);
-    sqlite3_finalize(stmt);
+    // Fetch one extra row to find out whether another page follows
+    sql += " ORDER BY created_at DESC, id DESC LIMIT ?4";
+
+    Statement statement = database_.prepare(sql);
+    sqlite3_stmt* stmt = statement.get();
 
-    return count;
+    if (pattern) {
+        sqlite3_bind_text(stmt, 1, pattern->data(), static_cast<int>(pattern->size()), SQLITE_STATIC);
+    }
+    if (after) {
+        sqlite3_bind_int64(stmt, 2, after_created_at);
+        sqlite3_bind_int(stmt, 3, after_id);
+    }
+    sqlite3_bind_int64(stmt, 4, static_cast<sqlite3_int64>(limit) + 1);
+
+    TodoPage page;
+    page.items.reserve(static_cast<size_t>(limit));
+    bool has_more = false;
+
+    visitRows(stmt, [&page, &has_more, limit](const TodoItem& item) {
+        if (page.items.size() < static_cast<size_t>(limit)) {
+            page.items.push_back(item);
+        } else {
+            has_more = true;
+        }
+    }, "Error reading todo page: ");
+
+    if (has_more) {
+        const TodoItem& last = page.items.back();
+        page.next_cursor = encodeCursor(static_cast<sqlite3_int64>(last.getCreatedAtUnix()), last.getId());
+    }
+
+    return page;
 }
 
-int TodoRepository::countCompleted() {
-    const char* sql = "SELECT COUNT(*) FROM todos WHERE completed = 1";
+std::vector<TodoItem> TodoRepository::search(const std::string& query) {
+    std::vector<TodoItem> items;
+    forEachSearchResult(query, [&items](const TodoItem& item) { items.push_back(item); });
+    return items;
+}
+
+void TodoRepository::forEachSearchResult(const std::string& query, const TodoVisitor& visitor) {
+    TodoItem item;
+    forEachSearchResultView(query, copyingVisitor(item, visitor));
+}
+
+void TodoRepository::forEachSearchResultView(const std::string& query, const TodoViewVisitor& visitor) {
+    // Title matches weigh more than description matches
+    const char* sql = "SELECT t.id, t.title, t.description, t.completed, t.created_at "
+                      "FROM todos_fts JOIN todos t ON t.id = todos_fts.rowid "
+                      "WHERE todos_fts MATCH ? "
+                      "ORDER BY bm25(todos_fts, 10.0, 1.0), t.created_at DESC, t.id DESC";
+
+    Statement statement = database_.prepare(sql);
+    sqlite3_stmt* stmt = statement.get();
+
+    std::string fts_query = toFtsQuery(query);
+    sqlite3_bind_text(stmt, 1, fts_query.data(), static_cast<int>(fts_query.size()), SQLITE_STATIC);
+
+    visitRowViews(stmt, visitor, "Error searching todo items: ");
+}
+
+TodoStats TodoRepository::searchStats(const std::string& query) {
+    const char* sql = "SELECT COUNT(*), COALESCE(SUM(t.completed), 0) "
+                      "FROM todos_fts JOIN todos t ON t.id = todos_fts.rowid "
+                      "WHERE todos_fts MATCH ?";
+
+    Statement statement = database_.prepare(sql);
+    sqlite3_stmt* stmt = statement.get();
+
+    std::string fts_query = toFtsQuery(query);
+    sqlite3_bind_text(stmt, 1, fts_query.data(), static_cast<int>(fts_query.size()), SQLITE_STATIC);
 
-    sqlite3_stmt* stmt = nullptr;
-    int result = sqlite3_prepare_v2(database_.getHandle(), sql, -1, &stmt, nullptr);
+    int result = sqlite3_step(stmt);
 
-    if (result != SQLITE_OK) {
-        throw DatabaseException("Failed to prepare count statement: " + database_.getLastError());
+    if (result != SQLITE_ROW) {
+        throw DatabaseException("Failed to count matching items: " + database_.getLastError());
     }
 
-    result = sqlite3_step(stmt);
+    TodoStats stats;
+    stats.total = sqlite3_column_int(stmt, 0);
+    stats.completed = sqlite3_column_int(stmt, 1);
+    stats.pending = stats.total - stats.completed;
+    return stats;
+}
+
+TodoPage TodoRepository::searchPage(const std::string& query, int limit,
+                                    const std::optional<std::string>& after) {
+    std::string sql = "SELECT t.id, t.title, t.description, t.completed, t.created_at "
+                      "FROM todos_fts JOIN todos t ON t.id = todos_fts.rowid "
+                      "WHERE todos_fts MATCH ?1";
+    std::string fts_query = toFtsQuery(query);
+    return fetchPage(std::move(sql), &fts_query, limit, after);
+}
+
+int TodoRepository::count(TodoFilter filter) {
+    switch (filter) {
+        case TodoFilter::COMPLETED: return countCompleted();
+        case TodoFilter::PENDING:   return countPending();
+        case TodoFilter::ALL:       break;
+    }
+    return count();
+}
+
+TodoStats TodoRepository::statsByTitle(const std::string& query) {
+    const char* sql = useTrigramIndex(query)
+        ? "SELECT COUNT(*), COALESCE(SUM(t.completed), 0) "
+          "FROM todos_trigram JOIN todos t ON t.id = todos_trigram.rowid "
+          "WHERE todos_trigram.title LIKE ?"
+        : "SELECT COUNT(*), COALESCE(SUM(completed), 0) FROM todos WHERE title LIKE ?";
+
+    Statement statement = database_.prepare(sql);
+    sqlite3_stmt* stmt = statement.get();
+
+    std::string search_pattern = "%" + query + "%";
+    sqlite3_bind_text(stmt, 1, search_pattern.c_str(), -1, SQLITE_TRANSIENT);
+
+    int result = sqlite3_step(stmt);
 
     if (result != SQLITE_ROW) {
-        sqlite3_finalize(stmt);
-        throw DatabaseException("Failed to count completed items: " + database_.getLastError());
+        throw DatabaseException("Failed to count matching items: " + database_.getLastError());
     }
 
-    int count = sqlite3_column_int(stmt, 0);
-    sqlite3_finalize(stmt);
+    TodoStats stats;
+    stats.total = sqlite3_column_int(stmt, 0);
+    stats.completed = sqlite3_column_int(stmt, 1);
+    stats.pending = stats.total - stats.completed;
+    return stats;
+}
 
-    return count;
+CacheStats TodoRepository::cacheStats() const {
+    return cache_ ? cache_->stats() : CacheStats{};
 }
 
-int TodoRepository::countPending() {
-    const char* sql = "SELECT COUNT(*) FROM todos WHERE completed = 0";
+void TodoRepository::validateCache() {
+    if (!cache_) {
+        return;
+    }
+
+    Statement statement = database_.prepare("PRAGMA data_version");
+    if (sqlite3_step(statement.get()) != SQLITE_ROW) {
+        throw DatabaseException("Failed to read data version: " + database_.getLastError());
+    }
+    sqlite3_int64 data_version = sqlite3_column_int64(statement.get(), 0);
+    sqlite3_int64 total_changes = sqlite3_total_changes64(database_.getHandle());
 
-    sqlite3_stmt* stmt = nullptr;
-    int result = sqlite3_prepare_v2(database_.getHandle(), sql, -1, &stmt, nullptr);
+    if (data_version != cache_data_version_ || total_changes != cache_total_changes_) {
+        cache_->clear();
+        cache_data_version_ = data_version;
+        cache_total_changes_ = total_changes;
+    }
+}
 
-    if (result != SQLITE_OK) {
-        throw DatabaseException("Failed to prepare count statement: " + database_.getLastError());
+void TodoRepository::noteWrite(std::optional<int> id) {
+    if (!cache_) {
+        return;
     }
 
-    result = sqlite3_step(stmt);
+    if (id) {
+        cache_->erase(*id);
+    } else {
+        cache_->clear();
+    }
 
-    if (result != SQLITE_ROW) {
-        sqlite3_finalize(stmt);
-        throw DatabaseException("Failed to count pending items: " + database_.getLastError());
+    // validateCache() ran before this write, so the only unseen change is ours
+    cache_total_changes_ = sqlite3_total_changes64(database_.getHandle());
+}
+
+void TodoRepository::visitRows(sqlite3_stmt* stmt, const TodoVisitor& visitor, const char* error_context) {
+    TodoItem item;
+    visitRowViews(stmt, copyingVisitor(item, visitor), error_context);
+}
+
+void TodoRepository::visitRowViews(sqlite3_stmt* stmt, const TodoViewVisitor& visitor, const char* error_context) {
+    int result;
+    while ((result = sqlite3_step(stmt)) == SQLITE_ROW) {
+        visitor(readTodoItemView(stmt));
     }
 
-    int count = sqlite3_column_int(stmt, 0);
-    sqlite3_finalize(stmt);
+    if (result != SQLITE_DONE) {
+        throw DatabaseException(error_context + database_.getLastError());
+    }
+}
 
-    return count;
+TodoItemView TodoRepository::readTodoItemView(sqlite3_stmt* stmt) {
+    // sqlite3_column_bytes must follow sqlite3_column_text so the length
+    // matches the UTF-8 text that the pointer refers to
+    const unsigned char* title_ptr = sqlite3_column_text(stmt, 1);
+    int title_len = sqlite3_column_bytes(stmt, 1);
+    const unsigned char* desc_ptr = sqlite3_column_text(stmt, 2);
+    int desc_len = sqlite3_column_bytes(stmt, 2);
+
+    return TodoItemView(
+        sqlite3_column_int(stmt, 0),
+        std::string_view(reinterpret_cast<const char*>(title_ptr), static_cast<size_t>(title_len)),
+        desc_ptr ? std::string_view(reinterpret_cast<const char*>(desc_ptr), static_cast<size_t>(desc_len))
+                 : std::string_view(),
+        sqlite3_column_int(stmt, 3) != 0,
+        sqlite3_column_int64(stmt, 4));
 }
 
 TodoItem TodoRepository::readTodoItem(sqlite3_stmt* stmt) {
@@ -0,0 +1,211 @@
+#include "todolist/todo_snapshot.h"
+#include "todolist/exceptions.h"
+#include <sqlite3.h>
+#include <algorithm>
+#include <limits>
+
+namespace todolist {
+
+namespace {
+
+/**
+ * @brief Count the set bits of a word
+ */
+inline int popcount64(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(word);
+#else
+    word = word - ((word >> 1) & 0x5555555555555555ULL);
+    word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<int>((word * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+/**
+ * @brief Get the index of the lowest set bit of a non-zero word
+ */
+inline int lowestSetBit(std::uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    return popcount64((word & (~word + 1)) - 1);
+#endif
+}
+
+} // anonymous namespace
+
+TodoSnapshot::TodoSnapshot(Database& database) {
+    // The summary row gives the row count up front, so the columns are
+    // allocated once
+    Statement count = database.prepare("SELECT total FROM todo_stats");
+    if (sqlite3_step(count.get()) == SQLITE_ROW) {
+        size_t expected = static_cast<size_t>(std::max<sqlite3_int64>(0, sqlite3_column_int64(count.get(), 0)));
+        ids_.reserve(expected);
+        created_at_.reserve(expected);
+        completed_.reserve((expected + 63) / 64);
+        title_offsets_.reserve(expected + 1);
+        description_offsets_.reserve(expected + 1);
+    }
+
+    // Rowid order: a plain scan of the table b-tree with no sort step
+    const char* sql = "SELECT id, title, description, completed, created_at FROM todos ORDER BY id";
+    Statement statement = database.prepare(sql);
+    sqlite3_stmt* stmt = statement.get();
+
+    title_offsets_.push_back(0);
+    description_offsets_.push_back(0);
+
+    int result;
+    while ((result = sqlite3_step(stmt)) == SQLITE_ROW) {
+        size_t row = ids_.size();
+        if (row >= std::numeric_limits<Row>::max()) {
+            throw DatabaseException("Too many todo items for a snapshot");
+        }
+
+        ids_.push_back(sqlite3_column_int(stmt, 0));
+
+        const char* title = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+        if (title) {
+            titles_.append(title, static_cast<size_t>(sqlite3_column_bytes(stmt, 1)));
+        }
+        title_offsets_.push_back(titles_.size());
+
+        const char* description = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
+        if (description) {
+            descriptions_.append(description, static_cast<size_t>(sqlite3_column_bytes(stmt, 2)));
+        }
+        description_offsets_.push_back(descriptions_.size());
+
+        if (row % 64 == 0) {
+            completed_.push_back(0);
+        }
+        if (sqlite3_column_int(stmt, 3) == 1) {
+            completed_.back() |= std::uint64_t{1} << (row % 64);
+        }
+
+        created_at_.push_back(sqlite3_column_int64(stmt, 4));
+    }
+
+    if (result != SQLITE_DONE) {
+        throw DatabaseException("Error reading todo items: " + database.getLastError());
+    }
+
+    titles_.shrink_to_fit();
+    descriptions_.shrink_to_fit();
+}
+
+TodoItem TodoSnapshot::item(Row row) const {
+    return TodoItem(ids_[row], std::string(title(row)), std::string(description(row)),
+                    isCompleted(row), TodoItem::fromUnixTime(static_cast<std::time_t>(created_at_[row])));
+}
+
+bool TodoSnapshot::findRow(int id, Row& row) const {
+    auto it = std::lower_bound(ids_.begin(), ids_.end(), id);
+    if (it == ids_.end() || *it != id) {
+        return false;
+    }
+    row = static_cast<Row>(it - ids_.begin());
+    return true;
+}
+
+std::uint64_t TodoSnapshot::statusWord(size_t word, TodoFilter filter) const {
+    std::uint64_t bits = ~std::uint64_t{0};
+    switch (filter) {
+        case TodoFilter::ALL:       break;
+        case TodoFilter::COMPLETED: bits = completed_[word]; break;
+        case TodoFilter::PENDING:   bits = ~completed_[word]; break;
+    }
+
+    // The last word may be partly beyond the final row
+    size_t used = size() - word * 64;
+    if (used < 64) {
+        bits &= (std::uint64_t{1} << used) - 1;
+    }
+    return bits;
+}
+
+size_t TodoSnapshot::count(TodoFilter filter) const {
+    if (filter == TodoFilter::ALL) {
+        return size();
+    }
+
+    size_t completed = 0;
+    for (std::uint64_t word : completed_) {
+        completed += static_cast<size_t>(popcount64(word));
+    }
+    return filter == TodoFilter::COMPLETED ? completed : size() - completed;
+}
+
+template <typename Predicate>
+TodoSnapshot::Rows TodoSnapshot::select(TodoFilter filter, Predicate predicate) const {
+    Rows rows;
+    for (size_t word = 0; word < completed_.size(); ++word) {
+        std::uint64_t bits = statusWord(word, filter);
+        while (bits) {
+            Row row = static_cast<Row>(word * 64 + static_cast<size_t>(lowestSetBit(bits)));
+            if (predicate(row)) {
+                rows.push_back(row);
+            }
+            bits &= bits - 1;
+        }
+    }
+    return rows;
+}
+
+TodoSnapshot::Rows TodoSnapshot::filter(TodoFilter filter) const {
+    Rows rows;
+    rows.reserve(count(filter));
+    for (size_t word = 0; word < completed_.size(); ++word) {
+        std::uint64_t bits = statusWord(word, filter);
+        while (bits) {
+            rows.push_back(static_cast<Row>(word * 64 + static_cast<size_t>(lowestSetBit(bits))));
+            bits &= bits - 1;
+        }
+    }
+    return rows;
+}
+
+TodoSnapshot::Rows TodoSnapshot::filterByTitle(std::string_view query, TodoFilter filter,
+                                               SimdLevel level) const {
+    // One pass over the whole title arena, then the status filter on the
+    // (usually few) matches
+    Rows rows;
+    SubstringMatcher(query, level).findRows(titles_.data(), title_offsets_.data(), size(), rows);
+
+    if (filter != TodoFilter::ALL) {
+        bool completed = filter == TodoFilter::COMPLETED;
+        rows.erase(std::remove_if(rows.begin(), rows.end(),
+                                  [&](Row row) { return isCompleted(row) != completed; }),
+                   rows.end());
+    }
+    return rows;
+}
+
+TodoSnapshot::Rows TodoSnapshot::filterCreatedBetween(std::time_t from, std::time_t to, TodoFilter filter) const {
+    std::int64_t first = static_cast<std::int64_t>(from);
+    std::int64_t end = static_cast<std::int64_t>(to);
+
+    return select(filter, [&](Row row) { return created_at_[row] >= first && created_at_[row] < end; });
+}
+
+void TodoSnapshot::sortNewestFirst(Rows& rows) const {
+    std::sort(rows.begin(), rows.end(), [this](Row a, Row b) {
+        if (created_at_[a] != created_at_[b]) {
+            return created_at_[a] > created_at_[b];
+        }
+        return ids_[a] > ids_[b];
+    });
+}
+
+void TodoSnapshot::sortByTitle(Rows& rows) const {
+    std::sort(rows.begin(), rows.end(), [this](Row a, Row b) {
+        int order = title(a).compare(title(b));
+        if (order != 0) {
+            return order < 0;
+        }
+        return ids_[a] < ids_[b];
+    });
+}
+
+} // namespace todolist
@@ -0,0 +1,211 @@
+#include <gtest/gtest.h>
+#include "todolist/buffered_writer.h"
+#include "todolist/command_arena.h"
+#include "todolist/command_parser.h"
+#include "todolist/cli_handler.h"
+#include "todolist/database.h"
+#include "todolist/formatter.h"
+#include "todolist/todo_repository.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <ostream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+// Count global heap allocations made while a test has counting switched
+// on. Replacing these operators affects the whole test binary, so they
+// only forward to malloc/free and bump a counter.
+
+namespace {
+
+std::atomic<bool> g_counting{false};
+std::atomic<size_t> g_allocations{0};
+
+void* countedAllocate(std::size_t size) {
+    if (g_counting.load(std::memory_order_relaxed)) {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+} // anonymous namespace
+
+void* operator new(std::size_t size) {
+    return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size) {
+    return countedAllocate(size);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+using namespace todolist;
+
+class AllocationTest : public ::testing::Test {
+protected:
+    /**
+     * @brief Output stream that discards everything without buffering
+     */
+    class NullBuffer : public std::streambuf {
+    protected:
+        std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+        int overflow(int c) override { return c; }
+    };
+
+    void SetUp() override {
+        db_ = std::make_unique<Database>(":memory:");
+        repo_ = std::make_unique<TodoRepository>(*db_);
+    }
+
+    void TearDown() override {
+        g_counting.store(false);
+        repo_.reset();
+        db_.reset();
+    }
+
+    /**
+     * @brief Add rows whose text all has the same length, so reused buffers
+     * need the same capacity however many rows there are
+     */
+    void seed(int rows) {
+        std::vector<TodoItem> items;
+        for (int i = 0; i < rows; ++i) {
+            std::string number = std::to_string(100000 + i);
+            items.emplace_back("Task number " + number, "Description of task " + number);
+        }
+        repo_->createBatch(items);
+    }
+
+    /**
+     * @brief Count global allocations made by one list command, as main() runs it
+     */
+    size_t countListAllocations() {
+        NullBuffer buffer;
+        std::ostream out(&buffer);
+        char program[] = "todo";
+        char command[] = "list";
+        char* argv[] = {program, command};
+
+        g_allocations.store(0);
+        g_counting.store(true);
+        {
+            CommandArena arena;
+            ParsedCommand cmd = CommandParser().parse(2, argv, arena.resource());
+            CliHandler handler(*repo_, std::make_unique<Formatter>(false), arena.resource());
+            handler.streamList(cmd.args, cmd.options, out);
+        }
+        g_counting.store(false);
+        return g_allocations.load();
+    }
+
+    std::unique_ptr<Database> db_;
+    std::unique_ptr<TodoRepository> repo_;
+};
+
+// Fixed cost per command: the parsed command, the handler and formatter,
+// and the row callback
+constexpr size_t kListAllocationBudget = 16;
+
+TEST_F(AllocationTest, ListStaysWithinBudget) {
+    seed(1000);
+    countListAllocations();  // warm the statement cache
+
+    EXPECT_LE(countListAllocations(), kListAllocationBudget);
+}
+
+TEST_F(AllocationTest, ListAllocationsIndependentOfRowCount) {
+    // Same number of digits in the header counts
+    seed(1000);
+    countListAllocations();
+    size_t few = countListAllocations();
+
+    seed(5000);
+    size_t many = countListAllocations();
+
+    EXPECT_EQ(many, few);
+}
+
+TEST_F(AllocationTest, ParseUsesArenaForScratch) {
+    char program[] = "todo";
+    char command[] = "search";
+    char query[] = "milk";
+    char engine[] = "--engine=simd";
+    char* argv[] = {program, command, query, engine};
+
+    g_allocations.store(0);
+    g_counting.store(true);
+    {
+        CommandArena arena;
+        ParsedCommand cmd = CommandParser().parse(4, argv, arena.resource());
+        EXPECT_EQ(cmd.command, Command::SEARCH);
+    }
+    g_counting.store(false);
+
+    // One vector block for the arguments and one map node for the option
+    EXPECT_LE(g_allocations.load(), 2u);
+}
+
+TEST_F(AllocationTest, AppendTodoItemMatchesFormatTodoItem) {
+    Formatter formatter(true);
+    TodoItem item(7, "Title", "Description", true, TodoItem::fromUnixTime(1700000000));
+
+    std::pmr::string out;
+    formatter.appendTodoItem(out, item, true);
+    EXPECT_EQ(std::string(out), formatter.formatTodoItem(item, true));
+
+    formatter.setColorEnabled(false);
+    out.clear();
+    formatter.appendTodoItem(out, item, false);
+    EXPECT_EQ(std::string(out), formatter.formatTodoItem(item, false));
+}
+
+TEST_F(AllocationTest, SinksMatchFormatMethods) {
+    std::vector<TodoItem> items = {
+        TodoItem(2, "Second", "", false, TodoItem::fromUnixTime(1700000100)),
+        TodoItem(1, "First", "Details", true, TodoItem::fromUnixTime(1700000000)),
+    };
+
+    for (bool color : {true, false}) {
+        Formatter formatter(color);
+        std::string expected = formatter.formatTodoList(items, true) + formatter.formatStats(2, 1) +
+                               formatter.formatWarning("careful") + formatter.separator(10, '=');
+
+        std::string text;
+        formatter.appendTodoList(text, items, true);
+        formatter.appendStats(text, 2, 1);
+        formatter.appendWarning(text, "careful");
+        formatter.appendSeparator(text, 10, '=');
+        EXPECT_EQ(text, expected);
+
+        // A buffer much smaller than the output, so it flushes part way
+        std::ostringstream stream;
+        BufferedWriter writer(stream, 64);
+        formatter.appendTodoList(writer, items, true);
+        formatter.appendStats(writer, 2, 1);
+        formatter.appendWarning(writer, "careful");
+        formatter.appendSeparator(writer, 10, '=');
+        writer.flush();
+        EXPECT_EQ(stream.str(), expected);
+    }
+}
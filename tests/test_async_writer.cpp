@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include "todolist/async_writer.h"
+#include <thread>
+#include <vector>
+
+using namespace todolist;
+
+class AsyncWriterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        db_ = std::make_unique<Database>(":memory:");
+    }
+
+    std::unique_ptr<Database> db_;
+};
+
+TEST_F(AsyncWriterTest, CreateResolvesWithAssignedId) {
+    std::future<TodoItem> created;
+    {
+        AsyncWriter writer(*db_);
+        created = writer.create(TodoItem("Async task", "Desc"));
+        TodoItem item = created.get();
+        EXPECT_GT(item.getId(), 0);
+        EXPECT_EQ(item.getTitle(), "Async task");
+    }
+
+    TodoRepository repo(*db_);
+    EXPECT_EQ(repo.count(), 1);
+}
+
+TEST_F(AsyncWriterTest, UpdateAndRemove) {
+    TodoRepository repo(*db_);
+    TodoItem item = repo.create(TodoItem("Original", ""));
+    {
+        AsyncWriter writer(*db_);
+        item.setTitle("Renamed");
+        EXPECT_TRUE(writer.update(item).get());
+        EXPECT_TRUE(writer.remove(item.getId()).get());
+        EXPECT_FALSE(writer.remove(item.getId()).get());
+    }
+
+    EXPECT_EQ(repo.count(), 0);
+}
+
+TEST_F(AsyncWriterTest, GroupsConcurrentWritesIntoFewTransactions) {
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 250;
+
+    AsyncWriterOptions options;
+    options.max_batch_size = 500;
+    options.max_delay = std::chrono::milliseconds(20);
+
+    std::uint64_t batches;
+    {
+        AsyncWriter writer(*db_, options);
+        std::vector<std::thread> producers;
+        std::vector<std::vector<std::future<TodoItem>>> futures(kThreads);
+
+        for (int t = 0; t < kThreads; ++t) {
+            producers.emplace_back([&writer, &futures, t] {
+                for (int i = 0; i < kPerThread; ++i) {
+                    futures[t].push_back(writer.create(TodoItem("Task " + std::to_string(i), "")));
+                }
+            });
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        for (auto& perThread : futures) {
+            for (auto& future : perThread) {
+                EXPECT_GT(future.get().getId(), 0);
+            }
+        }
+        batches = writer.committedBatches();
+    }
+
+    TodoRepository repo(*db_);
+    EXPECT_EQ(repo.count(), kThreads * kPerThread);
+    EXPECT_LT(batches, static_cast<std::uint64_t>(kThreads * kPerThread / 10));
+}
+
+TEST_F(AsyncWriterTest, FailedWriteOnlyFailsItsOwnFuture) {
+    // Reject one title so that a single statement in the batch fails
+    db_->execute("CREATE TRIGGER reject_bad BEFORE INSERT ON todos WHEN new.title = 'bad' "
+                 "BEGIN SELECT RAISE(ABORT, 'rejected'); END");
+
+    AsyncWriterOptions options;
+    options.max_delay = std::chrono::milliseconds(50);
+
+    AsyncWriter writer(*db_, options);
+    auto good = writer.create(TodoItem("good", ""));
+    auto bad = writer.create(TodoItem("bad", ""));
+    auto alsoGood = writer.create(TodoItem("also good", ""));
+
+    EXPECT_GT(good.get().getId(), 0);
+    EXPECT_THROW(bad.get(), DatabaseException);
+    EXPECT_GT(alsoGood.get().getId(), 0);
+}
+
+TEST_F(AsyncWriterTest, DestructorCommitsQueuedWrites) {
+    {
+        AsyncWriterOptions options;
+        options.max_delay = std::chrono::seconds(10);
+        AsyncWriter writer(*db_, options);
+        for (int i = 0; i < 100; ++i) {
+            writer.create(TodoItem("Task", ""));
+        }
+    }
+
+    TodoRepository repo(*db_);
+    EXPECT_EQ(repo.count(), 100);
+}
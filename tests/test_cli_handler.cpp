@@ -3,6 +3,7 @@
 #include "todolist/database.h"
 #include "todolist/exceptions.h"
 #include <memory>
+#include <sstream>
 
 using namespace todolist;
 
@@ -58,6 +59,35 @@ TEST_F(CliHandlerTest, HandleAddWithEmptyTitle) {
     EXPECT_THROW(handler->handleAdd(args), ValidationException);
 }
 
+// Test handleAddBatch
+TEST_F(CliHandlerTest, HandleAddBatch) {
+    std::istringstream input("Buy groceries\tMilk, bread\n\nFix bug\r\nWrite docs\n");
+    std::string result = handler->handleAddBatch(input);
+
+    EXPECT_NE(result.find("3 todo items created successfully"), std::string::npos);
+
+    auto items = repository->findAll();
+    ASSERT_EQ(items.size(), 3);
+    auto groceries = repository->findByTitle("groceries");
+    ASSERT_EQ(groceries.size(), 1);
+    EXPECT_EQ(groceries[0].getDescription(), "Milk, bread");
+    EXPECT_EQ(repository->findByTitle("Fix bug")[0].getTitle(), "Fix bug");
+}
+
+TEST_F(CliHandlerTest, HandleAddBatchEmptyInput) {
+    std::istringstream input("\n\n");
+    std::string result = handler->handleAddBatch(input);
+
+    EXPECT_NE(result.find("No todo items read"), std::string::npos);
+    EXPECT_EQ(repository->count(), 0);
+}
+
+TEST_F(CliHandlerTest, HandleAddBatchEmptyTitleIsAtomic) {
+    std::istringstream input("Task 1\n\tOnly a description\n");
+    EXPECT_THROW(handler->handleAddBatch(input), ValidationException);
+    EXPECT_EQ(repository->count(), 0);
+}
+
 // Test handleList
 TEST_F(CliHandlerTest, HandleListEmpty) {
     std::vector<std::string> args = {};
@@ -110,6 +140,46 @@ TEST_F(CliHandlerTest, HandleListPending) {
     EXPECT_EQ(result.find("Task 2"), std::string::npos);
 }
 
+TEST_F(CliHandlerTest, StreamListMatchesFormattedList) {
+    auto done = TodoItem("Task 1", "");
+    done.setCompleted(true);
+    repository->create(done);
+    repository->create(TodoItem("Task 2", ""));
+
+    std::ostringstream out;
+    handler->streamList({}, {}, out);
+
+    EXPECT_EQ(out.str(), handler->getFormatter().formatTodoList(repository->findAll(), false));
+    EXPECT_NE(out.str().find("Total: 2 items | 1 pending | 1 completed"), std::string::npos);
+}
+
+TEST_F(CliHandlerTest, HandleListWithLimitAndCursor) {
+    for (int i = 0; i < 5; ++i) {
+        repository->create(TodoItem(0, "Task " + std::to_string(i), "", false,
+                                    TodoItem::fromUnixTime(1000000000 + i)));
+    }
+
+    std::string first = handler->handleList({"pending"}, {{"limit", "3"}});
+
+    EXPECT_NE(first.find("Task 4"), std::string::npos);
+    EXPECT_EQ(first.find("Task 1"), std::string::npos);
+    size_t hint = first.find("Next page: --after ");
+    ASSERT_NE(hint, std::string::npos);
+    std::string cursor = first.substr(hint + std::string("Next page: --after ").size());
+
+    std::string second = handler->handleList({"pending"}, {{"limit", "3"}, {"after", cursor}});
+
+    EXPECT_NE(second.find("Task 1"), std::string::npos);
+    EXPECT_NE(second.find("Task 0"), std::string::npos);
+    EXPECT_EQ(second.find("Task 2"), std::string::npos);
+    EXPECT_EQ(second.find("Next page"), std::string::npos);
+}
+
+TEST_F(CliHandlerTest, HandleListInvalidLimit) {
+    EXPECT_THROW(handler->handleList({}, {{"limit", "0"}}), ValidationException);
+    EXPECT_THROW(handler->handleList({}, {{"limit", "ten"}}), ValidationException);
+}
+
 TEST_F(CliHandlerTest, HandleListInvalidFilter) {
     std::vector<std::string> args = {"invalid"};
     EXPECT_THROW(handler->handleList(args), ValidationException);
@@ -156,6 +226,34 @@ TEST_F(CliHandlerTest, HandleCompleteAlreadyCompleted) {
     EXPECT_THROW(handler->handleComplete(args), ValidationException);
 }
 
+TEST_F(CliHandlerTest, HandleCompleteMultipleIdsAndRanges) {
+    for (int i = 0; i < 10; ++i) {
+        repository->create(TodoItem("Task " + std::to_string(i), ""));
+    }
+
+    std::vector<std::string> args = {"1", "2", "5-7", "6-8"};
+    std::string result = handler->handleComplete(args);
+
+    EXPECT_NE(result.find("IDs 1-2: 2 marked as completed"), std::string::npos);
+    EXPECT_NE(result.find("IDs 5-8: 4 marked as completed"), std::string::npos);
+    EXPECT_NE(result.find("Total: 6 items"), std::string::npos);
+    EXPECT_EQ(repository->countCompleted(), 6);
+    EXPECT_FALSE(repository->findById(3)->isCompleted());
+}
+
+TEST_F(CliHandlerTest, HandleCompleteRangeNoneFound) {
+    std::vector<std::string> args = {"100-200"};
+    EXPECT_THROW(handler->handleComplete(args), NotFoundException);
+}
+
+TEST_F(CliHandlerTest, HandleCompleteInvalidRange) {
+    std::vector<std::string> args = {"9-3"};
+    EXPECT_THROW(handler->handleComplete(args), ValidationException);
+
+    args = {"3-x"};
+    EXPECT_THROW(handler->handleComplete(args), ValidationException);
+}
+
 // Test handleDelete
 TEST_F(CliHandlerTest, HandleDelete) {
     auto item = TodoItem("Task 1", "");
@@ -186,6 +284,78 @@ TEST_F(CliHandlerTest, HandleDeleteNonExistentId) {
     EXPECT_THROW(handler->handleDelete(args), NotFoundException);
 }
 
+TEST_F(CliHandlerTest, HandleDeleteRange) {
+    for (int i = 0; i < 10; ++i) {
+        repository->create(TodoItem("Task " + std::to_string(i), ""));
+    }
+
+    std::vector<std::string> args = {"3-5", "9"};
+    std::string result = handler->handleDelete(args);
+
+    EXPECT_NE(result.find("Total: 4 items deleted"), std::string::npos);
+    EXPECT_EQ(repository->count(), 6);
+}
+
+TEST_F(CliHandlerTest, HandleDeleteCompletedOlderThan) {
+    auto old_time = TodoItem::fromUnixTime(1000000000);
+    repository->create(TodoItem(0, "Old done", "", true, old_time));
+    repository->create(TodoItem(0, "Old pending", "", false, old_time));
+    auto recent = TodoItem("Recent done", "");
+    recent.setCompleted(true);
+    repository->create(recent);
+
+    std::string result = handler->handleDelete({}, {{"completed", "true"}, {"older-than", "30d"}});
+
+    EXPECT_NE(result.find("Total: 1 items deleted"), std::string::npos);
+    EXPECT_EQ(repository->count(), 2);
+    EXPECT_TRUE(repository->findByTitle("Old done").empty());
+}
+
+TEST_F(CliHandlerTest, HandleDeleteMatchingNothing) {
+    repository->create(TodoItem("Pending", ""));
+
+    std::string result = handler->handleDelete({}, {{"completed", "true"}});
+
+    EXPECT_NE(result.find("No todo items matched"), std::string::npos);
+    EXPECT_EQ(repository->count(), 1);
+}
+
+TEST_F(CliHandlerTest, HandleDeleteInvalidDuration) {
+    EXPECT_THROW(handler->handleDelete({}, {{"older-than", "30x"}}), ValidationException);
+    EXPECT_THROW(handler->handleDelete({}, {{"older-than", "d"}}), ValidationException);
+}
+
+TEST_F(CliHandlerTest, HandleDeleteHugeDurationDeletesNothing) {
+    handler->handleAdd({"Task 1"});
+    handler->handleAdd({"Task 2"});
+
+    // 22875426678707 weeks in seconds wraps a 64-bit time_t
+    EXPECT_THROW(handler->handleDelete({}, {{"older-than", "22875426678707w"}}), ValidationException);
+    EXPECT_THROW(handler->handleDelete({}, {{"older-than", "99999999999999999999s"}}), ValidationException);
+    EXPECT_EQ(repository->count(), 2);
+
+    // Longer ago than the epoch is in range and matches nothing
+    std::string result = handler->handleDelete({}, {{"older-than", "1000000w"}});
+    EXPECT_NE(result.find("No todo items matched"), std::string::npos);
+    EXPECT_EQ(repository->count(), 2);
+}
+
+TEST_F(CliHandlerTest, HandleDeleteFilterWithIds) {
+    std::vector<std::string> args = {"1"};
+    EXPECT_THROW(handler->handleDelete(args, {{"completed", "true"}}), ValidationException);
+}
+
+TEST_F(CliHandlerTest, HandleStats) {
+    handler->handleAdd({"Task 1"});
+    handler->handleAdd({"Task 2"});
+    handler->handleComplete({"1"});
+
+    std::string result = handler->handleStats();
+    EXPECT_NE(result.find("Total:     2"), std::string::npos);
+    EXPECT_NE(result.find("Pending:   1"), std::string::npos);
+    EXPECT_NE(result.find("Completed: 1 (50%)"), std::string::npos);
+}
+
 // Test handleSearch
 TEST_F(CliHandlerTest, HandleSearch) {
     repository->create(TodoItem("Buy groceries", ""));
@@ -200,6 +370,32 @@ TEST_F(CliHandlerTest, HandleSearch) {
     EXPECT_EQ(result.find("Sell car"), std::string::npos);
 }
 
+TEST_F(CliHandlerTest, HandleSearchEngines) {
+    repository->create(TodoItem("Buy groceries", ""));
+
+    std::vector<std::string> args = {"rocer"};
+    EXPECT_NE(handler->handleSearch(args).find("No todo items found"), std::string::npos);
+    EXPECT_NE(handler->handleSearch(args, {{"engine", "substring"}}).find("Buy groceries"), std::string::npos);
+    EXPECT_THROW(handler->handleSearch(args, {{"engine", "bogus"}}), ValidationException);
+}
+
+TEST_F(CliHandlerTest, HandleSearchSimdEngineMatchesSubstring) {
+    repository->create(TodoItem("Buy groceries", ""));
+    repository->create(TodoItem("GROCERY run", "done"));
+    repository->create(TodoItem("Sell car", ""));
+    repository->markCompleted(2);
+
+    std::vector<std::string> args = {"rocer"};
+    std::string simd = handler->handleSearch(args, {{"engine", "simd"}});
+    EXPECT_EQ(simd, handler->handleSearch(args, {{"engine", "substring"}}));
+    EXPECT_NE(simd.find("GROCERY run"), std::string::npos);
+    EXPECT_EQ(simd.find("Sell car"), std::string::npos);
+
+    args = {"nothing"};
+    EXPECT_NE(handler->handleSearch(args, {{"engine", "simd"}}).find("No todo items found"), std::string::npos);
+    EXPECT_THROW(handler->handleSearch(args, {{"engine", "simd"}, {"limit", "5"}}), ValidationException);
+}
+
 TEST_F(CliHandlerTest, HandleSearchNoResults) {
     repository->create(TodoItem("Task 1", ""));
 
@@ -63,6 +63,11 @@ TEST_F(CommandParserTest, ParseSearchCommand) {
     EXPECT_EQ(result.args[0], "groceries");
 }
 
+TEST_F(CommandParserTest, ParseStatsCommand) {
+    EXPECT_EQ(parser.parse({"stats"}).command, Command::STATS);
+    EXPECT_EQ(parser.parse({"st"}).command, Command::STATS);
+}
+
 TEST_F(CommandParserTest, ParseHelpCommand) {
     std::vector<std::string> args = {"help"};
     auto result = parser.parse(args);
@@ -152,6 +157,32 @@ TEST_F(CommandParserTest, ParseMultipleFlags) {
     EXPECT_EQ(result.getOption("filter"), "pending");
 }
 
+TEST_F(CommandParserTest, ParseInlineFlagValues) {
+    std::vector<std::string> args = {"search", "--engine=substring", "query", "--empty="};
+    auto result = parser.parse(args);
+
+    EXPECT_EQ(result.command, Command::SEARCH);
+    ASSERT_EQ(result.args.size(), 1);
+    EXPECT_EQ(result.args[0], "query");
+    EXPECT_EQ(result.getOption("engine"), "substring");
+    EXPECT_EQ(result.getOption("empty"), "");
+}
+
+TEST_F(CommandParserTest, SwitchesNeverTakeAValue) {
+    for (const auto& args : {std::vector<std::string>{"list", "pending", "--snapshot"},
+                             std::vector<std::string>{"list", "--snapshot", "pending"}}) {
+        auto result = parser.parse(args);
+        ASSERT_EQ(result.args.size(), 1) << args[1];
+        EXPECT_EQ(result.args[0], "pending");
+        EXPECT_EQ(result.getOption("snapshot"), "true");
+    }
+
+    auto result = parser.parse(std::vector<std::string>{"import", "--abort", "todos.csv"});
+    ASSERT_EQ(result.args.size(), 1);
+    EXPECT_EQ(result.args[0], "todos.csv");
+    EXPECT_TRUE(result.hasFlag("abort"));
+}
+
 TEST_F(CommandParserTest, ParseShortFlags) {
     std::vector<std::string> args = {"list", "-a"};
     auto result = parser.parse(args);
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include "todolist/connection_pool.h"
+#include "todolist/exceptions.h"
+#include <atomic>
+#include <filesystem>
+#include <thread>
+#include <vector>
+
+using namespace todolist;
+
+class ConnectionPoolTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        path_ = (std::filesystem::temp_directory_path() / "todolist_pool_test.db").string();
+        removeFiles();
+    }
+
+    void TearDown() override {
+        removeFiles();
+    }
+
+    void removeFiles() {
+        for (const char* suffix : {"", "-wal", "-shm"}) {
+            std::filesystem::remove(path_ + suffix);
+        }
+    }
+
+    std::string path_;
+};
+
+TEST_F(ConnectionPoolTest, ReadersSeeCommittedWrites) {
+    ConnectionPool pool(path_, 2);
+
+    int id;
+    {
+        auto writer = pool.acquireWriter();
+        id = writer.repository().create(TodoItem("Pooled task", "")).getId();
+        EXPECT_EQ(writer.database().pragma("journal_mode"), "wal");
+    }
+
+    auto reader = pool.acquireReader();
+    auto found = reader.repository().findById(id);
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(found->getTitle(), "Pooled task");
+}
+
+TEST_F(ConnectionPoolTest, ReadersAreReadOnly) {
+    ConnectionPool pool(path_, 1);
+
+    auto reader = pool.acquireReader();
+    EXPECT_THROW(reader.repository().create(TodoItem("Not allowed", "")), DatabaseException);
+}
+
+TEST_F(ConnectionPoolTest, LeasesHandOutDistinctConnections) {
+    ConnectionPool pool(path_, 2);
+
+    auto first = pool.acquireReader();
+    auto second = pool.acquireReader();
+    EXPECT_NE(&first.database(), &second.database());
+
+    // Returning a lease makes its connection available again
+    Database* returned = &first.database();
+    { auto released = std::move(first); }
+    auto third = pool.acquireReader();
+    EXPECT_EQ(&third.database(), returned);
+}
+
+TEST_F(ConnectionPoolTest, ConcurrentReads) {
+    ConnectionPool pool(path_, 4);
+    {
+        auto writer = pool.acquireWriter();
+        std::vector<TodoItem> items(100, TodoItem("Task", ""));
+        writer.repository().createBatch(items);
+    }
+
+    std::atomic<int> found{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&pool, &found] {
+            for (int i = 0; i < 50; ++i) {
+                auto reader = pool.acquireReader();
+                found += static_cast<int>(reader.repository().findAll().size());
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(found.load(), 8 * 50 * 100);
+}
+
+TEST_F(ConnectionPoolTest, RejectsInMemoryDatabase) {
+    EXPECT_THROW(ConnectionPool(":memory:", 2), ValidationException);
+    EXPECT_THROW(ConnectionPool(path_, 0), ValidationException);
+}
@@ -1,6 +1,9 @@
 #include <gtest/gtest.h>
 #include "todolist/database.h"
+#include "todolist/exceptions.h"
+#include <sqlite3.h>
 #include <filesystem>
+#include <cstdlib>
 
 using namespace todolist;
 
@@ -105,3 +108,238 @@ TEST_F(DatabaseTest, IndexCreation) {
     // we'll just ensure no error occurred during initialization
     EXPECT_TRUE(db.isOpen());
 }
+
+TEST_F(DatabaseTest, PrepareReusesCachedStatement) {
+    Database db(db_path_);
+    size_t initial = db.cachedStatementCount();
+
+    sqlite3_stmt* first = nullptr;
+    {
+        Statement stmt = db.prepare("SELECT COUNT(*) FROM todos");
+        first = stmt.get();
+    }
+    Statement stmt = db.prepare("SELECT COUNT(*) FROM todos");
+
+    EXPECT_EQ(stmt.get(), first);
+    EXPECT_EQ(db.cachedStatementCount(), initial + 1);
+}
+
+TEST_F(DatabaseTest, PrepareWhileCachedStatementInUse) {
+    Database db(db_path_);
+    size_t initial = db.cachedStatementCount();
+
+    Statement outer = db.prepare("SELECT COUNT(*) FROM todos");
+    Statement inner = db.prepare("SELECT COUNT(*) FROM todos");
+
+    EXPECT_NE(outer.get(), inner.get());
+    EXPECT_EQ(db.cachedStatementCount(), initial + 1);
+}
+
+TEST_F(DatabaseTest, PrepareInvalidSQL) {
+    Database db(db_path_);
+
+    EXPECT_THROW(db.prepare("INVALID SQL STATEMENT"), DatabaseException);
+}
+
+TEST_F(DatabaseTest, ClearStatementCache) {
+    Database db(db_path_);
+    {
+        Statement stmt = db.prepare("SELECT COUNT(*) FROM todos");
+    }
+    EXPECT_GT(db.cachedStatementCount(), 0);
+
+    db.clearStatementCache();
+
+    EXPECT_EQ(db.cachedStatementCount(), 0);
+}
+
+TEST_F(DatabaseTest, StatsSeededForExistingRows) {
+    std::string path = (std::filesystem::temp_directory_path() / "todolist_stats_seed.db").string();
+    std::filesystem::remove(path);
+    {
+        Database db(path);
+        db.execute("INSERT INTO todos (title, description, completed, created_at) VALUES ('Done', '', 1, 1)");
+        db.execute("INSERT INTO todos (title, description, completed, created_at) VALUES ('Open', '', 0, 2)");
+        // Simulate a database created before the summary table existed
+        db.execute("DROP TRIGGER todo_stats_insert");
+        db.execute("DROP TRIGGER todo_stats_delete");
+        db.execute("DROP TRIGGER todo_stats_update");
+        db.execute("DROP TABLE todo_stats");
+        db.execute("PRAGMA user_version = 4");
+    }
+
+    Database db(path);
+    Statement stmt = db.prepare("SELECT total, completed FROM todo_stats");
+    ASSERT_EQ(sqlite3_step(stmt.get()), SQLITE_ROW);
+    EXPECT_EQ(sqlite3_column_int(stmt.get(), 0), 2);
+    EXPECT_EQ(sqlite3_column_int(stmt.get(), 1), 1);
+
+    std::filesystem::remove(path);
+}
+
+TEST_F(DatabaseTest, FullTextIndexBackfilledForExistingRows) {
+    std::string path = (std::filesystem::temp_directory_path() / "todolist_fts_backfill.db").string();
+    std::filesystem::remove(path);
+    {
+        Database db(path);
+        db.execute("INSERT INTO todos (title, description, completed, created_at) VALUES ('Legacy row', '', 0, 1)");
+        // Simulate a database created before the full-text index existed
+        db.execute("DROP TABLE todos_fts");
+        db.execute("PRAGMA user_version = 2");
+    }
+
+    Database db(path);
+    Statement stmt = db.prepare("SELECT COUNT(*) FROM todos_fts WHERE todos_fts MATCH 'legacy'");
+    ASSERT_EQ(sqlite3_step(stmt.get()), SQLITE_ROW);
+    EXPECT_EQ(sqlite3_column_int(stmt.get(), 0), 1);
+
+    std::filesystem::remove(path);
+}
+
+TEST_F(DatabaseTest, DefaultOptionsApplied) {
+    std::string path = (std::filesystem::temp_directory_path() / "todolist_default_options.db").string();
+    std::filesystem::remove(path);
+    {
+        Database db(path);
+        EXPECT_EQ(db.pragma("journal_mode"), "wal");
+        EXPECT_EQ(db.pragma("synchronous"), "1");
+        EXPECT_EQ(db.pragma("busy_timeout"), "5000");
+        EXPECT_EQ(db.pragma("cache_size"), "-16384");
+        EXPECT_EQ(db.pragma("temp_store"), "2");
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_F(DatabaseTest, CustomOptionsApplied) {
+    std::string path = (std::filesystem::temp_directory_path() / "todolist_custom_options.db").string();
+    std::filesystem::remove(path);
+    {
+        DatabaseOptions options;
+        options.journal_mode = "delete";
+        options.synchronous = "full";
+        options.busy_timeout = 250;
+        options.cache_size = 500;
+        options.page_size = 8192;
+
+        Database db(path, options);
+        EXPECT_EQ(db.pragma("journal_mode"), "delete");
+        EXPECT_EQ(db.pragma("synchronous"), "2");
+        EXPECT_EQ(db.pragma("busy_timeout"), "250");
+        EXPECT_EQ(db.pragma("cache_size"), "500");
+        EXPECT_EQ(db.pragma("page_size"), "8192");
+
+        // Kept for opening further connections, as parallel exports do
+        EXPECT_EQ(db.getOptions().busy_timeout, 250);
+        EXPECT_EQ(db.getOptions().synchronous, "full");
+        Database moved(std::move(db));
+        EXPECT_EQ(moved.getOptions().cache_size, 500);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_F(DatabaseTest, OptionsSetByName) {
+    DatabaseOptions options;
+
+    EXPECT_TRUE(options.set("journal-mode", "truncate"));
+    EXPECT_EQ(options.journal_mode, "TRUNCATE");
+    EXPECT_TRUE(options.set("busy_timeout", "100"));
+    EXPECT_EQ(options.busy_timeout, 100);
+    EXPECT_FALSE(options.set("limit", "10"));
+
+    EXPECT_THROW(options.set("journal_mode", "bogus"), ValidationException);
+    EXPECT_THROW(options.set("busy_timeout", "soon"), ValidationException);
+    EXPECT_THROW(options.set("page_size", "1000"), ValidationException);
+}
+
+TEST_F(DatabaseTest, OptionsFromEnvironment) {
+    setenv("TODOLIST_SYNCHRONOUS", "extra", 1);
+    DatabaseOptions options = DatabaseOptions::fromEnvironment();
+    unsetenv("TODOLIST_SYNCHRONOUS");
+
+    EXPECT_EQ(options.synchronous, "EXTRA");
+    EXPECT_EQ(options.journal_mode, "WAL");
+}
+
+TEST_F(DatabaseTest, InvalidOptionFieldRejected) {
+    DatabaseOptions options;
+    options.journal_mode = "WAL; DROP TABLE todos";
+
+    EXPECT_THROW(Database db(db_path_, options), ValidationException);
+}
+
+namespace {
+
+int countRows(Database& db) {
+    Statement stmt = db.prepare("SELECT COUNT(*) FROM todos");
+    sqlite3_step(stmt.get());
+    return sqlite3_column_int(stmt.get(), 0);
+}
+
+void insertRow(Database& db) {
+    db.execute("INSERT INTO todos (title, created_at) VALUES ('Row', 1)");
+}
+
+} // anonymous namespace
+
+TEST_F(DatabaseTest, TransactionCommits) {
+    Database db(db_path_);
+    {
+        Transaction transaction(db, TransactionMode::IMMEDIATE);
+        EXPECT_TRUE(transaction.isActive());
+        insertRow(db);
+        insertRow(db);
+        transaction.commit();
+        EXPECT_FALSE(transaction.isActive());
+    }
+    EXPECT_EQ(countRows(db), 2);
+    EXPECT_NE(sqlite3_get_autocommit(db.getHandle()), 0);
+}
+
+TEST_F(DatabaseTest, TransactionRollsBackWhenNotCommitted) {
+    Database db(db_path_);
+    try {
+        Transaction transaction(db, TransactionMode::EXCLUSIVE);
+        insertRow(db);
+        throw std::runtime_error("abort");
+    } catch (const std::runtime_error&) {
+    }
+    EXPECT_EQ(countRows(db), 0);
+    EXPECT_NE(sqlite3_get_autocommit(db.getHandle()), 0);
+}
+
+TEST_F(DatabaseTest, TransactionsDoNotNest) {
+    Database db(db_path_);
+    Transaction outer(db);
+    EXPECT_THROW(Transaction inner(db), DatabaseException);
+}
+
+TEST_F(DatabaseTest, SavepointWithoutTransactionCommitsOnRelease) {
+    Database db(db_path_);
+    {
+        Savepoint savepoint(db);
+        insertRow(db);
+        savepoint.release();
+    }
+    EXPECT_EQ(countRows(db), 1);
+    EXPECT_NE(sqlite3_get_autocommit(db.getHandle()), 0);
+}
+
+TEST_F(DatabaseTest, SavepointRollbackKeepsOuterTransaction) {
+    Database db(db_path_);
+    Transaction transaction(db);
+    insertRow(db);
+    {
+        Savepoint savepoint(db);
+        insertRow(db);
+        {
+            Savepoint nested(db);
+            insertRow(db);
+            nested.release();
+        }
+        // Destroyed without release: both inner inserts are undone
+    }
+    EXPECT_TRUE(transaction.isActive());
+    transaction.commit();
+
+    EXPECT_EQ(countRows(db), 1);
+}
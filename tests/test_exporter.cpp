@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include "todolist/exporter.h"
+#include "todolist/buffered_writer.h"
+#include "todolist/cli_handler.h"
+#include "todolist/database.h"
+#include "todolist/exceptions.h"
+#include "todolist/todo_repository.h"
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <sstream>
+#include <string>
+
+using namespace todolist;
+
+class ExporterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        db_ = std::make_unique<Database>(":memory:");
+        repo_ = std::make_unique<TodoRepository>(*db_);
+    }
+
+    std::string exportAll(ExportFormat format) {
+        std::ostringstream out;
+        Exporter(*db_, format).exportTo(out);
+        return out.str();
+    }
+
+    std::unique_ptr<Database> db_;
+    std::unique_ptr<TodoRepository> repo_;
+};
+
+TEST_F(ExporterTest, BufferedWriterFlushesInChunks) {
+    std::ostringstream out;
+    {
+        BufferedWriter writer(out, 8);
+        writer.append("abc");
+        writer.appendInteger(-42);
+        EXPECT_TRUE(out.str().empty());
+
+        writer.append("0123456789");
+        writer.push_back('!');
+        writer.flush();
+        EXPECT_EQ(out.str(), "abc-420123456789!");
+
+        writer.append("tail");
+    }
+    EXPECT_EQ(out.str(), "abc-420123456789!tail");
+}
+
+TEST_F(ExporterTest, JsonLinesEscapesText) {
+    repo_->create(TodoItem(0, "Say \"hi\"\\", "line1\nline2\t\x01 caf\xC3\xA9", true, TodoItem::fromUnixTime(1700000000)));
+    repo_->create(TodoItem(0, "Plain", "", false, TodoItem::fromUnixTime(5)));
+
+    EXPECT_EQ(exportAll(ExportFormat::JSONL),
+              "{\"id\":1,\"title\":\"Say \\\"hi\\\"\\\\\",\"description\":\"line1\\nline2\\t\\u0001 caf\xC3\xA9\","
+              "\"completed\":true,\"created_at\":1700000000}\n"
+              "{\"id\":2,\"title\":\"Plain\",\"description\":\"\",\"completed\":false,\"created_at\":5}\n");
+}
+
+TEST_F(ExporterTest, JsonLinesReplacesInvalidUtf8) {
+    repo_->create(TodoItem(0, "bad\xFF" "byte", "caf\xC3\xA9\xC3", false, TodoItem::fromUnixTime(5)));
+
+    EXPECT_EQ(exportAll(ExportFormat::JSONL),
+              "{\"id\":1,\"title\":\"bad\\ufffdbyte\",\"description\":\"caf\xC3\xA9\\ufffd\","
+              "\"completed\":false,\"created_at\":5}\n");
+    EXPECT_EQ(exportAll(ExportFormat::CSV),
+              "id,title,description,completed,created_at\r\n"
+              "1,bad\xFF" "byte,caf\xC3\xA9\xC3,0,5\r\n");
+}
+
+TEST_F(ExporterTest, CsvQuotesOnlyWhenNeeded) {
+    repo_->create(TodoItem(0, "a, b", "say \"x\"", false, TodoItem::fromUnixTime(10)));
+    repo_->create(TodoItem(0, "plain", "two\nlines", true, TodoItem::fromUnixTime(20)));
+
+    EXPECT_EQ(exportAll(ExportFormat::CSV),
+              "id,title,description,completed,created_at\r\n"
+              "1,\"a, b\",\"say \"\"x\"\"\",0,10\r\n"
+              "2,plain,\"two\nlines\",1,20\r\n");
+}
+
+TEST_F(ExporterTest, EmptyTable) {
+    EXPECT_EQ(exportAll(ExportFormat::JSONL), "");
+    EXPECT_EQ(exportAll(ExportFormat::CSV), "id,title,description,completed,created_at\r\n");
+}
+
+TEST_F(ExporterTest, ParseFormat) {
+    EXPECT_EQ(parseExportFormat("jsonl"), ExportFormat::JSONL);
+    EXPECT_EQ(parseExportFormat("csv"), ExportFormat::CSV);
+    EXPECT_THROW(parseExportFormat("xml"), ValidationException);
+}
+
+TEST_F(ExporterTest, ParallelMatchesSerial) {
+    std::string path = (std::filesystem::temp_directory_path() / "todolist_exporter_test.db").string();
+    auto removeFiles = [&path] {
+        for (const char* suffix : {"", "-wal", "-shm"}) {
+            std::filesystem::remove(path + suffix);
+        }
+    };
+    removeFiles();
+    {
+        Database database(path);
+        TodoRepository repository(database);
+
+        // Several blocks, with a gap spanning a whole block
+        std::vector<TodoItem> items;
+        for (int i = 0; i < 12000; ++i) {
+            items.emplace_back("Task " + std::to_string(i), i % 7 == 0 ? "with, comma" : "");
+        }
+        repository.createBatch(items);
+        repository.removeRange(IdRange{4000, 9000});
+
+        for (ExportFormat format : {ExportFormat::JSONL, ExportFormat::CSV}) {
+            Exporter exporter(database, format);
+            std::ostringstream serial;
+            size_t serialRows = exporter.exportTo(serial);
+            EXPECT_EQ(serialRows, 6999u);
+
+            for (size_t threads : {2u, 4u, 64u}) {
+                std::ostringstream parallel;
+                EXPECT_EQ(exporter.exportParallel(path, threads, parallel), serialRows);
+                EXPECT_TRUE(parallel.str() == serial.str()) << threads << " threads";
+            }
+        }
+    }
+    removeFiles();
+}
+
+TEST_F(ExporterTest, CliValidatesOptions) {
+    CliHandler handler(*repo_, std::make_unique<Formatter>(false));
+    repo_->create(TodoItem("Task", ""));
+    std::ostringstream out;
+
+    EXPECT_THROW(handler.streamExport({{"format", "xml"}}, out), ValidationException);
+    EXPECT_THROW(handler.streamExport({{"parallel", "0"}}, out), ValidationException);
+    EXPECT_THROW(handler.streamExport({{"parallel", "true"}}, out), ValidationException);
+
+    // In-memory databases cannot be shared, so --parallel exports serially
+    handler.streamExport({{"format", "csv"}, {"parallel", "4"}}, out);
+    std::string text = out.str();
+    EXPECT_EQ(std::count(text.begin(), text.end(), '\n'), 2);
+}
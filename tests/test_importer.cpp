@@ -0,0 +1,309 @@
+#include <gtest/gtest.h>
+#include "todolist/importer.h"
+#include "todolist/cli_handler.h"
+#include "todolist/database.h"
+#include "todolist/exceptions.h"
+#include "todolist/exporter.h"
+#include "todolist/todo_repository.h"
+#include <sqlite3.h>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace todolist;
+
+class ImporterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        db_ = std::make_unique<Database>(":memory:");
+        repo_ = std::make_unique<TodoRepository>(*db_);
+    }
+
+    void TearDown() override {
+        for (const auto& path : files_) {
+            std::filesystem::remove(path);
+        }
+    }
+
+    std::string writeFile(const std::string& name, const std::string& content) {
+        std::string path = (std::filesystem::temp_directory_path() / ("todolist_importer_" + name)).string();
+        std::ofstream(path, std::ios::binary) << content;
+        files_.push_back(path);
+        return path;
+    }
+
+    int64_t queryInt(const std::string& sql) {
+        Statement stmt = db_->prepare(sql);
+        EXPECT_EQ(sqlite3_step(stmt.get()), SQLITE_ROW);
+        return sqlite3_column_int64(stmt.get(), 0);
+    }
+
+    std::string schemaObjects(const std::string& types = "'index', 'trigger'") {
+        Statement stmt = db_->prepare(
+            "SELECT group_concat(name, ',') FROM (SELECT name FROM sqlite_master "
+            "WHERE tbl_name = 'todos' AND type IN (" + types + ") ORDER BY name)");
+        EXPECT_EQ(sqlite3_step(stmt.get()), SQLITE_ROW);
+        const unsigned char* text = sqlite3_column_text(stmt.get(), 0);
+        return text ? reinterpret_cast<const char*>(text) : "";
+    }
+
+    std::unique_ptr<Database> db_;
+    std::unique_ptr<TodoRepository> repo_;
+    std::vector<std::string> files_;
+};
+
+TEST_F(ImporterTest, RoundTripsExports) {
+    Database source(":memory:");
+    TodoRepository sourceRepo(source);
+    sourceRepo.create(TodoItem(0, "Say \"hi\", \\ caf\xC3\xA9", "line1\nline2\r\n\t\x01", true, TodoItem::fromUnixTime(1700000000)));
+    sourceRepo.create(TodoItem(0, "Plain", "", false, TodoItem::fromUnixTime(5)));
+
+    for (ExportFormat format : {ExportFormat::JSONL, ExportFormat::CSV}) {
+        std::ostringstream exported;
+        Exporter(source, format).exportTo(exported);
+        std::string path = writeFile(format == ExportFormat::CSV ? "roundtrip.csv" : "roundtrip.jsonl", exported.str());
+
+        // A fresh database per format, so the ids match again
+        Database target(":memory:");
+        ImportResult result = Importer(target, format).importFile(path);
+        EXPECT_EQ(result.rows, 2u);
+        EXPECT_EQ(result.total_rows, 2u);
+        EXPECT_FALSE(result.resumed);
+
+        std::ostringstream reexported;
+        Exporter(target, format).exportTo(reexported);
+        EXPECT_EQ(reexported.str(), exported.str());
+    }
+}
+
+TEST_F(ImporterTest, InvalidUtf8RoundTripsAsReplacementCharacters) {
+    Database source(":memory:");
+    TodoRepository sourceRepo(source);
+    sourceRepo.create(TodoItem(0, "bad\xFF" "byte", "", false, TodoItem::fromUnixTime(5)));
+
+    std::ostringstream exported;
+    Exporter(source, ExportFormat::JSONL).exportTo(exported);
+    std::string path = writeFile("invalid.jsonl", exported.str());
+    Importer(*db_, ExportFormat::JSONL).importFile(path);
+
+    auto items = repo_->findAll();
+    ASSERT_EQ(items.size(), 1u);
+    EXPECT_EQ(items[0].getTitle(), "bad\xEF\xBF\xBD" "byte");
+}
+
+TEST_F(ImporterTest, ParsesHandWrittenJsonLines) {
+    std::string path = writeFile("hand.jsonl",
+        "\n"
+        "  { \"id\" : 99, \"title\" : \"Caf\\u00e9 \\ud83d\\ude00\\/\", \"extra\": {\"a\": [1, \"}\", {}]}, "
+        "\"description\": null, \"completed\": 1, \"created_at\": -5 }\r\n"
+        "{\"title\":\"No extras\"}");
+
+    ImportResult result = Importer(*db_, ExportFormat::JSONL).importFile(path);
+    EXPECT_EQ(result.rows, 2u);
+
+    auto items = repo_->findAll();
+    ASSERT_EQ(items.size(), 2u);
+    // Newest first
+    const TodoItem& first = items[1];
+    EXPECT_EQ(first.getId(), 1);
+    EXPECT_EQ(first.getTitle(), "Caf\xC3\xA9 \xF0\x9F\x98\x80/");
+    EXPECT_EQ(first.getDescription(), "");
+    EXPECT_TRUE(first.isCompleted());
+    EXPECT_EQ(first.getCreatedAtUnix(), -5);
+    EXPECT_EQ(items[0].getTitle(), "No extras");
+    EXPECT_FALSE(items[0].isCompleted());
+    EXPECT_GT(items[0].getCreatedAtUnix(), 1700000000);
+}
+
+TEST_F(ImporterTest, ParsesCsvByHeaderNames) {
+    std::string path = writeFile("columns.csv",
+        "created_at,notes,completed,title,description\n"
+        "10,x,true,\"Multi\nline, \"\"quoted\"\"\",\n"
+        "\n"
+        ",y,,Second,desc\r\n");
+
+    ImportResult result = Importer(*db_, ExportFormat::CSV).importFile(path);
+    EXPECT_EQ(result.rows, 2u);
+
+    auto first = repo_->findById(1);
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first->getTitle(), "Multi\nline, \"quoted\"");
+    EXPECT_EQ(first->getDescription(), "");
+    EXPECT_TRUE(first->isCompleted());
+    EXPECT_EQ(first->getCreatedAtUnix(), 10);
+
+    auto second = repo_->findById(2);
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(second->getTitle(), "Second");
+    EXPECT_EQ(second->getDescription(), "desc");
+    EXPECT_FALSE(second->isCompleted());
+}
+
+TEST_F(ImporterTest, ReportsTheLineOfMalformedRows) {
+    auto expectError = [this](ExportFormat format, const std::string& content, const std::string& fragment) {
+        // A fresh database each time, so no checkpoint is left from the last case
+        Database database(":memory:");
+        std::string path = writeFile("bad", content);
+        try {
+            Importer(database, format).importFile(path);
+            ADD_FAILURE() << "no error for: " << content;
+        } catch (const ValidationException& e) {
+            EXPECT_NE(std::string(e.what()).find(fragment), std::string::npos) << e.what();
+        }
+    };
+
+    expectError(ExportFormat::JSONL, "{\"title\":\"a\"}\n\n{\"title\":\"b\" x}\n", "line 3");
+    expectError(ExportFormat::JSONL, "{\"title\":\"a\"} {}\n", "line 1");
+    expectError(ExportFormat::JSONL, "{\"title\":\"\"}\n", "title");
+    expectError(ExportFormat::JSONL, "{\"title\":\"a\\q\"}\n", "escape");
+    expectError(ExportFormat::JSONL, "{\"title\":\"a\",\"completed\":\"yes\"}\n", "completed");
+    expectError(ExportFormat::CSV, "title,completed\n\"two\nlines\",1\nx,maybe\n", "line 4");
+    expectError(ExportFormat::CSV, "title,description\na\n", "expected 2 fields");
+    expectError(ExportFormat::CSV, "description\nx\n", "title column");
+    expectError(ExportFormat::CSV, "title\n\"open\n", "unterminated");
+}
+
+TEST_F(ImporterTest, RestoresIndexesAndDerivedData) {
+    repo_->create(TodoItem("Existing groceries", ""));
+    std::string before = schemaObjects();
+    ASSERT_NE(before.find("idx_todos_completed"), std::string::npos);
+
+    std::string path = writeFile("derived.jsonl",
+        "{\"title\":\"Buy groceries\",\"completed\":true}\n"
+        "{\"title\":\"Walk the dog\",\"description\":\"groceries on the way\"}\n");
+    Importer(*db_, ExportFormat::JSONL, 1).importFile(path);
+
+    EXPECT_EQ(schemaObjects(), before);
+    EXPECT_EQ(queryInt("SELECT COUNT(*) FROM import_checkpoint"), 0);
+    EXPECT_EQ(queryInt("SELECT COUNT(*) FROM import_deferred"), 0);
+    EXPECT_EQ(repo_->search("groceries").size(), 3u);
+    EXPECT_EQ(repo_->findByTitle("the do").size(), 1u);
+
+    TodoStats stats = repo_->stats();
+    EXPECT_EQ(stats.total, 3);
+    EXPECT_EQ(stats.completed, 1);
+
+    // The triggers are back
+    repo_->create(TodoItem("More groceries", ""));
+    EXPECT_EQ(repo_->search("groceries").size(), 4u);
+    EXPECT_EQ(repo_->stats().total, 4);
+}
+
+TEST_F(ImporterTest, OtherTriggersFireForImportedRows) {
+    db_->execute("CREATE TABLE audit (title TEXT);"
+                 "CREATE TRIGGER todos_audit AFTER INSERT ON todos BEGIN "
+                 "INSERT INTO audit (title) VALUES (new.title); END;");
+
+    std::string path = writeFile("audit.csv", "title\nOne\nTwo\nThree\nFour\n");
+    Importer(*db_, ExportFormat::CSV, 2).importFile(path);
+
+    EXPECT_EQ(queryInt("SELECT COUNT(*) FROM audit"), 4);
+    EXPECT_NE(schemaObjects("'trigger'").find("todos_audit"), std::string::npos);
+    EXPECT_EQ(repo_->stats().total, 4);
+    EXPECT_EQ(repo_->search("three").size(), 1u);
+}
+
+TEST_F(ImporterTest, ResumesAfterAnInterruption) {
+    std::string rows;
+    for (int i = 1; i <= 5; ++i) {
+        rows += "{\"title\":\"Task " + std::to_string(i) + "\"}\n";
+    }
+    std::string path = writeFile("resume.jsonl", rows + "{\"title\":\"Task 6\"\n{\"title\":\"Task 7\"}\n");
+
+    // Two transactions of two rows commit before the bad line
+    EXPECT_THROW(Importer(*db_, ExportFormat::JSONL, 2).importFile(path), ValidationException);
+    EXPECT_EQ(queryInt("SELECT COUNT(*) FROM todos"), 4);
+    EXPECT_EQ(queryInt("SELECT COUNT(*) FROM import_checkpoint"), 1);
+    EXPECT_EQ(schemaObjects("'index'"), "");
+    EXPECT_NE(schemaObjects("'trigger'"), "");
+
+    // The committed rows are searchable and counted while the import waits
+    EXPECT_EQ(repo_->search("task").size(), 4u);
+    EXPECT_EQ(repo_->stats().total, 4);
+
+    // Another file has to wait
+    std::string other = writeFile("other.jsonl", "{\"title\":\"Other\"}\n");
+    EXPECT_THROW(Importer(*db_, ExportFormat::JSONL).importFile(other), ValidationException);
+
+    // Fix the bad line and run again
+    writeFile("resume.jsonl", rows + "{\"title\":\"Task 6\"}\n{\"title\":\"Task 7\"}\n");
+    ImportResult result = Importer(*db_, ExportFormat::JSONL, 2).importFile(path);
+    EXPECT_TRUE(result.resumed);
+    EXPECT_EQ(result.rows, 3u);
+    EXPECT_EQ(result.total_rows, 7u);
+
+    auto items = repo_->findAll();
+    ASSERT_EQ(items.size(), 7u);
+    for (int i = 0; i < 7; ++i) {
+        EXPECT_EQ(items[6 - i].getTitle(), "Task " + std::to_string(i + 1));
+    }
+    EXPECT_NE(schemaObjects(), "");
+    EXPECT_EQ(repo_->stats().total, 7);
+    EXPECT_EQ(repo_->search("task").size(), 7u);
+}
+
+TEST_F(ImporterTest, KeepsDerivedDataRightDuringAStoppedImport) {
+    std::string path = writeFile("stopped.csv", "title\nFirst task\nSecond task\nbad,field\n");
+    EXPECT_THROW(Importer(*db_, ExportFormat::CSV, 1).importFile(path), ValidationException);
+    ASSERT_EQ(queryInt("SELECT COUNT(*) FROM import_checkpoint"), 1);
+
+    // Changes made before the import finishes go through the triggers
+    ASSERT_EQ(repo_->markCompleted(1).status, CompleteStatus::COMPLETED);
+    ASSERT_TRUE(repo_->remove(2));
+    repo_->create(TodoItem("Third task", ""));
+
+    TodoStats stats = repo_->stats();
+    EXPECT_EQ(stats.total, 2);
+    EXPECT_EQ(stats.completed, 1);
+    EXPECT_EQ(repo_->search("second").size(), 0u);
+    EXPECT_EQ(repo_->search("task").size(), 2u);
+    EXPECT_EQ(repo_->findByTitle("econd t").size(), 0u);
+    EXPECT_EQ(repo_->findByTitle("ird t").size(), 1u);
+}
+
+TEST_F(ImporterTest, AbortsAStoppedImport) {
+    EXPECT_THROW(Importer(*db_, ExportFormat::CSV).abort(), ValidationException);
+
+    std::string before = schemaObjects();
+    std::string path = writeFile("abort.csv", "title\nFirst\nSecond\nbad,field\n");
+    EXPECT_THROW(Importer(*db_, ExportFormat::CSV, 1).importFile(path), ValidationException);
+
+    EXPECT_EQ(Importer(*db_, ExportFormat::CSV).abort(), 2u);
+    EXPECT_EQ(schemaObjects(), before);
+    EXPECT_EQ(queryInt("SELECT COUNT(*) FROM import_checkpoint"), 0);
+    EXPECT_EQ(queryInt("SELECT COUNT(*) FROM import_deferred"), 0);
+    EXPECT_EQ(repo_->stats().total, 2);
+    EXPECT_EQ(repo_->search("second").size(), 1u);
+
+    // Another file can be imported now, and so can the original one
+    std::string other = writeFile("after.jsonl", "{\"title\":\"Third\"}\n");
+    EXPECT_FALSE(Importer(*db_, ExportFormat::JSONL).importFile(other).resumed);
+    EXPECT_EQ(repo_->stats().total, 3);
+    EXPECT_EQ(schemaObjects(), before);
+}
+
+TEST_F(ImporterTest, RejectsAFileChangedBeforeTheCheckpoint) {
+    std::string path = writeFile("changed.csv", "title\nFirst\nSecond\nbad,field\n");
+    EXPECT_THROW(Importer(*db_, ExportFormat::CSV, 1).importFile(path), ValidationException);
+    EXPECT_EQ(queryInt("SELECT COUNT(*) FROM todos"), 2);
+
+    writeFile("changed.csv", "title\nFirst item\nSecond\n");
+    EXPECT_THROW(Importer(*db_, ExportFormat::CSV, 1).importFile(path), ValidationException);
+    EXPECT_EQ(queryInt("SELECT COUNT(*) FROM todos"), 2);
+}
+
+TEST_F(ImporterTest, CliPicksTheFormat) {
+    CliHandler handler(*repo_, std::make_unique<Formatter>(false));
+    std::string csv = writeFile("cli.csv", "title\nFrom CSV\n");
+    std::string jsonl = writeFile("cli.txt", "{\"title\":\"From JSON\"}\n");
+
+    EXPECT_NE(handler.handleImport({csv}).find("1 todo item imported"), std::string::npos);
+    EXPECT_THROW(handler.handleImport({jsonl}, {{"format", "csv"}}), ValidationException);
+    EXPECT_THROW(handler.handleImport({}), ValidationException);
+    EXPECT_THROW(handler.handleImport({csv + ".missing"}), ValidationException);
+    EXPECT_THROW(handler.handleImport({}, {{"abort", "true"}}), ValidationException);
+    EXPECT_THROW(handler.handleImport({csv}, {{"abort", "true"}}), ValidationException);
+}
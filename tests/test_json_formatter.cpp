@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include "todolist/json_formatter.h"
+#include "todolist/cli_handler.h"
+#include "todolist/database.h"
+#include "todolist/exceptions.h"
+#include "todolist/json_escape.h"
+#include "todolist/todo_repository.h"
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace todolist;
+
+class JsonFormatterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        db_ = std::make_unique<Database>(":memory:");
+        repo_ = std::make_unique<TodoRepository>(*db_);
+        useOutput(OutputMode::JSON);
+    }
+
+    void useOutput(OutputMode mode) {
+        handler_ = std::make_unique<CliHandler>(*repo_, makeFormatter(mode, true));
+    }
+
+    void seed() {
+        repo_->create(TodoItem(0, "First", "Say \"hi\"\n", true, TodoItem::fromUnixTime(100)));
+        repo_->create(TodoItem(0, "Second", "", false, TodoItem::fromUnixTime(200)));
+    }
+
+    static std::string escape(std::string_view text) {
+        std::string out;
+        appendJsonString(out, text);
+        return out;
+    }
+
+    static constexpr const char* kFirst =
+        "{\"id\":1,\"title\":\"First\",\"description\":\"Say \\\"hi\\\"\\n\",\"completed\":true,\"created_at\":100}";
+    static constexpr const char* kSecond =
+        "{\"id\":2,\"title\":\"Second\",\"description\":\"\",\"completed\":false,\"created_at\":200}";
+
+    std::unique_ptr<Database> db_;
+    std::unique_ptr<TodoRepository> repo_;
+    std::unique_ptr<CliHandler> handler_;
+};
+
+TEST_F(JsonFormatterTest, EscapesStrings) {
+    EXPECT_EQ(escape(""), "\"\"");
+    EXPECT_EQ(escape("plain caf\xC3\xA9"), "\"plain caf\xC3\xA9\"");
+    EXPECT_EQ(escape("a\"b\\c/d"), "\"a\\\"b\\\\c/d\"");
+    EXPECT_EQ(escape("\n\r\t\b\f\x01\x1F"), "\"\\n\\r\\t\\b\\f\\u0001\\u001f\"");
+    EXPECT_EQ(escape(std::string(40, 'x') + "\"" + std::string(40, 'y')),
+              "\"" + std::string(40, 'x') + "\\\"" + std::string(40, 'y') + "\"");
+}
+
+TEST_F(JsonFormatterTest, ReplacesInvalidUtf8) {
+    // Well-formed two, three and four byte sequences pass through
+    EXPECT_EQ(escape("\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80"), "\"\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80\"");
+
+    EXPECT_EQ(escape("bad\xFF" "byte"), "\"bad\\ufffdbyte\"");
+    EXPECT_EQ(escape("\x80\xC3"), "\"\\ufffd\\ufffd\"");             // Stray continuation, truncated lead
+    EXPECT_EQ(escape("\xC0\xAF"), "\"\\ufffd\\ufffd\"");             // Overlong '/'
+    EXPECT_EQ(escape("\xED\xA0\x80"), "\"\\ufffd\\ufffd\\ufffd\""); // Surrogate
+    EXPECT_EQ(escape("\xF4\x90\x80\x80x"), "\"\\ufffd\\ufffd\\ufffd\\ufffdx\""); // Above U+10FFFF
+    EXPECT_EQ(escape("\xC3\xA9\xFF\xC3\xA9\"" + std::string(40, 'z') + "\xFF"),
+              "\"\xC3\xA9\\ufffd\xC3\xA9\\\"" + std::string(40, 'z') + "\\ufffd\"");
+
+    repo_->create(TodoItem(0, "bad\xFF" "byte", "", false, TodoItem::fromUnixTime(100)));
+    EXPECT_NE(handler_->handleList({}).find("\"title\":\"bad\\ufffdbyte\""), std::string::npos);
+}
+
+TEST_F(JsonFormatterTest, EscapeScanAgreesAcrossLevels) {
+    std::mt19937 random(7);
+    const char alphabet[] = {'a', 'Z', ' ', '"', '\\', '\n', '\x1F', '\x20', '\x7F', '\x80', '\xFF'};
+    for (int round = 0; round < 2000; ++round) {
+        std::string text(random() % 80, 'a');
+        for (char& c : text) {
+            // Mostly plain bytes, so the first special byte lands anywhere
+            c = random() % 16 == 0 ? alphabet[random() % sizeof(alphabet)] : 'q';
+        }
+
+        size_t expected = findJsonEscape(text.data(), text.size(), SimdLevel::SCALAR);
+        for (SimdLevel level : {SimdLevel::SSE2, SimdLevel::AVX2}) {
+            EXPECT_EQ(findJsonEscape(text.data(), text.size(), level), expected) << text;
+        }
+    }
+}
+
+TEST_F(JsonFormatterTest, ParsesOutputModes) {
+    EXPECT_EQ(parseOutputMode("text"), OutputMode::TEXT);
+    EXPECT_EQ(parseOutputMode("json"), OutputMode::JSON);
+    EXPECT_EQ(parseOutputMode("ndjson"), OutputMode::NDJSON);
+    EXPECT_THROW(parseOutputMode("xml"), ValidationException);
+
+    EXPECT_FALSE(makeFormatter(OutputMode::TEXT, false)->isStructured());
+    EXPECT_TRUE(makeFormatter(OutputMode::NDJSON, true)->isStructured());
+}
+
+TEST_F(JsonFormatterTest, ListsAsOneDocument) {
+    EXPECT_EQ(handler_->handleList({}), "{\"total\":0,\"completed\":0,\"items\":[]}\n");
+
+    seed();
+    EXPECT_EQ(handler_->handleList({}),
+              std::string("{\"total\":2,\"completed\":1,\"items\":[") + kSecond + "," + kFirst + "]}\n");
+    EXPECT_EQ(handler_->handleList({"pending"}),
+              std::string("{\"total\":1,\"completed\":0,\"items\":[") + kSecond + "]}\n");
+
+    std::string page = handler_->handleList({}, {{"limit", "1"}});
+    EXPECT_EQ(page.rfind(std::string("{\"total\":1,\"completed\":0,\"items\":[") + kSecond + "],\"next_cursor\":\"", 0),
+              0u) << page;
+    EXPECT_EQ(page.substr(page.size() - 3), "\"}\n");
+}
+
+TEST_F(JsonFormatterTest, ListsOneItemPerLine) {
+    useOutput(OutputMode::NDJSON);
+    EXPECT_EQ(handler_->handleList({}), "");
+
+    seed();
+    EXPECT_EQ(handler_->handleList({}), std::string(kSecond) + "\n" + kFirst + "\n");
+
+    std::string page = handler_->handleList({}, {{"limit", "1"}});
+    EXPECT_EQ(page.rfind(std::string(kSecond) + "\n{\"next_cursor\":\"", 0), 0u) << page;
+}
+
+TEST_F(JsonFormatterTest, SearchIncludesTheQuery) {
+    seed();
+    for (const char* engine : {"fts", "substring", "simd"}) {
+        EXPECT_EQ(handler_->handleSearch({"first"}, {{"engine", engine}}),
+                  std::string("{\"query\":\"first\",\"total\":1,\"completed\":1,\"items\":[") + kFirst + "]}\n")
+            << engine;
+        EXPECT_EQ(handler_->handleSearch({"nothing"}, {{"engine", engine}}),
+                  "{\"query\":\"nothing\",\"total\":0,\"completed\":0,\"items\":[]}\n")
+            << engine;
+    }
+}
+
+TEST_F(JsonFormatterTest, FormatsCommandResults) {
+    std::string added = handler_->handleAdd({"Title", "Tab\there"});
+    EXPECT_EQ(added.rfind("{\"status\":\"ok\",\"message\":\"Todo item created successfully\","
+                          "\"item\":{\"id\":1,\"title\":\"Title\",\"description\":\"Tab\\there\","
+                          "\"completed\":false,\"created_at\":", 0), 0u) << added;
+
+    EXPECT_NE(handler_->handleComplete({"1"}).find("\"completed\":true"), std::string::npos);
+    EXPECT_EQ(handler_->handleStats(), "{\"total\":1,\"completed\":1,\"pending\":0}");
+
+    handler_->handleAdd({"Another"});
+    EXPECT_EQ(handler_->handleDelete({"1-2"}),
+              "{\"status\":\"ok\",\"message\":\"Total: 2 items deleted\",\"count\":2,"
+              "\"steps\":[\"IDs 1-2: 2 deleted\"]}");
+
+    EXPECT_EQ(handler_->handleVersion().rfind("{\"version\":\"", 0), 0u);
+    EXPECT_EQ(handler_->handleHelp({"add"}).rfind("{\"status\":\"ok\",\"help\":\"", 0), 0u);
+    EXPECT_EQ(handler_->getFormatter().formatError("Bad \"id\""),
+              "{\"status\":\"error\",\"error\":\"Bad \\\"id\\\"\"}");
+}
+
+TEST_F(JsonFormatterTest, TextOutputIsUnchanged) {
+    useOutput(OutputMode::TEXT);
+    handler_->getFormatter().setColorEnabled(false);
+    seed();
+
+    std::string list = handler_->handleList({});
+    EXPECT_NE(list.find("Todo Items"), std::string::npos);
+    EXPECT_NE(list.find("[2] [ ] Second"), std::string::npos);
+    EXPECT_EQ(handler_->handleSearch({"zzz"}), "ℹ No todo items found matching: zzz");
+}
@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include "todolist/lru_cache.h"
+#include <string>
+
+using namespace todolist;
+
+class LruCacheTest : public ::testing::Test {
+protected:
+    LruCache<int, std::string> cache{2};
+};
+
+TEST_F(LruCacheTest, GetReturnsStoredValue) {
+    cache.put(1, "one");
+
+    const std::string* value = cache.get(1);
+    ASSERT_NE(value, nullptr);
+    EXPECT_EQ(*value, "one");
+    EXPECT_EQ(cache.get(2), nullptr);
+}
+
+TEST_F(LruCacheTest, EvictsLeastRecentlyUsed) {
+    cache.put(1, "one");
+    cache.put(2, "two");
+    cache.get(1);  // 2 is now the oldest
+    cache.put(3, "three");
+
+    EXPECT_EQ(cache.size(), 2);
+    EXPECT_NE(cache.get(1), nullptr);
+    EXPECT_EQ(cache.get(2), nullptr);
+    EXPECT_NE(cache.get(3), nullptr);
+}
+
+TEST_F(LruCacheTest, PutReplacesExistingValue) {
+    cache.put(1, "one");
+    cache.put(1, "uno");
+
+    EXPECT_EQ(cache.size(), 1);
+    EXPECT_EQ(*cache.get(1), "uno");
+}
+
+TEST_F(LruCacheTest, EraseAndClear) {
+    cache.put(1, "one");
+    cache.put(2, "two");
+
+    EXPECT_TRUE(cache.erase(1));
+    EXPECT_FALSE(cache.erase(1));
+    EXPECT_EQ(cache.get(1), nullptr);
+
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0);
+    EXPECT_EQ(cache.get(2), nullptr);
+}
+
+TEST_F(LruCacheTest, CountsHitsAndMisses) {
+    cache.put(1, "one");
+    cache.get(1);
+    cache.get(1);
+    cache.get(5);
+
+    CacheStats stats = cache.stats();
+    EXPECT_EQ(stats.hits, 2u);
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.size, 1u);
+    EXPECT_EQ(stats.capacity, 2u);
+}
+
+TEST_F(LruCacheTest, ZeroCapacityCachesNothing) {
+    LruCache<int, std::string> disabled(0);
+    disabled.put(1, "one");
+
+    EXPECT_EQ(disabled.size(), 0);
+    EXPECT_EQ(disabled.get(1), nullptr);
+}
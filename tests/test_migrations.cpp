@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include "todolist/migrations.h"
+#include "todolist/database.h"
+#include "todolist/exceptions.h"
+#include <sqlite3.h>
+#include <filesystem>
+#include <string>
+
+using namespace todolist;
+
+class MigrationsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        db_path_ = (std::filesystem::temp_directory_path() / "todolist_migrations_test.db").string();
+        removeFiles();
+    }
+
+    void TearDown() override {
+        removeFiles();
+    }
+
+    void removeFiles() {
+        std::filesystem::remove(db_path_);
+        std::filesystem::remove(db_path_ + "-wal");
+        std::filesystem::remove(db_path_ + "-shm");
+    }
+
+    static int queryInt(Database& db, const std::string& sql) {
+        Statement stmt = db.prepare(sql);
+        EXPECT_EQ(sqlite3_step(stmt.get()), SQLITE_ROW);
+        return sqlite3_column_int(stmt.get(), 0);
+    }
+
+    std::string db_path_;
+};
+
+TEST_F(MigrationsTest, VersionsAscend) {
+    const auto& migrations = schemaMigrations();
+    ASSERT_FALSE(migrations.empty());
+    for (size_t i = 0; i < migrations.size(); ++i) {
+        EXPECT_EQ(migrations[i].version, static_cast<int>(i) + 1);
+    }
+    EXPECT_EQ(latestSchemaVersion(), migrations.back().version);
+}
+
+TEST_F(MigrationsTest, NewDatabaseAtLatestVersion) {
+    Database db(":memory:");
+    EXPECT_EQ(db.schemaVersion(), latestSchemaVersion());
+    EXPECT_TRUE(db.tableExists("todos"));
+    EXPECT_TRUE(db.tableExists("todos_fts"));
+    EXPECT_TRUE(db.tableExists("todos_trigram"));
+    EXPECT_TRUE(db.tableExists("todo_stats"));
+}
+
+TEST_F(MigrationsTest, CurrentSchemaOpensWithSingleRead) {
+    {
+        Database db(db_path_);
+    }
+
+    // Only the user_version statement is prepared on the way in
+    Database db(db_path_);
+    EXPECT_EQ(db.cachedStatementCount(), 1u);
+    EXPECT_EQ(db.schemaVersion(), latestSchemaVersion());
+}
+
+TEST_F(MigrationsTest, NewerSchemaRejected) {
+    {
+        Database db(db_path_);
+        db.execute("PRAGMA user_version = " + std::to_string(latestSchemaVersion() + 1));
+    }
+
+    EXPECT_THROW({
+        Database db(db_path_);
+    }, DatabaseException);
+}
+
+TEST_F(MigrationsTest, UnversionedDatabaseAdopted) {
+    {
+        Database db(db_path_);
+        db.execute("INSERT INTO todos (title, description, completed, created_at) VALUES ('Kept', '', 1, 1)");
+        // A database created before versioning has every table but no version
+        db.execute("PRAGMA user_version = 0");
+    }
+
+    Database db(db_path_);
+    EXPECT_EQ(db.schemaVersion(), latestSchemaVersion());
+    EXPECT_EQ(queryInt(db, "SELECT total FROM todo_stats"), 1);
+    EXPECT_EQ(queryInt(db, "SELECT completed FROM todo_stats"), 1);
+    EXPECT_EQ(queryInt(db, "SELECT COUNT(*) FROM todos_fts WHERE todos_fts MATCH 'kept'"), 1);
+}
+
+TEST_F(MigrationsTest, BackfillResumesWithConcurrentWrites) {
+    Database db(db_path_);
+    for (int i = 1; i <= 10; ++i) {
+        db.execute("INSERT INTO todos (title, description, completed, created_at) VALUES ('row" +
+                   std::to_string(i) + "', 'original', 0, " + std::to_string(i) + ")");
+    }
+
+    // Go back to before the full-text index existed
+    db.execute("DROP TRIGGER todos_fts_insert");
+    db.execute("DROP TRIGGER todos_fts_delete");
+    db.execute("DROP TRIGGER todos_fts_update");
+    db.execute("DROP TABLE todos_fts");
+    db.execute("PRAGMA user_version = 2");
+
+    // Start the migration and copy the first chunk only
+    const Migration& fts = schemaMigrations()[2];
+    ASSERT_EQ(fts.version, 3);
+    ASSERT_NE(fts.backfill, nullptr);
+    fts.apply(db);
+    EXPECT_FALSE(fts.backfill(db, 4));
+
+    // Writes between chunks, on both sides of the copy position
+    db.execute("UPDATE todos SET description = 'edited' WHERE id = 2");
+    db.execute("UPDATE todos SET description = 'edited' WHERE id = 7");
+    db.execute("DELETE FROM todos WHERE id = 3");
+    db.execute("DELETE FROM todos WHERE id = 8");
+    db.execute("INSERT INTO todos (title, description, completed, created_at) VALUES ('row11', 'edited', 0, 11)");
+
+    // A later start picks the backfill up where it stopped
+    runMigrations(db, 4);
+
+    EXPECT_EQ(db.schemaVersion(), latestSchemaVersion());
+    EXPECT_EQ(queryInt(db, "SELECT COUNT(*) FROM schema_backfill"), 0);
+    EXPECT_NO_THROW(db.execute("INSERT INTO todos_fts(todos_fts) VALUES ('integrity-check')"));
+    EXPECT_EQ(queryInt(db, "SELECT COUNT(*) FROM todos_fts WHERE todos_fts MATCH 'edited'"), 3);
+    EXPECT_EQ(queryInt(db, "SELECT COUNT(*) FROM todos_fts WHERE todos_fts MATCH 'original'"), 6);
+
+    // The final triggers handle every row
+    db.execute("DELETE FROM todos WHERE id = 9");
+    EXPECT_NO_THROW(db.execute("INSERT INTO todos_fts(todos_fts) VALUES ('integrity-check')"));
+    EXPECT_EQ(queryInt(db, "SELECT COUNT(*) FROM todos_fts WHERE todos_fts MATCH 'original'"), 5);
+}
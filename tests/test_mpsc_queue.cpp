@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include "todolist/mpsc_queue.h"
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace todolist;
+
+class MpscQueueTest : public ::testing::Test {
+protected:
+    MpscQueue<int> queue;
+};
+
+TEST_F(MpscQueueTest, StartsEmpty) {
+    EXPECT_TRUE(queue.empty());
+    EXPECT_FALSE(queue.pop().has_value());
+}
+
+TEST_F(MpscQueueTest, PopsInFifoOrder) {
+    queue.push(1);
+    queue.push(2);
+    queue.push(3);
+
+    EXPECT_FALSE(queue.empty());
+    EXPECT_EQ(queue.pop(), 1);
+    EXPECT_EQ(queue.pop(), 2);
+    EXPECT_EQ(queue.pop(), 3);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(MpscQueueTest, HoldsMoveOnlyValues) {
+    MpscQueue<std::unique_ptr<int>> pointers;
+    pointers.push(std::make_unique<int>(7));
+    pointers.push(std::make_unique<int>(8));
+
+    auto first = pointers.pop();
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(**first, 7);
+    // The remaining element is freed by the destructor
+}
+
+TEST_F(MpscQueueTest, ConcurrentProducersKeepPerProducerOrder) {
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 10000;
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([this, p] {
+            for (int i = 0; i < kPerProducer; ++i) {
+                queue.push(p * kPerProducer + i);
+            }
+        });
+    }
+
+    std::vector<int> last(kProducers, -1);
+    int received = 0;
+    while (received < kProducers * kPerProducer) {
+        if (auto value = queue.pop()) {
+            int producer = *value / kPerProducer;
+            int sequence = *value % kPerProducer;
+            EXPECT_GT(sequence, last[producer]);
+            last[producer] = sequence;
+            ++received;
+        }
+    }
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    EXPECT_TRUE(queue.empty());
+}
@@ -0,0 +1,193 @@
+#include <gtest/gtest.h>
+#include "todolist/snapshot_file.h"
+#include "todolist/cli_handler.h"
+#include "todolist/database.h"
+#include "todolist/todo_repository.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+
+using namespace todolist;
+
+class SnapshotFileTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        db_path_ = (std::filesystem::temp_directory_path() / "todolist_snapshot_file_test.db").string();
+        removeFiles();
+        db_ = std::make_unique<Database>(db_path_);
+        repo_ = std::make_unique<TodoRepository>(*db_);
+    }
+
+    void TearDown() override {
+        repo_.reset();
+        db_.reset();
+        removeFiles();
+    }
+
+    void removeFiles() {
+        for (const char* suffix : {"", "-wal", "-shm", ".snapshot"}) {
+            std::filesystem::remove(db_path_ + suffix);
+        }
+    }
+
+    std::string snapshotPath() const { return SnapshotFile::pathFor(db_path_); }
+
+    /**
+     * @brief Add three items, the middle one completed, with distinct creation times
+     */
+    void seed() {
+        repo_->create(TodoItem(0, "Oldest", "first", false, TodoItem::fromUnixTime(100)));
+        repo_->create(TodoItem(0, "Middle", "", true, TodoItem::fromUnixTime(200)));
+        repo_->create(TodoItem(0, "Newest", "third", false, TodoItem::fromUnixTime(300)));
+    }
+
+    /**
+     * @brief Overwrite one byte of the snapshot file
+     */
+    void corrupt(std::streamoff offset) {
+        std::fstream file(snapshotPath(), std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(offset);
+        file.put('\x7f');
+    }
+
+    std::string db_path_;
+    std::unique_ptr<Database> db_;
+    std::unique_ptr<TodoRepository> repo_;
+};
+
+TEST_F(SnapshotFileTest, Crc32cKnownValue) {
+    const char* text = "123456789";
+    EXPECT_EQ(crc32c(text, 9), 0xE3069283u);
+    EXPECT_EQ(crc32c(text + 4, 5, crc32c(text, 4)), 0xE3069283u);
+    EXPECT_EQ(crc32c(text, 0), 0u);
+}
+
+TEST_F(SnapshotFileTest, RoundTripInListOrder) {
+    seed();
+    ASSERT_TRUE(SnapshotFile::refresh(db_path_, *db_, true));
+
+    auto snapshot = SnapshotFile::openCurrent(db_path_);
+    ASSERT_NE(snapshot, nullptr);
+    ASSERT_EQ(snapshot->size(), 3u);
+    EXPECT_EQ(snapshot->completedCount(), 1u);
+
+    TodoItemView newest = snapshot->view(0);
+    EXPECT_EQ(newest.getTitle(), "Newest");
+    EXPECT_EQ(newest.getDescription(), "third");
+    EXPECT_FALSE(newest.isCompleted());
+    EXPECT_EQ(newest.getCreatedAtUnix(), 300);
+
+    EXPECT_EQ(snapshot->view(1).getTitle(), "Middle");
+    EXPECT_TRUE(snapshot->view(1).isCompleted());
+    EXPECT_EQ(snapshot->view(2).getTitle(), "Oldest");
+}
+
+TEST_F(SnapshotFileTest, RefreshOnlyWhenStale) {
+    EXPECT_FALSE(SnapshotFile::refresh(db_path_, *db_, false));
+    EXPECT_FALSE(std::filesystem::exists(snapshotPath()));
+
+    seed();
+    ASSERT_TRUE(SnapshotFile::refresh(db_path_, *db_, true));
+    EXPECT_FALSE(SnapshotFile::refresh(db_path_, *db_, false));
+
+    repo_->create(TodoItem("Another", ""));
+    EXPECT_EQ(SnapshotFile::openCurrent(db_path_), nullptr);
+    ASSERT_NE(SnapshotFile::open(snapshotPath()), nullptr);
+
+    EXPECT_TRUE(SnapshotFile::refresh(db_path_, *db_, false));
+    auto snapshot = SnapshotFile::openCurrent(db_path_);
+    ASSERT_NE(snapshot, nullptr);
+    EXPECT_EQ(snapshot->size(), 4u);
+}
+
+TEST_F(SnapshotFileTest, ChangeCountCatchesCommitsTheFilesMiss) {
+    seed();
+    ASSERT_TRUE(SnapshotFile::refresh(db_path_, *db_, true));
+    std::uint64_t changes = SnapshotFile::open(snapshotPath())->stamp().changes;
+    EXPECT_EQ(changes, DatabaseStamp::readChanges(*db_));
+
+    // A commit the file fields do not show, as when WAL frames are reused
+    // within one mtime tick: stamp the old snapshot with the new file fields
+    ASSERT_TRUE(repo_->update(TodoItem(1, "Renamed", "", false, TodoItem::fromUnixTime(100))));
+    EXPECT_GT(DatabaseStamp::readChanges(*db_), changes);
+    DatabaseStamp stamp = DatabaseStamp::of(db_path_);
+    stamp.changes = changes;
+    {
+        std::fstream file(snapshotPath(), std::ios::binary | std::ios::in | std::ios::out);
+        std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        const size_t stamp_offset = 40;
+        const size_t checksum_offset = stamp_offset + sizeof(DatabaseStamp);
+        std::memcpy(&bytes[stamp_offset], &stamp, sizeof(stamp));
+        std::uint32_t checksum = crc32c(bytes.data(), checksum_offset);
+        checksum = crc32c(bytes.data() + checksum_offset + 8, bytes.size() - checksum_offset - 8, checksum);
+        std::memcpy(&bytes[checksum_offset], &checksum, sizeof(checksum));
+        file.seekp(0);
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+    ASSERT_NE(SnapshotFile::open(snapshotPath()), nullptr);
+
+    EXPECT_EQ(SnapshotFile::openCurrent(db_path_), nullptr);
+    EXPECT_TRUE(SnapshotFile::refresh(db_path_, *db_, false));
+    auto snapshot = SnapshotFile::openCurrent(db_path_);
+    ASSERT_NE(snapshot, nullptr);
+    EXPECT_EQ(snapshot->view(2).getTitle(), "Renamed");
+}
+
+TEST_F(SnapshotFileTest, ReadOnlyConnectionsKeepSnapshotCurrent) {
+    seed();
+    ASSERT_TRUE(SnapshotFile::refresh(db_path_, *db_, true));
+
+    // Closing the last connection must not rewrite the files
+    repo_.reset();
+    db_.reset();
+    {
+        Database reader(db_path_);
+        TodoRepository repository(reader);
+        EXPECT_EQ(repository.findAll().size(), 3u);
+    }
+    EXPECT_NE(SnapshotFile::openCurrent(db_path_), nullptr);
+}
+
+TEST_F(SnapshotFileTest, DamagedFilesAreRejected) {
+    seed();
+    ASSERT_TRUE(SnapshotFile::refresh(db_path_, *db_, true));
+    auto size = static_cast<std::streamoff>(std::filesystem::file_size(snapshotPath()));
+
+    corrupt(size - 1);
+    EXPECT_EQ(SnapshotFile::open(snapshotPath()), nullptr);
+
+    // list --snapshot falls back and replaces the damaged file
+    EXPECT_TRUE(SnapshotFile::refresh(db_path_, *db_, true));
+    ASSERT_NE(SnapshotFile::open(snapshotPath()), nullptr);
+
+    std::filesystem::resize_file(snapshotPath(), static_cast<std::uintmax_t>(size - 8));
+    EXPECT_EQ(SnapshotFile::open(snapshotPath()), nullptr);
+    EXPECT_EQ(SnapshotFile::open(snapshotPath() + ".missing"), nullptr);
+}
+
+TEST_F(SnapshotFileTest, CliOutputMatchesDatabaseList) {
+    seed();
+    ASSERT_TRUE(SnapshotFile::refresh(db_path_, *db_, true));
+    auto snapshot = SnapshotFile::openCurrent(db_path_);
+    ASSERT_NE(snapshot, nullptr);
+
+    CliHandler handler(*repo_, std::make_unique<Formatter>(false));
+    Formatter formatter(false);
+    for (const char* filter : {"all", "completed", "pending"}) {
+        std::ostringstream expected;
+        handler.streamList({filter}, {}, expected);
+
+        std::ostringstream actual;
+        ASSERT_TRUE(CliHandler::streamSnapshotList(*snapshot, {filter}, {}, formatter, actual));
+        EXPECT_EQ(actual.str(), expected.str()) << filter;
+    }
+
+    std::ostringstream unused;
+    EXPECT_FALSE(CliHandler::streamSnapshotList(*snapshot, {}, {{"limit", "2"}}, formatter, unused));
+    EXPECT_FALSE(CliHandler::streamSnapshotList(*snapshot, {"bogus"}, {}, formatter, unused));
+    EXPECT_TRUE(unused.str().empty());
+}
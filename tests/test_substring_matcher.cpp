@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include "todolist/substring_matcher.h"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace todolist;
+
+class SubstringMatcherTest : public ::testing::Test {
+protected:
+    /**
+     * @brief Pack strings into an arena with offsets
+     */
+    void pack(const std::vector<std::string>& rows) {
+        arena_.clear();
+        offsets_.assign(1, 0);
+        for (const auto& row : rows) {
+            arena_ += row;
+            offsets_.push_back(arena_.size());
+        }
+        rows_ = rows;
+    }
+
+    std::vector<std::uint32_t> find(const std::string& needle, SimdLevel level) const {
+        std::vector<std::uint32_t> out;
+        SubstringMatcher(needle, level).findRows(arena_.data(), offsets_.data(), rows_.size(), out);
+        return out;
+    }
+
+    /**
+     * @brief Reference result: lowercase everything and use std::string::find
+     */
+    std::vector<std::uint32_t> expected(const std::string& needle) const {
+        auto lower = [](std::string text) {
+            std::transform(text.begin(), text.end(), text.begin(), [](char c) {
+                return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+            });
+            return text;
+        };
+        std::vector<std::uint32_t> out;
+        for (size_t i = 0; i < rows_.size(); ++i) {
+            if (lower(rows_[i]).find(lower(needle)) != std::string::npos) {
+                out.push_back(static_cast<std::uint32_t>(i));
+            }
+        }
+        return out;
+    }
+
+    static std::vector<SimdLevel> levels() {
+        return {SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::AVX2};
+    }
+
+    std::string arena_;
+    std::vector<size_t> offsets_;
+    std::vector<std::string> rows_;
+};
+
+TEST_F(SubstringMatcherTest, MatchesSingleStrings) {
+    for (SimdLevel level : levels()) {
+        SubstringMatcher matcher("Rocer", level);
+        EXPECT_TRUE(matcher.matches("Buy groceries"));
+        EXPECT_TRUE(matcher.matches("GROCERIES"));
+        EXPECT_FALSE(matcher.matches("Buy groce"));
+        EXPECT_FALSE(matcher.matches("roc"));
+        EXPECT_FALSE(matcher.matches(""));
+        EXPECT_TRUE(SubstringMatcher("", level).matches(""));
+    }
+}
+
+TEST_F(SubstringMatcherTest, LevelIsClampedToCpu) {
+    SubstringMatcher matcher("x", SimdLevel::AVX2);
+    EXPECT_LE(static_cast<int>(matcher.level()), static_cast<int>(detectSimdLevel()));
+    EXPECT_EQ(SubstringMatcher("x", SimdLevel::SCALAR).level(), SimdLevel::SCALAR);
+}
+
+TEST_F(SubstringMatcherTest, MatchesDoNotSpanRows) {
+    pack({"abc", "def", "", "xabcdefx", "ABC"});
+
+    for (SimdLevel level : levels()) {
+        EXPECT_EQ(find("cd", level), (std::vector<std::uint32_t>{3}));
+        EXPECT_EQ(find("abc", level), (std::vector<std::uint32_t>{0, 3, 4}));
+        EXPECT_EQ(find("", level), (std::vector<std::uint32_t>{0, 1, 2, 3, 4}));
+    }
+}
+
+TEST_F(SubstringMatcherTest, OnlyAsciiLettersFoldCase) {
+    // 0xC3 0x89 is "É" in UTF-8; '@' and '[' sit just outside 'A'..'Z'
+    pack({"caf\xC3\xA9", "CAF\xC3\x89", "[@]", "{`}"});
+
+    for (SimdLevel level : levels()) {
+        EXPECT_EQ(find("caf\xC3\xA9", level), (std::vector<std::uint32_t>{0}));
+        EXPECT_EQ(find("CAF", level), (std::vector<std::uint32_t>{0, 1}));
+        EXPECT_EQ(find("[@", level), (std::vector<std::uint32_t>{2}));
+        EXPECT_EQ(find("{`", level), (std::vector<std::uint32_t>{3}));
+    }
+}
+
+TEST_F(SubstringMatcherTest, AgreesWithReferenceOnRandomRows) {
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> length(0, 70);
+    const std::string alphabet = "abAB c-";
+
+    std::vector<std::string> rows;
+    for (int i = 0; i < 2000; ++i) {
+        std::string row;
+        int size = length(random);
+        for (int j = 0; j < size; ++j) {
+            row += alphabet[random() % alphabet.size()];
+        }
+        rows.push_back(row);
+    }
+    pack(rows);
+
+    for (const char* needle : {"a", "Ab", "b-a", "abba", "aBcAb", "a b a b", "bbbbbbbbbbbbbbbbbbbb"}) {
+        std::vector<std::uint32_t> reference = expected(needle);
+        for (SimdLevel level : levels()) {
+            EXPECT_EQ(find(needle, level), reference) << needle << " " << simdLevelName(level);
+        }
+    }
+}
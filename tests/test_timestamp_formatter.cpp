@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+#include "todolist/timestamp_formatter.h"
+#include "todolist/todo_item.h"
+#include <cstdlib>
+#include <ctime>
+#include <string>
+#include <vector>
+
+using namespace todolist;
+
+class TimestampFormatterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        const char* tz = std::getenv("TZ");
+        had_tz_ = tz != nullptr;
+        if (had_tz_) {
+            saved_tz_ = tz;
+        }
+    }
+
+    void TearDown() override {
+        if (had_tz_) {
+            setenv("TZ", saved_tz_.c_str(), 1);
+        } else {
+            unsetenv("TZ");
+        }
+        tzset();
+    }
+
+    void useZone(const char* tz) {
+        setenv("TZ", tz, 1);
+        tzset();
+    }
+
+    /**
+     * @brief Reference result: localtime_r and strftime
+     */
+    static std::string expected(std::time_t unix_time) {
+        std::tm tm_time;
+        localtime_r(&unix_time, &tm_time);
+        char buffer[64];
+        return std::string(buffer, std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &tm_time));
+    }
+
+    static std::string format(TimestampFormatter& formatter, std::time_t unix_time) {
+        char buffer[TimestampFormatter::kBufferSize];
+        return std::string(buffer, formatter.format(unix_time, buffer));
+    }
+
+    bool had_tz_ = false;
+    std::string saved_tz_;
+};
+
+TEST_F(TimestampFormatterTest, FormatsUtc) {
+    useZone("UTC0");
+    TimestampFormatter formatter;
+
+    EXPECT_EQ(format(formatter, 0), "1970-01-01 00:00:00");
+    EXPECT_EQ(format(formatter, 1704067199), "2023-12-31 23:59:59");
+    EXPECT_EQ(format(formatter, 1704067200), "2024-01-01 00:00:00");
+    EXPECT_EQ(format(formatter, 1709164800), "2024-02-29 00:00:00");
+    EXPECT_EQ(format(formatter, 951868799), "2000-02-29 23:59:59");
+    EXPECT_EQ(format(formatter, -1), "1969-12-31 23:59:59");
+    EXPECT_EQ(format(formatter, -62135596800), "1-01-01 00:00:00");
+    EXPECT_EQ(format(formatter, 253402300800), "10000-01-01 00:00:00");
+}
+
+TEST_F(TimestampFormatterTest, MatchesStrftimeAcrossTransitions) {
+    // POSIX rules, so the test does not depend on installed zone files
+    const char* zones[] = {
+        "EST5EDT,M3.2.0,M11.1.0",
+        "CET-1CEST,M3.5.0,M10.5.0/3",
+        "<+0530>-5:30",
+        "<+1030>-10:30<+11>-11,M10.1.0,M4.1.0",
+        "<-03>3<-02>,M3.5.0/-2,M10.5.0/-1",
+    };
+
+    for (const char* zone : zones) {
+        useZone(zone);
+        TimestampFormatter formatter;
+
+        // Irregular steps, so every hour and many minutes around each
+        // transition of a few years are covered
+        for (std::time_t t = 1672531200 - 86400; t < 1767225600; t += 1201) {
+            ASSERT_EQ(format(formatter, t), expected(t)) << zone << " at " << t;
+        }
+        for (std::time_t t = -86400 * 400; t < 86400 * 400; t += 86399) {
+            ASSERT_EQ(format(formatter, t), expected(t)) << zone << " at " << t;
+        }
+    }
+}
+
+TEST_F(TimestampFormatterTest, FormatsTheSecondsAroundATransition) {
+    useZone("EST5EDT,M3.2.0,M11.1.0");
+    TimestampFormatter formatter;
+
+    // 2024-03-10 02:00 EST and 2024-11-03 02:00 EDT
+    for (std::time_t transition : {std::time_t{1710054000}, std::time_t{1730613600}}) {
+        for (std::time_t t = transition - 3; t <= transition + 3; ++t) {
+            EXPECT_EQ(format(formatter, t), expected(t));
+        }
+    }
+    EXPECT_EQ(format(formatter, 1710053999), "2024-03-10 01:59:59");
+    EXPECT_EQ(format(formatter, 1710054000), "2024-03-10 03:00:00");
+}
+
+TEST_F(TimestampFormatterTest, BatchMatchesSingleCalls) {
+    useZone("CET-1CEST,M3.5.0,M10.5.0/3");
+    TimestampFormatter formatter;
+
+    std::vector<std::time_t> times;
+    for (std::time_t t = 1711846800 + 7200; t > 1711846800 - 7200; t -= 599) {
+        times.push_back(t);
+    }
+    times.push_back(0);
+    times.push_back(1700000000);
+
+    std::vector<TimestampFormatter::Text> out(times.size());
+    formatter.formatBatch(times.data(), times.size(), out.data());
+    for (size_t i = 0; i < times.size(); ++i) {
+        EXPECT_EQ(std::string(out[i].view()), expected(times[i]));
+    }
+}
+
+TEST_F(TimestampFormatterTest, TodoItemUsesTheLocalZone) {
+    useZone("<+0530>-5:30");
+    TimestampFormatter::forThread() = TimestampFormatter();
+
+    TodoItem item(1, "Test", "", false, TodoItem::fromUnixTime(1704067200));
+    EXPECT_EQ(item.getFormattedCreatedAt(), "2024-01-01 05:30:00");
+
+    useZone("UTC0");
+    TimestampFormatter::forThread() = TimestampFormatter();
+}
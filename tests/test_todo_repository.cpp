@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include "todolist/todo_repository.h"
 #include "todolist/database.h"
+#include "todolist/exceptions.h"
+#include <filesystem>
 
 using namespace todolist;
 
@@ -185,6 +187,35 @@ TEST_F(TodoRepositoryTest, RemoveNonExistent) {
     EXPECT_FALSE(removed);
 }
 
+TEST_F(TodoRepositoryTest, MarkCompleted) {
+    auto item = repo_->create(TodoItem("Task", "Desc"));
+
+    CompleteResult result = repo_->markCompleted(item.getId());
+    EXPECT_EQ(result.status, CompleteStatus::COMPLETED);
+    ASSERT_TRUE(result.item.has_value());
+    EXPECT_TRUE(result.item->isCompleted());
+    EXPECT_EQ(result.item->getTitle(), "Task");
+    EXPECT_TRUE(repo_->findById(item.getId())->isCompleted());
+
+    result = repo_->markCompleted(item.getId());
+    EXPECT_EQ(result.status, CompleteStatus::ALREADY_COMPLETED);
+    EXPECT_FALSE(result.item.has_value());
+
+    EXPECT_EQ(repo_->markCompleted(9999).status, CompleteStatus::NOT_FOUND);
+}
+
+TEST_F(TodoRepositoryTest, RemoveReturning) {
+    auto item = repo_->create(TodoItem("Task", "Desc"));
+
+    auto removed = repo_->removeReturning(item.getId());
+    ASSERT_TRUE(removed.has_value());
+    EXPECT_EQ(removed->getId(), item.getId());
+    EXPECT_EQ(removed->getDescription(), "Desc");
+    EXPECT_FALSE(repo_->findById(item.getId()).has_value());
+
+    EXPECT_FALSE(repo_->removeReturning(item.getId()).has_value());
+}
+
 TEST_F(TodoRepositoryTest, Count) {
     EXPECT_EQ(repo_->count(), 0);
 
@@ -223,6 +254,29 @@ TEST_F(TodoRepositoryTest, CountPending) {
     EXPECT_EQ(repo_->countPending(), 2);
 }
 
+TEST_F(TodoRepositoryTest, StatsFollowEveryWritePath) {
+    auto item = repo_->create(TodoItem("Task 1", ""));
+    repo_->createBatch({TodoItem("Task 2", ""), TodoItem("Task 3", ""), TodoItem("Task 4", "")});
+
+    item.setCompleted(true);
+    repo_->update(item);
+    // Updating other fields must not count the item twice
+    item.setTitle("Task 1 renamed");
+    repo_->update(item);
+    repo_->completeRange({item.getId() + 1, item.getId() + 2});
+
+    TodoStats stats = repo_->stats();
+    EXPECT_EQ(stats.total, 4);
+    EXPECT_EQ(stats.completed, 3);
+    EXPECT_EQ(stats.pending, 1);
+
+    repo_->removeMatching(BulkFilter{true, std::nullopt}, 10);
+    stats = repo_->stats();
+    EXPECT_EQ(stats.total, 1);
+    EXPECT_EQ(stats.completed, 0);
+    EXPECT_EQ(stats.pending, 1);
+}
+
 TEST_F(TodoRepositoryTest, MultipleCreatesAndReads) {
     // Create many items
     for (int i = 0; i < 100; ++i) {
@@ -243,3 +297,423 @@ TEST_F(TodoRepositoryTest, EmptyDescription) {
     ASSERT_TRUE(found.has_value());
     EXPECT_EQ(found->getDescription(), "");
 }
+
+TEST_F(TodoRepositoryTest, RepeatedQueriesReuseStatements) {
+    auto created = repo_->create(TodoItem("Task", "Desc"));
+    repo_->findById(created.getId());
+    size_t cached = db_->cachedStatementCount();
+
+    for (int i = 0; i < 10; ++i) {
+        repo_->create(TodoItem("Task " + std::to_string(i), ""));
+        auto found = repo_->findById(created.getId());
+        ASSERT_TRUE(found.has_value());
+        EXPECT_EQ(found->getTitle(), "Task");
+    }
+
+    EXPECT_EQ(db_->cachedStatementCount(), cached);
+}
+
+TEST_F(TodoRepositoryTest, CreateBatch) {
+    std::vector<TodoItem> items;
+    for (int i = 0; i < 50; ++i) {
+        items.emplace_back("Task " + std::to_string(i), "Description " + std::to_string(i));
+    }
+
+    auto ids = repo_->createBatch(items);
+
+    ASSERT_EQ(ids.size(), 50);
+    EXPECT_EQ(repo_->count(), 50);
+    for (size_t i = 0; i < ids.size(); ++i) {
+        auto found = repo_->findById(ids[i]);
+        ASSERT_TRUE(found.has_value());
+        EXPECT_EQ(found->getTitle(), "Task " + std::to_string(i));
+    }
+}
+
+TEST_F(TodoRepositoryTest, CreateBatchEmpty) {
+    auto ids = repo_->createBatch({});
+
+    EXPECT_TRUE(ids.empty());
+    EXPECT_EQ(repo_->count(), 0);
+}
+
+TEST_F(TodoRepositoryTest, CreateBatchJoinsOpenTransaction) {
+    {
+        Transaction transaction(*db_);
+        repo_->createBatch({TodoItem("Task 1", ""), TodoItem("Task 2", "")});
+        // Not committed
+    }
+
+    EXPECT_EQ(repo_->count(), 0);
+}
+
+TEST_F(TodoRepositoryTest, FailedCreateBatchKeepsCallerTransaction) {
+    db_->execute("CREATE TRIGGER reject_bad BEFORE INSERT ON todos WHEN new.title = 'bad' "
+                 "BEGIN SELECT RAISE(ABORT, 'rejected'); END");
+
+    Transaction transaction(*db_);
+    repo_->create(TodoItem("Kept", ""));
+    EXPECT_THROW(repo_->createBatch({TodoItem("Undone", ""), TodoItem("bad", "")}), DatabaseException);
+    EXPECT_TRUE(transaction.isActive());
+    transaction.commit();
+
+    auto items = repo_->findAll();
+    ASSERT_EQ(items.size(), 1);
+    EXPECT_EQ(items[0].getTitle(), "Kept");
+}
+
+TEST_F(TodoRepositoryTest, NextIdChunk) {
+    for (int i = 0; i < 10; ++i) {
+        repo_->create(TodoItem("Task " + std::to_string(i), ""));
+    }
+    repo_->remove(3);
+
+    auto chunk = repo_->nextIdChunk({2, 100}, 3);
+    ASSERT_TRUE(chunk.has_value());
+    EXPECT_EQ(chunk->first, 2);
+    EXPECT_EQ(chunk->last, 5);
+
+    EXPECT_FALSE(repo_->nextIdChunk({50, 100}, 3).has_value());
+}
+
+TEST_F(TodoRepositoryTest, CompleteRange) {
+    for (int i = 0; i < 10; ++i) {
+        repo_->create(TodoItem("Task " + std::to_string(i), ""));
+    }
+    auto already = *repo_->findById(4);
+    already.setCompleted(true);
+    repo_->update(already);
+
+    EXPECT_EQ(repo_->completeRange({3, 7}), 4);
+    EXPECT_EQ(repo_->countCompleted(), 5);
+    EXPECT_FALSE(repo_->findById(8)->isCompleted());
+}
+
+TEST_F(TodoRepositoryTest, RemoveRange) {
+    for (int i = 0; i < 10; ++i) {
+        repo_->create(TodoItem("Task " + std::to_string(i), ""));
+    }
+
+    EXPECT_EQ(repo_->removeRange({3, 7}), 5);
+    EXPECT_EQ(repo_->count(), 5);
+    EXPECT_FALSE(repo_->findById(5).has_value());
+}
+
+TEST_F(TodoRepositoryTest, RemoveMatchingInBatches) {
+    auto old_time = TodoItem::fromUnixTime(1000000000);
+    for (int i = 0; i < 10; ++i) {
+        repo_->create(TodoItem(0, "Old " + std::to_string(i), "", i % 2 == 0, old_time));
+    }
+    auto recent = TodoItem("Recent", "");
+    recent.setCompleted(true);
+    repo_->create(recent);
+
+    BulkFilter filter;
+    filter.completed = true;
+    filter.created_before = 1500000000;
+
+    EXPECT_EQ(repo_->removeMatching(filter, 3), 3);
+    EXPECT_EQ(repo_->removeMatching(filter, 3), 2);
+    EXPECT_EQ(repo_->removeMatching(filter, 3), 0);
+    EXPECT_EQ(repo_->count(), 6);
+    EXPECT_EQ(repo_->countCompleted(), 1);
+}
+
+TEST_F(TodoRepositoryTest, ForEachStreamsFilteredRows) {
+    auto item1 = repo_->create(TodoItem("Task 1", "Desc 1"));
+    repo_->create(TodoItem("Task 2", "Desc 2"));
+    item1.setCompleted(true);
+    repo_->update(item1);
+
+    std::vector<std::string> titles;
+    repo_->forEach(TodoFilter::PENDING, [&titles](const TodoItem& item) {
+        titles.push_back(item.getTitle());
+    });
+
+    ASSERT_EQ(titles.size(), 1);
+    EXPECT_EQ(titles[0], "Task 2");
+
+    int visited = 0;
+    repo_->forEach(TodoFilter::ALL, [&visited](const TodoItem&) { ++visited; });
+    EXPECT_EQ(visited, 2);
+}
+
+TEST_F(TodoRepositoryTest, ForEachVisitorExceptionReleasesStatement) {
+    repo_->create(TodoItem("Task 1", ""));
+    repo_->create(TodoItem("Task 2", ""));
+
+    EXPECT_THROW(repo_->forEach(TodoFilter::ALL, [](const TodoItem&) {
+        throw std::runtime_error("stop");
+    }), std::runtime_error);
+
+    EXPECT_EQ(repo_->findAll().size(), 2);
+}
+
+TEST_F(TodoRepositoryTest, ForEachViewMatchesFindAll) {
+    auto item1 = repo_->create(TodoItem("Task 1", "Desc 1"));
+    repo_->create(TodoItem("Task 2", ""));
+    item1.setCompleted(true);
+    repo_->update(item1);
+
+    std::vector<TodoItem> viewed;
+    repo_->forEachView(TodoFilter::ALL, [&viewed](const TodoItemView& view) {
+        viewed.push_back(view.toItem());
+    });
+
+    auto all = repo_->findAll();
+    ASSERT_EQ(viewed.size(), all.size());
+    for (size_t i = 0; i < all.size(); ++i) {
+        EXPECT_EQ(viewed[i].getId(), all[i].getId());
+        EXPECT_EQ(viewed[i].getTitle(), all[i].getTitle());
+        EXPECT_EQ(viewed[i].getDescription(), all[i].getDescription());
+        EXPECT_EQ(viewed[i].isCompleted(), all[i].isCompleted());
+        EXPECT_EQ(viewed[i].getCreatedAtUnix(), all[i].getCreatedAtUnix());
+    }
+}
+
+TEST_F(TodoRepositoryTest, SearchViewsMatchOwningVariants) {
+    repo_->create(TodoItem("Buy groceries", "Milk and eggs"));
+    repo_->create(TodoItem("Buy books", ""));
+    repo_->create(TodoItem("Clean house", "Eggs on the floor"));
+
+    std::vector<int> ids;
+    repo_->forEachViewByTitle("buy", [&ids](const TodoItemView& view) { ids.push_back(view.getId()); });
+    std::vector<int> expected;
+    repo_->forEachByTitle("buy", [&expected](const TodoItem& item) { expected.push_back(item.getId()); });
+    EXPECT_EQ(ids.size(), 2);
+    EXPECT_EQ(ids, expected);
+
+    ids.clear();
+    expected.clear();
+    repo_->forEachSearchResultView("eggs", [&ids](const TodoItemView& view) { ids.push_back(view.getId()); });
+    repo_->forEachSearchResult("eggs", [&expected](const TodoItem& item) { expected.push_back(item.getId()); });
+    EXPECT_EQ(ids.size(), 2);
+    EXPECT_EQ(ids, expected);
+}
+
+TEST_F(TodoRepositoryTest, StatsByTitle) {
+    auto item = repo_->create(TodoItem("Buy groceries", ""));
+    repo_->create(TodoItem("Buy books", ""));
+    repo_->create(TodoItem("Clean house", ""));
+    item.setCompleted(true);
+    repo_->update(item);
+
+    TodoStats stats = repo_->statsByTitle("buy");
+
+    EXPECT_EQ(stats.total, 2);
+    EXPECT_EQ(stats.completed, 1);
+    EXPECT_EQ(stats.pending, 1);
+}
+
+TEST_F(TodoRepositoryTest, FindPageWalksAllItemsInOrder) {
+    // Several items share a timestamp so the id tie-breaker is exercised
+    for (int i = 0; i < 7; ++i) {
+        repo_->create(TodoItem(0, "Task " + std::to_string(i), "", false,
+                               TodoItem::fromUnixTime(1000000000 + i / 3)));
+    }
+
+    std::vector<int> ids;
+    std::optional<std::string> cursor;
+    int pages = 0;
+    do {
+        TodoPage page = repo_->findPage(TodoFilter::ALL, 3, cursor);
+        for (const auto& item : page.items) {
+            ids.push_back(item.getId());
+        }
+        cursor = page.next_cursor;
+        ++pages;
+    } while (cursor);
+
+    EXPECT_EQ(pages, 3);
+    EXPECT_EQ(ids, (std::vector<int>{7, 6, 5, 4, 3, 2, 1}));
+}
+
+TEST_F(TodoRepositoryTest, FindPageFiltersAndEndsWithoutCursor) {
+    auto item = repo_->create(TodoItem("Done", ""));
+    repo_->create(TodoItem("Pending", ""));
+    item.setCompleted(true);
+    repo_->update(item);
+
+    TodoPage page = repo_->findPage(TodoFilter::COMPLETED, 5);
+
+    ASSERT_EQ(page.items.size(), 1);
+    EXPECT_EQ(page.items[0].getTitle(), "Done");
+    EXPECT_FALSE(page.next_cursor.has_value());
+}
+
+TEST_F(TodoRepositoryTest, FindPageByTitle) {
+    for (int i = 0; i < 5; ++i) {
+        repo_->create(TodoItem("Buy item " + std::to_string(i), ""));
+        repo_->create(TodoItem("Sell item " + std::to_string(i), ""));
+    }
+
+    TodoPage first = repo_->findPageByTitle("buy", 3);
+    ASSERT_EQ(first.items.size(), 3);
+    ASSERT_TRUE(first.next_cursor.has_value());
+
+    TodoPage second = repo_->findPageByTitle("buy", 3, first.next_cursor);
+    ASSERT_EQ(second.items.size(), 2);
+    EXPECT_FALSE(second.next_cursor.has_value());
+    EXPECT_EQ(second.items[1].getTitle(), "Buy item 0");
+}
+
+TEST_F(TodoRepositoryTest, FindPageInvalidArguments) {
+    EXPECT_THROW(repo_->findPage(TodoFilter::ALL, 0), ValidationException);
+    EXPECT_THROW(repo_->findPage(TodoFilter::ALL, 10, std::string("not-a-cursor")), ValidationException);
+    EXPECT_THROW(repo_->findPage(TodoFilter::ALL, 10, std::string("12")), ValidationException);
+    EXPECT_THROW(repo_->findPage(TodoFilter::ALL, 10, std::string("1-ffffffff")), ValidationException);
+    EXPECT_THROW(repo_->findPage(TodoFilter::ALL, 10, std::string("1-80000000")), ValidationException);
+}
+
+TEST_F(TodoRepositoryTest, SearchMatchesWordsAndPrefixes) {
+    repo_->create(TodoItem("Buy groceries", "Milk and eggs"));
+    repo_->create(TodoItem("Call plumber", "Kitchen sink leaks, buy new washer"));
+    repo_->create(TodoItem("Clean house", "Living room"));
+
+    auto results = repo_->search("buy");
+    ASSERT_EQ(results.size(), 2);
+    // Title matches rank above description matches
+    EXPECT_EQ(results[0].getTitle(), "Buy groceries");
+
+    EXPECT_EQ(repo_->search("groc").size(), 1);
+    EXPECT_EQ(repo_->search("buy milk").size(), 1);
+    EXPECT_TRUE(repo_->search("rocer").empty());
+}
+
+TEST_F(TodoRepositoryTest, SearchTreatsOperatorsLiterally) {
+    repo_->create(TodoItem("Fix \"quoted\" bug", ""));
+    repo_->create(TodoItem("Review C++ code", ""));
+
+    EXPECT_EQ(repo_->search("\"quoted\"").size(), 1);
+    EXPECT_EQ(repo_->search("C++").size(), 1);
+    EXPECT_TRUE(repo_->search("NOT OR AND").empty());
+}
+
+TEST_F(TodoRepositoryTest, SearchIndexFollowsUpdatesAndDeletes) {
+    auto item = repo_->create(TodoItem("Original title", ""));
+    item.setTitle("Renamed task");
+    repo_->update(item);
+
+    EXPECT_TRUE(repo_->search("original").empty());
+    EXPECT_EQ(repo_->search("renamed").size(), 1);
+
+    repo_->remove(item.getId());
+    EXPECT_TRUE(repo_->search("renamed").empty());
+}
+
+TEST_F(TodoRepositoryTest, SearchStatsAndPage) {
+    for (int i = 0; i < 5; ++i) {
+        auto item = repo_->create(TodoItem("Report " + std::to_string(i), ""));
+        if (i < 2) {
+            item.setCompleted(true);
+            repo_->update(item);
+        }
+    }
+
+    TodoStats stats = repo_->searchStats("report");
+    EXPECT_EQ(stats.total, 5);
+    EXPECT_EQ(stats.completed, 2);
+
+    TodoPage page = repo_->searchPage("report", 4);
+    EXPECT_EQ(page.items.size(), 4);
+    ASSERT_TRUE(page.next_cursor.has_value());
+    EXPECT_EQ(repo_->searchPage("report", 4, page.next_cursor).items.size(), 1);
+}
+
+TEST_F(TodoRepositoryTest, FindByTitleMatchesInsideWords) {
+    repo_->create(TodoItem("Buy groceries", ""));
+    repo_->create(TodoItem("GROCERY run", ""));
+    repo_->create(TodoItem("Clean house", ""));
+
+    EXPECT_EQ(repo_->findByTitle("rocer").size(), 2);
+    EXPECT_EQ(repo_->statsByTitle("rocer").total, 2);
+    EXPECT_EQ(repo_->findPageByTitle("rocer", 1).items.size(), 1);
+    // Short queries fall back to a scan and behave the same way
+    EXPECT_EQ(repo_->findByTitle("ro").size(), 2);
+}
+
+TEST_F(TodoRepositoryTest, FindByTitleIndexFollowsUpdatesAndDeletes) {
+    auto item = repo_->create(TodoItem("Original title", ""));
+    item.setTitle("Renamed task");
+    repo_->update(item);
+
+    EXPECT_TRUE(repo_->findByTitle("rigin").empty());
+    EXPECT_EQ(repo_->findByTitle("ename").size(), 1);
+
+    repo_->remove(item.getId());
+    EXPECT_TRUE(repo_->findByTitle("ename").empty());
+}
+
+TEST_F(TodoRepositoryTest, CachedFindByIdCountsHitsAndMisses) {
+    TodoRepository cached(*db_, 8);
+    auto item = cached.create(TodoItem("Cached task", ""));
+
+    cached.findById(item.getId());
+    auto found = cached.findById(item.getId());
+
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(found->getTitle(), "Cached task");
+    CacheStats stats = cached.cacheStats();
+    EXPECT_EQ(stats.misses, 1u);
+    EXPECT_EQ(stats.hits, 1u);
+    EXPECT_EQ(stats.size, 1u);
+    EXPECT_EQ(repo_->cacheStats().capacity, 0u);
+}
+
+TEST_F(TodoRepositoryTest, CachedFindByIdFollowsOwnWrites) {
+    TodoRepository cached(*db_, 8);
+    auto item = cached.create(TodoItem("Original", ""));
+    cached.findById(item.getId());
+
+    item.setTitle("Renamed");
+    cached.update(item);
+    EXPECT_EQ(cached.findById(item.getId())->getTitle(), "Renamed");
+
+    cached.completeRange({item.getId(), item.getId()});
+    EXPECT_TRUE(cached.findById(item.getId())->isCompleted());
+
+    cached.remove(item.getId());
+    EXPECT_FALSE(cached.findById(item.getId()).has_value());
+}
+
+TEST_F(TodoRepositoryTest, CachedFindByIdSeesWritesOnSameConnection) {
+    TodoRepository cached(*db_, 8);
+    auto item = cached.create(TodoItem("Original", ""));
+    cached.findById(item.getId());
+
+    // Another repository sharing the connection
+    item.setTitle("Changed elsewhere");
+    repo_->update(item);
+    EXPECT_EQ(cached.findById(item.getId())->getTitle(), "Changed elsewhere");
+}
+
+TEST_F(TodoRepositoryTest, CachedFindByIdSeesWritesFromOtherConnections) {
+    std::string path = (std::filesystem::temp_directory_path() / "todolist_cache_coherence.db").string();
+    std::filesystem::remove(path);
+    {
+        Database reader_db(path);
+        Database writer_db(path);
+        TodoRepository cached(reader_db, 8);
+        TodoRepository writer(writer_db);
+
+        auto item = writer.create(TodoItem("Original", ""));
+        cached.findById(item.getId());
+
+        item.setTitle("Changed by another process");
+        writer.update(item);
+        EXPECT_EQ(cached.findById(item.getId())->getTitle(), "Changed by another process");
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_F(TodoRepositoryTest, CachedFindByIdSkipsOpenTransactions) {
+    TodoRepository cached(*db_, 8);
+    auto item = cached.create(TodoItem("Original", ""));
+
+    db_->execute("BEGIN");
+    db_->execute("UPDATE todos SET title = 'Uncommitted' WHERE id = " + std::to_string(item.getId()));
+    EXPECT_EQ(cached.findById(item.getId())->getTitle(), "Uncommitted");
+    db_->execute("ROLLBACK");
+
+    EXPECT_EQ(cached.findById(item.getId())->getTitle(), "Original");
+}
@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include "todolist/todo_snapshot.h"
+#include "todolist/todo_repository.h"
+#include "todolist/database.h"
+#include <string>
+
+using namespace todolist;
+
+class TodoSnapshotTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        db_ = std::make_unique<Database>(":memory:");
+        repo_ = std::make_unique<TodoRepository>(*db_);
+    }
+
+    void TearDown() override {
+        repo_.reset();
+        db_.reset();
+    }
+
+    /**
+     * @brief Create an item with a given status and Unix creation time
+     */
+    int createItem(const std::string& title, bool completed, std::time_t created_at,
+                   const std::string& description = "") {
+        TodoItem item(0, title, description, completed, TodoItem::fromUnixTime(created_at));
+        return repo_->create(item).getId();
+    }
+
+    std::unique_ptr<Database> db_;
+    std::unique_ptr<TodoRepository> repo_;
+};
+
+TEST_F(TodoSnapshotTest, EmptyTable) {
+    TodoSnapshot snapshot(*db_);
+
+    EXPECT_TRUE(snapshot.empty());
+    EXPECT_EQ(snapshot.count(TodoFilter::ALL), 0u);
+    EXPECT_EQ(snapshot.count(TodoFilter::PENDING), 0u);
+    EXPECT_TRUE(snapshot.filter(TodoFilter::PENDING).empty());
+}
+
+TEST_F(TodoSnapshotTest, ColumnsMatchRows) {
+    int first = createItem("Buy milk", false, 100, "Two litres");
+    int second = createItem("Call mom", true, 200);
+
+    TodoSnapshot snapshot(*db_);
+
+    ASSERT_EQ(snapshot.size(), 2u);
+    EXPECT_EQ(snapshot.id(0), first);
+    EXPECT_EQ(snapshot.title(0), "Buy milk");
+    EXPECT_EQ(snapshot.description(0), "Two litres");
+    EXPECT_FALSE(snapshot.isCompleted(0));
+    EXPECT_EQ(snapshot.createdAt(0), 100);
+
+    EXPECT_EQ(snapshot.id(1), second);
+    EXPECT_EQ(snapshot.title(1), "Call mom");
+    EXPECT_EQ(snapshot.description(1), "");
+    EXPECT_TRUE(snapshot.isCompleted(1));
+
+    TodoItem item = snapshot.item(1);
+    EXPECT_EQ(item.getId(), second);
+    EXPECT_EQ(item.getTitle(), "Call mom");
+    EXPECT_TRUE(item.isCompleted());
+    EXPECT_EQ(item.getCreatedAtUnix(), 200);
+
+    TodoItemView view = snapshot.view(1);
+    EXPECT_EQ(view.getId(), second);
+    EXPECT_EQ(view.getTitle(), "Call mom");
+    EXPECT_EQ(view.getTitle().data(), snapshot.title(1).data());
+    EXPECT_TRUE(view.isCompleted());
+    EXPECT_EQ(view.getCreatedAtUnix(), 200);
+
+    TodoSnapshot::Row row = 0;
+    ASSERT_TRUE(snapshot.findRow(second, row));
+    EXPECT_EQ(row, 1u);
+    EXPECT_FALSE(snapshot.findRow(second + 1, row));
+}
+
+TEST_F(TodoSnapshotTest, CountsAcrossWordBoundaries) {
+    // 130 rows span three bitset words, the last one partly used
+    size_t completed = 0;
+    for (int i = 0; i < 130; ++i) {
+        bool done = i % 3 == 0;
+        completed += done;
+        createItem("Task " + std::to_string(i), done, i);
+    }
+
+    TodoSnapshot snapshot(*db_);
+
+    EXPECT_EQ(snapshot.count(TodoFilter::ALL), 130u);
+    EXPECT_EQ(snapshot.count(TodoFilter::COMPLETED), completed);
+    EXPECT_EQ(snapshot.count(TodoFilter::PENDING), 130u - completed);
+
+    TodoSnapshot::Rows pending = snapshot.filter(TodoFilter::PENDING);
+    ASSERT_EQ(pending.size(), 130u - completed);
+    for (TodoSnapshot::Row row : pending) {
+        EXPECT_FALSE(snapshot.isCompleted(row));
+    }
+    EXPECT_EQ(pending.back(), 128u);
+
+    TodoStats stats = repo_->stats();
+    EXPECT_EQ(snapshot.count(TodoFilter::COMPLETED), static_cast<size_t>(stats.completed));
+}
+
+TEST_F(TodoSnapshotTest, FilterByTitleIgnoresCase) {
+    createItem("Buy MILK", false, 1);
+    createItem("Buy bread", false, 2);
+    createItem("Milkshake", true, 3);
+
+    TodoSnapshot snapshot(*db_);
+
+    TodoSnapshot::Rows rows = snapshot.filterByTitle("milk");
+    ASSERT_EQ(rows.size(), 2u);
+    EXPECT_EQ(snapshot.title(rows[0]), "Buy MILK");
+    EXPECT_EQ(snapshot.title(rows[1]), "Milkshake");
+
+    rows = snapshot.filterByTitle("Milk", TodoFilter::PENDING);
+    ASSERT_EQ(rows.size(), 1u);
+    EXPECT_EQ(snapshot.title(rows[0]), "Buy MILK");
+
+    EXPECT_EQ(snapshot.filterByTitle("").size(), 3u);
+    EXPECT_TRUE(snapshot.filterByTitle("cheese").empty());
+}
+
+TEST_F(TodoSnapshotTest, FilterCreatedBetween) {
+    createItem("Old", false, 100);
+    createItem("Middle", true, 200);
+    createItem("New", false, 300);
+
+    TodoSnapshot snapshot(*db_);
+
+    TodoSnapshot::Rows rows = snapshot.filterCreatedBetween(150, 300);
+    ASSERT_EQ(rows.size(), 1u);
+    EXPECT_EQ(snapshot.title(rows[0]), "Middle");
+
+    EXPECT_EQ(snapshot.filterCreatedBetween(0, 1000, TodoFilter::PENDING).size(), 2u);
+}
+
+TEST_F(TodoSnapshotTest, SortNewestFirstMatchesRepository) {
+    createItem("A", false, 200);
+    createItem("B", false, 100);
+    createItem("C", true, 200);
+    createItem("D", false, 300);
+
+    TodoSnapshot snapshot(*db_);
+    TodoSnapshot::Rows rows = snapshot.filter(TodoFilter::ALL);
+    snapshot.sortNewestFirst(rows);
+
+    std::vector<TodoItem> expected = repo_->findAll();
+    ASSERT_EQ(rows.size(), expected.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        EXPECT_EQ(snapshot.id(rows[i]), expected[i].getId());
+    }
+}
+
+TEST_F(TodoSnapshotTest, SortByTitle) {
+    createItem("Charlie", false, 1);
+    createItem("Alpha", false, 2);
+    createItem("Bravo", false, 3);
+
+    TodoSnapshot snapshot(*db_);
+    TodoSnapshot::Rows rows = snapshot.filter(TodoFilter::ALL);
+    snapshot.sortByTitle(rows);
+
+    ASSERT_EQ(rows.size(), 3u);
+    EXPECT_EQ(snapshot.title(rows[0]), "Alpha");
+    EXPECT_EQ(snapshot.title(rows[1]), "Bravo");
+    EXPECT_EQ(snapshot.title(rows[2]), "Charlie");
+}
+
+TEST_F(TodoSnapshotTest, UnaffectedByLaterWrites) {
+    int id = createItem("Task", false, 1);
+
+    TodoSnapshot snapshot(*db_);
+    repo_->markCompleted(id);
+    createItem("Another", false, 2);
+
+    EXPECT_EQ(snapshot.size(), 1u);
+    EXPECT_EQ(snapshot.count(TodoFilter::PENDING), 1u);
+}